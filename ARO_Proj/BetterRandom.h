@@ -5,34 +5,119 @@
 #ifndef BETTER_RANDOM_H_
 #define BETTER_RANDOM_H_
 
-#include <random>
-#include <mutex>
+#include <random>	// random_device for seeding when no run seed is given
+#include <cstdint>	// uint32_t & uint64_t state and outputs
+#include <cmath>	// log(), sqrt() & cos() for normal()
 
-// This class acts as a simpler interface to the much more random & capable random number generator -> random_device.
+// This class acts as a simple interface to a fast xoshiro128** random number generator
+//	The state is only 16 bytes held by value, so arrays of generators (one per thread) need no heap allocations beyond the array itself
+//	Generators can be seeded from a (seed, stream) pair so a run can be reproduced bit-exact from a single run seed
 struct BetterRandom {
-	std::random_device rd;
-	std::mt19937 *mt;
-	std::uniform_int_distribution<int> *dist;
+	uint32_t s[4];	// xoshiro128** state (never all zero)
+	int cap;		// values returned by operator() are in range [0, cap)
 
 	// Default use max
 	BetterRandom() : BetterRandom(RAND_MAX) {}
 
-	// Constructor with given cap (also used by default)
+	// Constructor with given cap (also used by default), seeded from random_device until seed() is called
 	BetterRandom(int cap) {
-		mt = new std::mt19937(rd());
-		dist = new std::uniform_int_distribution<int>(0, cap - 1);
+		this->cap = cap;
+		std::random_device rd;
+		this->seed((uint64_t(rd()) << 32) | rd(), 0);
 	}
 
-	~BetterRandom() {
-		delete mt;
-		delete dist;
+	// Constructor starting at a deterministic stream, see seed()
+	BetterRandom(uint64_t seedValue, uint64_t stream, int cap = RAND_MAX) {
+		this->cap = cap;
+		this->seed(seedValue, stream);
 	}
 
-	// () operator, use this to get a random number
-	const int operator()() {
-		int result = (*dist)(*mt);
+	// Step of the splitmix64 generator, used to expand seeds into well mixed state
+	// Input: x - splitmix state, is advanced
+	// Output: returns the next splitmix64 output
+	static uint64_t splitmix64(uint64_t & x) {
+		uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
+
+	// Combine a seed with an identifier into a new seed, used to derive seeds for sub streams (population, generation, thread)
+	// Input: seed - parent seed, id - identifier of the sub stream
+	// Output: returns a seed that is (practically) independent for every distinct (seed, id)
+	static uint64_t deriveSeed(uint64_t seed, uint64_t id) {
+		uint64_t x = seed ^ (id * 0xD1342543DE82EF95ull);
+		splitmix64(x);
+		return splitmix64(x);
+	}
+
+	// Reset the generator to the start of a deterministic stream
+	// Input: seed - the seed (such as the run seed), stream - which stream of that seed to use
+	// Output: state is set so the same (seed, stream) always gives the same sequence
+	void seed(uint64_t seed, uint64_t stream) {
+		uint64_t x = deriveSeed(seed, stream);
+		const uint64_t a = splitmix64(x);
+		const uint64_t b = splitmix64(x);
+		this->s[0] = uint32_t(a);
+		this->s[1] = uint32_t(a >> 32);
+		this->s[2] = uint32_t(b);
+		this->s[3] = uint32_t(b >> 32);
+		if ((this->s[0] | this->s[1] | this->s[2] | this->s[3]) == 0) {
+			this->s[0] = 1;
+		}
+	}
+
+	static inline uint32_t rotl(const uint32_t x, int k) {
+		return (x << k) | (x >> (32 - k));
+	}
+
+	// Get 32 raw random bits (not limited by cap), used where many random bits are needed at once such as crossover masks
+	inline uint32_t nextWord() {
+		const uint32_t result = rotl(this->s[1] * 5, 7) * 9;
+		const uint32_t t = this->s[1] << 9;
+		this->s[2] ^= this->s[0];
+		this->s[3] ^= this->s[1];
+		this->s[1] ^= this->s[2];
+		this->s[0] ^= this->s[3];
+		this->s[2] ^= t;
+		this->s[3] = rotl(this->s[3], 11);
 		return result;
 	}
+
+	// Fill an array with random words
+	// Input: out - array to fill, n - number of words to write
+	void fill(uint32_t * out, int n) {
+		// Work on a local copy of the state so it stays in registers through the loop
+		uint32_t s0 = this->s[0], s1 = this->s[1], s2 = this->s[2], s3 = this->s[3];
+		for (int i = 0; i < n; i++) {
+			out[i] = rotl(s1 * 5, 7) * 9;
+			const uint32_t t = s1 << 9;
+			s2 ^= s0;
+			s3 ^= s1;
+			s1 ^= s2;
+			s0 ^= s3;
+			s2 ^= t;
+			s3 = rotl(s3, 11);
+		}
+		this->s[0] = s0; this->s[1] = s1; this->s[2] = s2; this->s[3] = s3;
+	}
+
+	// Get a uniform double in [0, 1)
+	inline double uniform() {
+		return this->nextWord() * (1.0 / 4294967296.0);
+	}
+
+	// Get a standard normal double (mean 0, variance 1) by the Box-Muller transform
+	inline double normal() {
+		const double u = 1.0 - this->uniform(); // (0, 1], so log(u) is finite
+		return sqrt(-2.0 * log(u)) * cos(6.283185307179586 * this->uniform());
+	}
+
+	// () operator, use this to get a random number in [0, cap)
+	inline int operator()() {
+		// Multiply-shift maps the 32 bit word onto [0, cap) without a division
+		return int((uint64_t(this->nextWord()) * uint64_t(this->cap)) >> 32);
+	}
 };
 
 #endif
@@ -6,9 +6,11 @@
 #include "stdafx.h"						// Required in source
 #include "BruteForce_Optimization.h"	// Header file
 #include "Utility.h"					// Utility methods
+#include "Checkpoint.h"					// Checkpoint reading & writing
 
 #include <chrono>
 #include <string>
+#include <cstring> // memcpy() of resumed bin values
 
 bool BruteForce_Optimization::runOptimization() {
 	Utility::printLine("INFO: Starting" +this->algorithm_name_+ "Optimization!");
@@ -23,12 +25,27 @@ bool BruteForce_Optimization::runOptimization() {
 		return false;
 	}
 	this->timestamp = new TimeStampGenerator();
+	// Continue from the last checkpoint if asked to
+	int startBoard = 0;
+	if (this->resumeFromCheckpoint) {
+		if (this->loadCheckpoint()) {
+			startBoard = this->curBoardIndex_;
+		}
+		else {
+			Utility::printLine("WARNING: No usable checkpoint to resume from, starting from the first board");
+		}
+	}
 	// Optimize the selected boards by iterating through the vector that only holds boards to be optimized and access there IDs
-	for (int boardIndex = 0; boardIndex < this->optBoards.size() && this->dlg->stopFlag == false; boardIndex++) {
+	for (int boardIndex = startBoard; boardIndex < this->optBoards.size() && this->dlg->stopFlag == false; boardIndex++) {
+		this->curBoardIndex_ = boardIndex;
 		Utility::printLine("INFO: Currently optimizing board #" + std::to_string(this->optBoards[boardIndex]->board_id));
 		runIndividual(this->optBoards[boardIndex]->board_id);
 		Utility::printLine("INFO: Finished optimizing board #" + std::to_string(this->optBoards[boardIndex]->board_id));
 	}
+	// A finished run is not to be resumed, its checkpoint is only kept when stopped by the user
+	if (this->dlg->stopFlag == false) {
+		std::remove(this->checkpointPath().c_str());
+	}
 	// Cleanup
 	return shutdownOptimizationInstance();;
 }
@@ -46,11 +63,22 @@ bool BruteForce_Optimization::runIndividual(int boardID) {
 	int slmWidth = this->sc->getBoardWidth(boardID);
 	int slmHeight = this->sc->getBoardHeight(boardID);
 
-	// Initialize array for storing slm images
-	int * slmImg = new int[this->cc->numberOfBinsY * this->cc->numberOfBinsX * this->cc->populationDensity];
+	// Initialize array for storing slm images (one 8-bit phase per bin)
+	uint8_t * slmImg = new uint8_t[this->cc->numberOfBinsY * this->cc->numberOfBinsX * this->cc->populationDensity];
 	
 	//Initialize array of SLM image with 0s (note that the size of slmImg is dependent on the camera and not SLM!)
 	setBlankSlmImg(slmImg);
+	// Start each bin from the saved mask's phase if warm starting (brute force then only has to correct the drift)
+	this->loadWarmStart(boardID - 1, slmImg);
+	// When resuming, continue from the checkpointed bin values
+	int startBin = 0;
+	if (this->resumeImg_ != NULL) {
+		memcpy(slmImg, this->resumeImg_, this->cc->numberOfBinsY * this->cc->numberOfBinsX * this->cc->populationDensity);
+		delete[] this->resumeImg_;
+		this->resumeImg_ = NULL;
+		startBin = this->resumeBin_;
+		this->resumeBin_ = 0;
+	}
 
 	bool endOpt = false;
 	try {
@@ -58,6 +86,11 @@ bool BruteForce_Optimization::runIndividual(int boardID) {
 		for (int binCol = 0; binCol < this->cc->numberOfBinsX && !endOpt; binCol++) {
 			// Iterate through rows
 			for (int binRow = 0; binRow < this->cc->numberOfBinsY && !endOpt; binRow++) {
+				// Bins before the checkpoint are already optimized
+				const int binOrder = binCol*this->cc->numberOfBinsY + binRow;
+				if (binOrder < startBin) {
+					continue;
+				}
 				int binValMax = 0;
 				double fitValMax = 0;
 				// Current bin
@@ -73,17 +106,17 @@ bool BruteForce_Optimization::runIndividual(int boardID) {
 					ImageController * curImage;
 
 					// Assign at current bin the new value to test
-					slmImg[binIndex] = curBinVal;
+					slmImg[binIndex] = uint8_t(curBinVal);
 
-					// Scale and Write to board
-					this->scalers[boardID]->TranslateImage(slmImg, this->slmScaledImages[boardID]);
+					// Scale and Write to board (scalers are 0 based while boardID is 1 based)
+					this->scalers[boardID - 1]->TranslateImage(slmImg, this->slmScaledImages[boardID - 1]);
 
 					this->usingHardware = true;
 
-					this->sc->writeImageToBoard(boardID, this->slmScaledImages[boardID]);
+					this->sc->writeImageToBoard(boardID, this->slmScaledImages[boardID - 1]);
 
-					//Acquire camera image
-					curImage = this->cc->AcquireImage();
+					//Acquire camera image (exposed once the SLM has settled on the written image)
+					curImage = this->cc->AcquireImageAfter(this->sc->lastWriteTime);
 					this->usingHardware = false;
 
 					if (curImage == NULL)	{
@@ -96,12 +129,12 @@ bool BruteForce_Optimization::runIndividual(int boardID) {
 						this->camDisplay->UpdateDisplay(camImg);
 					}
 					if (this->displaySLMImage) {
-						this->slmDisplayVector[0]->UpdateDisplay(this->slmScaledImages[boardID]);
+						this->slmDisplayVector[0]->UpdateDisplay(this->slmScaledImages[boardID - 1]);
 					}
 					// Determine fitness
 
 					double exposureTimesRatio = this->cc->GetExposureRatio();
-					double fitness = Utility::FindAverageValue(camImg, curImage->getWidth(), curImage->getHeight(), this->cc->targetRadius);
+					double fitness = Utility::FindAverageValue(camImg, curImage->getWidth(), curImage->getHeight(), this->cc->GetFitnessRadius());
 
 					//Record current performance to file //Ask what kind of calcualtion is this?
 					double ms = boardID*this->phaseResolution + curBinVal / this->phaseResolution;
@@ -135,13 +168,17 @@ bool BruteForce_Optimization::runIndividual(int boardID) {
 					Utility::printLine("INFO: Current best fitness value updated to - " + std::to_string(allTimeBestFitness));
 				}
 
-				slmImg[binIndex] = binValMax;
+				slmImg[binIndex] = uint8_t(binValMax);
 
 				// Save progress data
 				if (this->logAllFiles) {
 					lmaxfile << binValMax << " " << fitValMax << std::endl;
 					rtime << this->timestamp->MS_SinceStart() << " ms  " << fitValMax << "   " << this->cc->finalExposureTime << std::endl;
 				}
+				// Checkpoint the optimized bins (not when stopped part way through this bin)
+				if (this->checkpointInterval > 0 && (binOrder + 1) % this->checkpointInterval == 0 && !endOpt) {
+					this->saveCheckpoint(binOrder + 1, slmImg);
+				}
 			} // ... binRow loop
 		} // ... binCol loop
 
@@ -255,22 +292,14 @@ bool BruteForce_Optimization::shutdownOptimizationInstance() {
 	if (this->timestamp != NULL) {
 		delete this->timestamp;
 	}
-	// Delete all the scalers in the vector
-	for (int i = 0; i < this->scalers.size(); i++) {
-		delete this->scalers[i];
-	}
-	this->scalers.clear();
-	// Delete all the scaled image pointers in the vector
-	for (int i = 0; i < this->slmScaledImages.size(); i++) {
-		delete[] this->slmScaledImages[i];
-	}
-	this->slmScaledImages.clear();
 
 	//Record the final (most fit) slm images followed by deleting them
 	for (int i = int(this->finalImages_.size())-1; i >= 0; i--) {
-		// Save image
+		// Save image, scaled from the bin values to the board's full size
 		if (this->logAllFiles || this->saveResultImages) {
-			cv::Mat m_ary = cv::Mat(512, 512, CV_8UC1, this->finalImages_[i]);
+			int boardIdx = this->optBoards[i]->board_id - 1;
+			this->scalers[boardIdx]->TranslateImage(this->finalImages_[i], this->slmScaledImages[boardIdx]);
+			cv::Mat m_ary = cv::Mat(this->sc->getBoardHeight(boardIdx), this->sc->getBoardWidth(boardIdx), CV_8UC1, this->slmScaledImages[boardIdx]);
 			cv::imwrite(this->outputFolder + curTime + "_OPT5_phaseopt_" + std::to_string(this->optBoards[i]->board_id)+".bmp", m_ary);
 		}
 		if (this->finalImages_[i] != NULL) {
@@ -279,6 +308,21 @@ bool BruteForce_Optimization::shutdownOptimizationInstance() {
 		this->finalImages_.pop_back();  // remove from vector
 	}
 	this->finalImages_.clear();
+	if (this->resumeImg_ != NULL) {
+		delete[] this->resumeImg_;
+		this->resumeImg_ = NULL;
+	}
+
+	// Delete all the scalers in the vector
+	for (int i = 0; i < this->scalers.size(); i++) {
+		delete this->scalers[i];
+	}
+	this->scalers.clear();
+	// Delete all the scaled image pointers in the vector
+	for (int i = 0; i < this->slmScaledImages.size(); i++) {
+		delete[] this->slmScaledImages[i];
+	}
+	this->slmScaledImages.clear();
 
 	//Reset UI State
 	this->isWorking = false;
@@ -286,7 +330,7 @@ bool BruteForce_Optimization::shutdownOptimizationInstance() {
 	return true;
 }
 
-void BruteForce_Optimization::setBlankSlmImg(int * slmImg) {
+void BruteForce_Optimization::setBlankSlmImg(uint8_t * slmImg) {
 	for (int y = 0; y < this->cc->numberOfBinsY; y++) {
 		for (int x = 0; x < this->cc->numberOfBinsX; x++) {
 			int index = (x + y*this->cc->numberOfBinsX)*this->cc->populationDensity;
@@ -294,3 +338,61 @@ void BruteForce_Optimization::setBlankSlmImg(int * slmImg) {
 		}
 	}
 }
+
+// Write a checkpoint of the run, the finished boards' images and the current board's partial image with the bin to continue from
+bool BruteForce_Optimization::saveCheckpoint(int nextBin, const uint8_t * slmImg) {
+	const int imageSize = this->cc->numberOfBinsY * this->cc->numberOfBinsX * this->cc->populationDensity;
+	CheckpointWriter out(this->algorithm_name_);
+	out.put(this->curBoardIndex_);
+	out.put(nextBin);
+	out.put(this->allTimeBestFitness);
+	out.put(this->cc->finalExposureTime);
+	out.put(imageSize);
+	out.put(int(this->finalImages_.size()));
+	for (int i = 0; i < this->finalImages_.size(); i++) {
+		out.putBytes(this->finalImages_[i], imageSize);
+	}
+	out.putBytes(slmImg, imageSize);
+	return out.commit(this->checkpointPath());
+}
+
+// Restore the run from its checkpoint, the camera's bins must be set up as in the checkpointed run
+bool BruteForce_Optimization::loadCheckpoint() {
+	CheckpointReader in;
+	if (!in.open(this->checkpointPath(), this->algorithm_name_)) {
+		return false;
+	}
+	const int expectedSize = this->cc->numberOfBinsY * this->cc->numberOfBinsX * this->cc->populationDensity;
+	int boardIndex = 0, nextBin = 0, imageSize = 0, finishedCount = 0;
+	double bestFitness = 0, exposure = 0;
+	if (!in.get(boardIndex) || !in.get(nextBin) || !in.get(bestFitness) || !in.get(exposure) || !in.get(imageSize) || !in.get(finishedCount)) {
+		return false;
+	}
+	if (imageSize != expectedSize || finishedCount != boardIndex || boardIndex < 0 || boardIndex >= this->optBoards.size()) {
+		Utility::printLine("ERROR: Checkpoint does not match the bins & boards of this run!");
+		return false;
+	}
+	// Read every image before keeping any of them
+	std::vector<uint8_t*> images;
+	bool success = true;
+	for (int i = 0; i <= finishedCount && success; i++) {
+		images.push_back(new uint8_t[imageSize]);
+		success = in.getBytes(images.back(), imageSize);
+	}
+	if (!success) {
+		for (int i = 0; i < images.size(); i++) {
+			delete[] images[i];
+		}
+		return false;
+	}
+	this->resumeImg_ = images.back();
+	images.pop_back();
+	this->finalImages_ = images;
+	this->curBoardIndex_ = boardIndex;
+	this->resumeBin_ = nextBin;
+	this->allTimeBestFitness = bestFitness;
+	this->cc->finalExposureTime = exposure;
+	this->cc->SetExposure(exposure);
+	Utility::printLine("INFO: Resuming from checkpoint at board #" + std::to_string(this->optBoards[boardIndex]->board_id) + " bin " + std::to_string(nextBin) + " (exposure " + std::to_string(exposure) + ")");
+	return true;
+}
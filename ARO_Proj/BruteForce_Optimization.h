@@ -6,6 +6,8 @@
 #ifndef BRUTE_FORCE_OPTIMIZATION_H_
 #define BRUTE_FORCE_OPTIMIZATION_H_
 
+#include <cstdint> // uint8_t bin phase values
+
 #include "Optimization.h"
 
 class BruteForce_Optimization : public Optimization {
@@ -14,9 +16,24 @@ class BruteForce_Optimization : public Optimization {
 	std::ofstream rtime;
 
 	// Once finished, contains the resulting optimized SLM images for all the boards used
-	std::vector<int*> finalImages_;
+	std::vector<uint8_t*> finalImages_;
 	// Record of best fitness overall during optimization
 	double allTimeBestFitness;
+
+	// Checkpoint state
+	int curBoardIndex_ = 0;			// Index into optBoards of the board being optimized
+	int resumeBin_ = 0;				// Bin (in optimization order) to continue the resumed board from
+	uint8_t * resumeImg_ = NULL;	// Partly optimized bin values of the resumed board (NULL if not resuming)
+
+	// Write a checkpoint of the run (finished boards' images, the current board's partial image & bin, exposure), see Checkpoint.h
+	// Input: nextBin - the bin (in optimization order) the current board would continue from, slmImg - the current board's bin values
+	// Output: returns false if the checkpoint could not be written
+	bool saveCheckpoint(int nextBin, const uint8_t * slmImg);
+
+	// Restore the run from its checkpoint, to be called after setupInstanceVariables()
+	// Output: returns false if there is no usable checkpoint (the run then starts from the beginning)
+	//		curBoardIndex_, resumeBin_ & resumeImg_ are set for the board to continue
+	bool loadCheckpoint();
 public:
 	// Constructor - inherits from base class
 	BruteForce_Optimization(MainDialog* dlg, CameraController* cc, SLMController* sc) : Optimization(dlg, cc, sc) {
@@ -36,7 +53,7 @@ public:
 	bool runIndividual(int boardID);
 
 	// Initialize slmImg with 0's
-	void setBlankSlmImg(int* slmImg);
+	void setBlankSlmImg(uint8_t* slmImg);
 };
 
 #endif
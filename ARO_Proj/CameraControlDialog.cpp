@@ -19,6 +19,13 @@ BOOL CameraControlDialog::OnInitDialog() {
 	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_EXPOSURE_TIME_INPUT),L"The intial exposure used, when intensity is too high the exposure will be halved each time during optimization");
 	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_FPS_INPUT),			L"The rate at which images are acquired, this is framerate is also attempted to be applied to the SLMs to match");
 	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_GMMA_VALUE_INPUT),	L"Gamma setting for the camera");
+	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_SETTLE_TIME_INPUT), L"Time after an SLM write finishes before an exposure may start for the frame to be used, covering the SLM settling (0 indicates the next frame)");
+	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_CALIBRATE_SETTLING_CHECK), L"Measure how long the SLM takes to settle before each run and use it in place of the settle time");
+	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_READOUT_BINNING), L"Pixels binned together in x and y on the camera when auto readout is on (1 indicates no binning)");
+	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_AUTO_READOUT_CHECK), L"Shrink the camera readout to the target area when configuring the camera, so frames read out faster");
+	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_VIEW_READOUTS), L"Readouts the PICam acquisition buffer holds when free running, more give image views longer before the camera comes round to them (at least 3)");
+	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_STREAM_BUFFER_COUNT), L"Number of Spinnaker stream buffers when free running, an image view holds one until it is released (0 indicates the driver picks the count)");
+	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_STREAM_BUFFER_HANDLING), L"Order Spinnaker hands over stream buffers when free running (NewestOnly gives the latest image after each SLM write)");
 	this->m_mainToolTips->Activate(true);
 
 	return CDialogEx::OnInitDialog();
@@ -33,6 +40,13 @@ void CameraControlDialog::DoDataExchange(CDataExchange* pDX) {
 	DDX_Control(pDX, IDC_EXPOSURE_TIME_INPUT, m_initialExposureTimeInput);
 	DDX_Control(pDX, IDC_FPS_INPUT, m_FramesPerSecond);
 	DDX_Control(pDX, IDC_GMMA_VALUE_INPUT, m_gammaValue);
+	DDX_Control(pDX, IDC_SETTLE_TIME_INPUT, m_settleTime);
+	DDX_Control(pDX, IDC_CALIBRATE_SETTLING_CHECK, m_calibrateSettling);
+	DDX_Control(pDX, IDC_READOUT_BINNING, m_readoutBinning);
+	DDX_Control(pDX, IDC_AUTO_READOUT_CHECK, m_autoReadout);
+	DDX_Control(pDX, IDC_VIEW_READOUTS, m_viewReadouts);
+	DDX_Control(pDX, IDC_STREAM_BUFFER_COUNT, m_streamBufferCount);
+	DDX_Control(pDX, IDC_STREAM_BUFFER_HANDLING, m_streamBufferHandling);
 }
 
 BEGIN_MESSAGE_MAP(CameraControlDialog, CDialogEx)
@@ -50,4 +64,16 @@ void CameraControlDialog::setDefaultUI() {
 	this->m_initialExposureTimeInput.SetWindowTextW(_T("2000"));
 	this->m_FramesPerSecond.SetWindowTextW(_T("200"));
 	this->m_gammaValue.SetWindowTextW(_T("1.00"));
+	this->m_settleTime.SetWindowTextW(_T("0"));
+	this->m_calibrateSettling.SetCheck(BST_UNCHECKED);
+	this->m_readoutBinning.SetWindowTextW(_T("1"));
+	this->m_autoReadout.SetCheck(BST_UNCHECKED);
+	this->m_viewReadouts.SetWindowTextW(_T("8"));
+	this->m_streamBufferCount.SetWindowTextW(_T("0")); // 0 indicates the driver picks the count
+	this->m_streamBufferHandling.ResetContent();
+	this->m_streamBufferHandling.AddString(_T("NewestOnly"));
+	this->m_streamBufferHandling.AddString(_T("NewestFirst"));
+	this->m_streamBufferHandling.AddString(_T("OldestFirst"));
+	this->m_streamBufferHandling.AddString(_T("OldestFirstOverwrite"));
+	this->m_streamBufferHandling.SetCurSel(0);
 }
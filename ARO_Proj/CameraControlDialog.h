@@ -37,4 +37,18 @@ public:
 	CEdit m_initialExposureTimeInput;
 	CEdit m_FramesPerSecond;
 	CEdit m_gammaValue;
+	// Time in microseconds after an SLM write before a frame is used
+	CEdit m_settleTime;
+	// If toggled, the SLM settle time is measured before each run
+	CButton m_calibrateSettling;
+	// Pixels binned together in x & y with auto readout
+	CEdit m_readoutBinning;
+	// If toggled, the camera reads out only the area around the target
+	CButton m_autoReadout;
+	// Readouts the acquisition buffer holds when free running (PICam)
+	CEdit m_viewReadouts;
+	// Number of stream buffers when free running (Spinnaker)
+	CEdit m_streamBufferCount;
+	// Stream buffer handling mode when free running (Spinnaker)
+	CComboBox m_streamBufferHandling;
 };
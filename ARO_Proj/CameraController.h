@@ -8,23 +8,30 @@
 class CameraController;
 class ImageController;
 
-// Define which version to build with (Spinnaker or PICam?) cannot be both
+// Define which version to build with (Spinnaker, PICam or the simulated camera?) cannot be more than one
+// (the simulated camera is triggered by the simulated SLM boards, so also needs USE_MOCK_SLM in SLMController.h)
 #define USE_PICAM
 //#define USE_SPINNAKER
+//#define USE_MOCK_CAMERA
 
 // Spinnaker version
 #ifdef USE_SPINNAKER
 	#include "CameraControllerSpinnaker.h"
 	#include "ImageControllerSpinnaker.h"
-	#ifdef USE_PICAM// Performing additional check to see if other version is also being includes (which would be bad!)
-		#error "Cannot have Spinnaker and PICam versions in same build!"
+	#if defined(USE_PICAM) || defined(USE_MOCK_CAMERA) // Performing additional check to see if other version is also being includes (which would be bad!)
+		#error "Cannot have more than one camera version in same build!"
 	#endif
 #endif
 // PICam version
 #ifdef USE_PICAM
 	#include "CameraControllerPICam.h"
 	#include "ImageControllerPICam.h"
-	#ifdef USE_SPINNAKER // Performing additional check to see if other version is also being includes (which would be bad!)
-		#error "Cannot have Spinnaker and PICam versions in same build!"
+	#if defined(USE_SPINNAKER) || defined(USE_MOCK_CAMERA) // Performing additional check to see if other version is also being includes (which would be bad!)
+		#error "Cannot have more than one camera version in same build!"
 	#endif
 #endif
+// Simulated camera version
+#ifdef USE_MOCK_CAMERA
+	#include "CameraControllerMock.h"
+	#include "ImageControllerMock.h"
+#endif
@@ -0,0 +1,481 @@
+////////////////////
+// CameraControllerMock.cpp - implementation of CameraController for the simulated camera (see CameraControllerMock.h)
+////////////////////
+
+#include "stdafx.h"				// Required in source
+#include "CameraController.h"	// Header file (also will define which camera is used)
+
+#ifdef USE_MOCK_CAMERA // Only include this implementation content if using the simulated camera
+
+#include "MainDialog.h"
+#include "Utility.h"
+#include "Timing.h"		// Host time of exposures
+#include <chrono>		// Exposure time & frame waits
+
+CameraController::CameraController(MainDialog* dlg_) {
+	this->dlg = dlg_;
+	this->slm_ = NULL;
+	this->externalTrigger_ = false;
+	this->bufferedFrames_ = 2;
+	this->running_ = false;
+	this->lastFrameTime_ = 0;
+	this->lostFrames_ = 0;
+	this->loseSkip_ = 0;
+	this->loseCount_ = 0;
+}
+
+CameraController::~CameraController() {
+	this->shutdownCamera();
+}
+
+// Call all configuration and setups to make sure it is ready before starting
+bool CameraController::setupCamera() {
+	// Quit if don't have a reference to UI (latest parameters) or the boards to see
+	if (!dlg || !UpdateConnectedCameraInfo()) {
+		return false;
+	}
+	if (!UpdateImageParameters() || !ConfigureCustomImageSettings() || !ConfigureExposureTime()) {
+		return false;
+	}
+	Utility::printLine("INFO: Simulated camera has been setup!");
+	return true;
+}
+
+// Start acquisition, when triggered the camera listens for the SLM's output pulse
+bool CameraController::startCamera() {
+	if (this->slm_ == NULL && !this->UpdateConnectedCameraInfo()) {
+		return false;
+	}
+	this->stopCamera();
+	std::unique_lock<std::mutex> lock(this->mutex_);
+	this->running_ = true;
+	if (this->externalTrigger_) {
+		this->exposer_ = std::thread(&CameraController::exposeFrames, this);
+		lock.unlock();
+		this->slm_->setPulseListener([this](int board, const unsigned char * image) { this->onPulse(board, image); });
+	}
+	return true;
+}
+
+// Stop acquisition, frames not acquired are dropped
+bool CameraController::stopCamera() {
+	if (this->slm_ != NULL) {
+		this->slm_->setPulseListener(NULL);
+	}
+	std::unique_lock<std::mutex> lock(this->mutex_);
+	this->running_ = false;
+	this->listen_.notify_all();
+	lock.unlock();
+	if (this->exposer_.joinable()) {
+		this->exposer_.join();
+	}
+	lock.lock();
+	this->exposures_.clear();
+	for (int i = 0; i < this->frames_.size(); i++) {
+		delete this->frames_[i];
+	}
+	this->frames_.clear();
+	return true;
+}
+
+bool CameraController::shutdownCamera() {
+	this->stopCamera();
+	this->slm_ = NULL;
+	return true;
+}
+
+// Pulse listener (on the SLM writer's thread)
+void CameraController::onPulse(int board, const unsigned char * image) {
+	std::unique_lock<std::mutex> lock(this->mutex_);
+	if (!this->running_ || !this->externalTrigger_) {
+		return;
+	}
+	if (this->loseSkip_ > 0) {
+		this->loseSkip_--;
+	}
+	else if (this->loseCount_ > 0) {
+		this->loseCount_--;
+		this->lostFrames_++;
+		return;
+	}
+	const int size = this->slm_->Get_image_width(board) * this->slm_->Get_image_height(board);
+	this->exposures_.push_back(std::vector<unsigned char>(image, image + size));
+	this->listen_.notify_all();
+}
+
+// Exposure thread
+void CameraController::exposeFrames() {
+	std::unique_lock<std::mutex> lock(this->mutex_);
+	while (true) {
+		this->listen_.wait(lock, [this] { return !this->running_ || !this->exposures_.empty(); });
+		if (!this->running_) {
+			return;
+		}
+		std::vector<unsigned char> shown;
+		shown.swap(this->exposures_.front());
+		this->exposures_.pop_front();
+		const double exposureTime = this->finalExposureTime;
+		lock.unlock();
+
+		std::this_thread::sleep_for(std::chrono::microseconds((long long)(exposureTime)));
+		ImageController * frame = this->SimulateFrame(shown.data(), MockSLM::BOARD_SIZE, MockSLM::BOARD_SIZE);
+
+		lock.lock();
+		if (!this->running_) {
+			delete frame;
+			return;
+		}
+		if (int(this->frames_.size()) < this->bufferedFrames_) {
+			this->frames_.push_back(frame);
+			this->listen_.notify_all();
+		}
+		else {
+			delete frame;
+			this->lostFrames_++;
+		}
+		lock.unlock();
+		// End of exposure raises the SLM's trigger input
+		this->slm_->trigger();
+		lock.lock();
+	}
+}
+
+// Frame of the image the first board is showing
+ImageController* CameraController::exposeShownImage() {
+	std::vector<unsigned char> shown;
+	if (this->slm_ == NULL || !this->slm_->copyShownImage(1, shown)) {
+		shown.assign(MockSLM::BOARD_SIZE * MockSLM::BOARD_SIZE, 0);
+	}
+	std::this_thread::sleep_for(std::chrono::microseconds((long long)(this->finalExposureTime)));
+	this->lastFrameTime_ = TimeStampGenerator::HostMicroS();
+	return this->SimulateFrame(shown.data(), MockSLM::BOARD_SIZE, MockSLM::BOARD_SIZE);
+}
+
+// Get most recent image
+ImageController* CameraController::AcquireImage() {
+	return this->exposeShownImage();
+}
+
+// Get a frame exposed at least settleTime after the SLM write
+ImageController* CameraController::AcquireImageAfter(double writeTime) {
+	const double wait = writeTime + this->settleTime - TimeStampGenerator::HostMicroS();
+	if (wait > 0) {
+		std::this_thread::sleep_for(std::chrono::microseconds((long long)(wait)));
+	}
+	return this->exposeShownImage();
+}
+
+ImageController* CameraController::AcquireImageView(double writeTime) {
+	return this->AcquireImageAfter(writeTime);
+}
+
+void CameraController::ReleaseImage(ImageController * image) {
+	delete image;
+}
+
+ImageController* CameraController::KeepImage(ImageController * image) {
+	return image;
+}
+
+long long CameraController::TakeRejectedFrames() {
+	return 0;
+}
+
+long long CameraController::TakeDroppedFrames() {
+	std::unique_lock<std::mutex> lock(this->mutex_);
+	const long long lost = this->lostFrames_;
+	this->lostFrames_ = 0;
+	return lost;
+}
+
+long long CameraController::TakeBufferOverruns() {
+	return 0;
+}
+
+double CameraController::GetLastFrameTime() {
+	return this->lastFrameTime_;
+}
+
+// Acquire the next triggered frames in the order they were exposed
+int CameraController::AcquireSequence(int count, ImageController ** images, int timeoutMs) {
+	std::unique_lock<std::mutex> lock(this->mutex_);
+	auto hasFrame = [this] { return !this->running_ || !this->frames_.empty(); };
+	int acquired = 0;
+	while (acquired < count) {
+		if (timeoutMs > 0) {
+			this->listen_.wait_for(lock, std::chrono::milliseconds(timeoutMs), hasFrame);
+		}
+		else {
+			this->listen_.wait(lock, hasFrame);
+		}
+		if (this->frames_.empty()) {
+			if (this->running_) {
+				Utility::printLine("WARNING: Timed out waiting for frame " + std::to_string(acquired + 1) + " of " + std::to_string(count) + " in sequence!");
+			}
+			break;
+		}
+		images[acquired] = this->frames_.front();
+		this->frames_.pop_front();
+		acquired++;
+	}
+	this->lastFrameTime_ = TimeStampGenerator::HostMicroS();
+	return acquired;
+}
+
+// Set the camera to expose on the SLM's output pulse
+bool CameraController::SetExternalTrigger(bool enable, int bufferedFrames) {
+	std::unique_lock<std::mutex> lock(this->mutex_);
+	if (this->running_) {
+		Utility::printLine("ERROR: Camera trigger can only be changed while acquisition is stopped!");
+		return false;
+	}
+	this->externalTrigger_ = enable;
+	this->bufferedFrames_ = (bufferedFrames > 1) ? bufferedFrames : 1;
+	return true;
+}
+
+int CameraController::PrintDeviceInfo() {
+	Utility::printLine("INFO: Simulated camera, " + std::to_string(this->sensorWidth) + "x" + std::to_string(this->sensorHeight) + " sensor");
+	return 0;
+}
+
+bool CameraController::UpdateImageParameters() {
+	bool result = true;
+	// Frames per second
+	try	{
+		CString path("");
+		dlg->m_cameraControlDlg.m_FramesPerSecond.GetWindowTextW(path);
+		if (path.IsEmpty()) throw new std::exception();
+		fps = _tstoi(path);
+	}
+	catch (...)	{
+		Utility::printLine("ERROR: Was unable to parse the frames per second time input field!");
+		result = false;
+	}
+	// Gamma value
+	try	{
+		CString path("");
+		dlg->m_cameraControlDlg.m_gammaValue.GetWindowTextW(path);
+		if (path.IsEmpty()) throw new std::exception();
+		gamma = _tstof(path);
+	}
+	catch (...)	{
+		Utility::printLine("ERROR: Was unable to parse the gamma input field!");
+		result = false;
+	}
+	// Initial exposure time
+	try	{
+		CString path("");
+		dlg->m_cameraControlDlg.m_initialExposureTimeInput.GetWindowTextW(path);
+		if (path.IsEmpty()) throw new std::exception();
+		initialExposureTime = _tstof(path);
+	}
+	catch (...)	{
+		Utility::printLine("ERROR: Was unable to parse the initial exposure time input field!");
+		result = false;
+	}
+	// Settle time after an SLM write
+	try	{
+		CString path("");
+		dlg->m_cameraControlDlg.m_settleTime.GetWindowTextW(path);
+		if (path.IsEmpty()) throw new std::exception();
+		settleTime = _tstof(path);
+	}
+	catch (...)	{
+		Utility::printLine("ERROR: Was unable to parse the settle time input field!");
+		result = false;
+	}
+	// Auto readout settings
+	try	{
+		CString path("");
+		dlg->m_cameraControlDlg.m_readoutBinning.GetWindowTextW(path);
+		if (path.IsEmpty()) throw new std::exception();
+		readoutBinning = _tstoi(path);
+		autoReadout = (dlg->m_cameraControlDlg.m_autoReadout.GetCheck() == BST_CHECKED);
+	}
+	catch (...)	{
+		Utility::printLine("ERROR: Was unable to parse the readout binning input field!");
+		result = false;
+	}
+	// Get all AOI settings
+	try	{
+		CString path("");
+		// Left offset
+		dlg->m_aoiControlDlg.m_leftInput.GetWindowTextW(path);
+		if (path.IsEmpty()) throw new std::exception();
+		x0 = _tstoi(path);
+		path = L"";
+		// Top Offset
+		dlg->m_aoiControlDlg.m_rightInput.GetWindowTextW(path);
+		if (path.IsEmpty()) throw new std::exception();
+		y0 = _tstoi(path);
+		path = L"";
+		// Width of AOI
+		dlg->m_aoiControlDlg.m_widthInput.GetWindowTextW(path);
+		if (path.IsEmpty()) throw new std::exception();
+		cameraImageWidth = _tstoi(path);
+		path = L"";
+		// Hieght of AOI
+		dlg->m_aoiControlDlg.m_heightInput.GetWindowTextW(path);
+		if (path.IsEmpty()) throw new std::exception();
+		cameraImageHeight = _tstoi(path);
+	}
+	catch (...)	{
+		Utility::printLine("ERROR: Was unable to parse AOI settings!");
+		result = false;
+	}
+	// Number of image bins X and Y (ASK: if actually need to be thesame)
+	try	{
+		CString path("");
+		if (this->dlg->opt_selection_ == MainDialog::OptType::IA) {
+			dlg->m_ia_ControlDlg.m_numBins.GetWindowTextW(path);
+		}
+		else {
+			dlg->m_ga_ControlDlg.m_numberBins.GetWindowTextW(path);
+		}
+		if (path.IsEmpty()) throw new std::exception();
+		numberOfBinsX = _tstoi(path);
+		numberOfBinsY = numberOfBinsX; // Number of bins in Y direction is equal to in X direction (square)
+	}
+	catch (...)	{
+		Utility::printLine("ERROR: Was unable to parse the number of bins input field!");
+		result = false;
+	}
+	//Size of bins X and Y (ASK: if actually thesame xy? and isn't stating the # of bins already determine size?)
+	try	{
+		CString path("");
+		if (this->dlg->opt_selection_ == MainDialog::OptType::IA) {
+			dlg->m_ia_ControlDlg.m_binSize.GetWindowTextW(path);
+		}
+		else {
+			dlg->m_ga_ControlDlg.m_binSize.GetWindowTextW(path);
+		}
+		if (path.IsEmpty()) throw new std::exception();
+		binSizeX = _tstoi(path);
+		binSizeY = binSizeX; // Square shape in size
+	}
+	catch (...)	{
+		Utility::printLine("ERROR: Was unable to parse bin size input feild!");
+		result = false;
+	}
+	// Integration/target radius
+	try	{
+		CString path("");
+		if (this->dlg->opt_selection_ == MainDialog::OptType::IA) {
+			dlg->m_ia_ControlDlg.m_targetRadius.GetWindowTextW(path);
+		}
+		else {
+			dlg->m_ga_ControlDlg.m_targetRadius.GetWindowTextW(path);
+		}
+		if (path.IsEmpty()) throw new std::exception();
+		targetRadius = _tstoi(path);
+	}
+	catch (...)	{
+		Utility::printLine("ERROR: Was unable to parse integration radius input feild!");
+		result = false;
+	}
+
+	return result;
+}
+
+// Connect to the simulated boards the camera sees
+bool CameraController::UpdateConnectedCameraInfo() {
+	if (this->dlg == NULL || this->dlg->slmCtrl == NULL || this->dlg->slmCtrl->blink_sdk == NULL) {
+		Utility::printLine("ERROR: Simulated camera has no simulated SLM to see!");
+		return false;
+	}
+	this->slm_ = this->dlg->slmCtrl->blink_sdk;
+	return true;
+}
+
+// The simulated readout is the AOI, only checked to fit on the sensor
+bool CameraController::ConfigureCustomImageSettings() {
+	if (this->cameraImageWidth <= 0 || this->cameraImageHeight <= 0 || this->x0 < 0 || this->y0 < 0
+		|| this->x0 + this->cameraImageWidth > this->sensorWidth || this->y0 + this->cameraImageHeight > this->sensorHeight) {
+		Utility::printLine("ERROR: AOI does not fit on the simulated sensor!");
+		return false;
+	}
+	return true;
+}
+
+// Reset the exposure time back to initial
+bool CameraController::ConfigureExposureTime() {
+	finalExposureTime = initialExposureTime;
+	return SetExposure(finalExposureTime);
+}
+
+// Method of saving an image to a given file path
+bool CameraController::saveImage(ImageController * curImage, std::string path) {
+	if (curImage == NULL) {
+		Utility::printLine("ERROR: Attempted to save image with null pointer!");
+		return false;
+	}
+	curImage->saveImage(path);
+	return true;
+}
+
+// [ACCESSOR(S)/MUTATOR(S)]
+bool CameraController::GetCenter(int &x, int &y) {
+	x = this->sensorWidth / 2;
+	y = this->sensorHeight / 2;
+	return true;
+}
+
+bool CameraController::GetFullImage(int &x, int &y) {
+	x = this->sensorWidth;
+	y = this->sensorHeight;
+	return true;
+}
+
+bool CameraController::hasCameras() {
+	return true;
+}
+
+int CameraController::GetFitnessRadius() {
+	return this->targetRadius;
+}
+
+bool CameraController::SetExposure(double exposureTimeToSet) {
+	if (exposureTimeToSet <= 0) {
+		Utility::printLine("ERROR: Failed to set exposure parameter!");
+		return false;
+	}
+	std::unique_lock<std::mutex> lock(this->mutex_);
+	this->finalExposureTime = exposureTimeToSet;
+	return true;
+}
+
+// Get the multiplier for exposure having been halved
+double CameraController::GetExposureRatio() {
+	return initialExposureTime / finalExposureTime;
+}
+
+// half the current exposure time setting
+void CameraController::HalfExposureTime() {
+	if (!SetExposure(finalExposureTime / 2)) {
+		Utility::printLine("ERROR: wasn't able to half the exposure time!");
+	}
+}
+
+// [SIMULATION]
+ImageController* CameraController::SimulateFrame(const unsigned char * slmImage, int slmWidth, int slmHeight) {
+	ImageController * frame = new ImageController(this->cameraImageWidth, this->cameraImageHeight);
+	unsigned char * data = frame->getRawData();
+	const double brightness = this->finalExposureTime / this->initialExposureTime;
+	for (int y = 0; y < this->cameraImageHeight; y++) {
+		const int slmY = y * slmHeight / this->cameraImageHeight;
+		for (int x = 0; x < this->cameraImageWidth; x++) {
+			const double value = slmImage[slmY * slmWidth + x * slmWidth / this->cameraImageWidth] * brightness;
+			data[y * this->cameraImageWidth + x] = unsigned char((value < 255) ? value : 255);
+		}
+	}
+	return frame;
+}
+
+void CameraController::LoseFrames(int skip, int count) {
+	std::unique_lock<std::mutex> lock(this->mutex_);
+	this->loseSkip_ = (skip > 0) ? skip : 0;
+	this->loseCount_ = (count > 0) ? count : 0;
+}
+
+#endif
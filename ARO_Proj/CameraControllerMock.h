@@ -0,0 +1,151 @@
+////////////////////
+// CameraControllerMock.h - Header file for the camera controller to the simulated camera
+//		Built in place of PICam/Spinnaker when USE_MOCK_CAMERA is defined (see CameraController.h), together with the simulated SLM boards (USE_MOCK_SLM)
+//		so that hardware sequences can be run & tested without hardware. Each frame is the image the last board shows, sampled down to the AOI
+//		When triggered, the camera exposes on the SLM's output pulse and raises the SLM's trigger input once the exposure ends
+//		(as the camera's trigger output does in the hardware setup), frames can be lost on purpose with LoseFrames()
+////////////////////
+
+#ifndef CAMERA_CONTROLLER_MOCK_H_
+#define CAMERA_CONTROLLER_MOCK_H_
+
+#ifdef USE_MOCK_CAMERA
+
+#include <string>
+#include <vector>
+#include <deque>				// Exposures & frames in the order they were triggered
+#include <thread>				// Exposure thread
+#include <mutex>				// Pulses arrive on the SLM writer's thread
+#include <condition_variable>	// Waiting for exposures & frames
+
+#include "SLMController.h"			// Simulated boards (MockSLM)
+#include "ImageControllerMock.h"	// Image wrapper
+
+#ifndef USE_MOCK_SLM
+	#error "The simulated camera is triggered by the simulated SLM boards, define USE_MOCK_SLM in SLMController.h!"
+#endif
+
+class MainDialog;
+
+class CameraController {
+public:
+	//Image parameters (with defaults set)
+	// ROI offset
+	int x0 = 896;
+	int y0 = 568;
+	// ROI dimension
+	int cameraImageWidth = 64;
+	int cameraImageHeight = 64;
+	int populationDensity = 1;
+
+	double gamma = 1.25;
+	int fps = 200;
+	// initial exposure time in microseconds that is set by GUI (us)
+	double initialExposureTime = 2000;
+	// currnet exposure time in microseconds (us)
+	double finalExposureTime = 2000;
+
+	int numberOfBinsX = 128;
+	int numberOfBinsY = 128;
+	int binSizeX = 4;
+	int binSizeY = 4;
+
+	//Image target settings
+	int targetRadius = 5;
+
+	// Time (microseconds) after an SLM write finishes before a frame may be used by AcquireImageAfter()
+	double settleTime = 0;
+
+	// Auto readout settings, kept for the settings shared with the other cameras (the simulated readout is always the AOI)
+	bool autoReadout = false;
+	int autoReadoutMargin = 2;
+	int readoutBinning = 1;
+
+	// Size of the simulated sensor in pixels
+	int sensorWidth = 2048;
+	int sensorHeight = 2048;
+private:
+	MainDialog* dlg; // Pointer to GUI instance to access parameters with
+	MockSLM* slm_;	 // Simulated boards the camera sees & is triggered by (the SLM controller's driver)
+
+	bool externalTrigger_;		// TRUE -> expose on the SLM's output pulse (see SetExternalTrigger())
+	int bufferedFrames_;		// Frames held before further exposures are lost when triggered
+	bool running_;				// TRUE while acquisition is started
+	double lastFrameTime_;		// Host time (microseconds) the last acquired image was exposed
+	long long lostFrames_;		// Frames lost since the last TakeDroppedFrames()
+	int loseSkip_;				// Triggered frames to expose before losing any (see LoseFrames())
+	int loseCount_;				// Triggered frames still to lose
+
+	std::deque<std::vector<unsigned char>> exposures_;	// Images shown at pulses, waiting for their exposure to end
+	std::deque<ImageController*> frames_;				// Exposed frames waiting to be acquired
+	std::thread exposer_;								// Runs exposeFrames() while triggered acquisition is started
+	std::mutex mutex_;									// Guards the queues & state shared with the pulse listener
+	std::condition_variable listen_;					// Signalled when an exposure or frame is queued or acquisition stops
+
+	// Pulse listener, queues an exposure of the shown image (or loses it)
+	void onPulse(int board, const unsigned char * image);
+	// Exposure thread, turns each queued exposure into a frame after the exposure time and then raises the SLM's trigger input
+	void exposeFrames();
+	// Frame of the image the first board is showing (free running exposures)
+	ImageController* exposeShownImage();
+public:
+	CameraController(MainDialog* dlg_);
+	~CameraController();
+
+	bool setupCamera();
+	bool startCamera();
+	bool saveImage(ImageController * curImage, std::string path);
+	ImageController* AcquireImage();
+	// Acquire a frame exposed at least settleTime after the given host time (see CameraControllerPICam.h)
+	ImageController* AcquireImageAfter(double writeTime);
+	// Same as AcquireImageAfter(), simulated images are never views
+	ImageController* AcquireImageView(double writeTime);
+	// Give back an image when done with it (it is deleted)
+	void ReleaseImage(ImageController * image);
+	// Get an image that can be held on to (the image itself)
+	ImageController* KeepImage(ImageController * image);
+	long long TakeRejectedFrames();
+	// Get the number of frames lost since the last call (lost on purpose or for the buffer being full), then start counting again
+	long long TakeDroppedFrames();
+	long long TakeBufferOverruns();
+	double GetLastFrameTime();
+	// Acquire the next triggered frames in the order they were exposed
+	// Input: count - number of frames to get, images - array of count to fill, timeoutMs - longest wait for each frame (0 or less waits while acquisition runs)
+	// Output: returns the number of frames acquired, images[0 .. returned-1] hold new images (caller is responsible for deleting them)
+	int AcquireSequence(int count, ImageController ** images, int timeoutMs);
+	// Set the camera to expose on the SLM's output pulse rather than freely, takes effect from the next startCamera()
+	bool SetExternalTrigger(bool enable, int bufferedFrames = 2);
+	bool stopCamera();
+	bool shutdownCamera();
+
+	// [SETUP]
+	bool UpdateImageParameters();
+	bool UpdateConnectedCameraInfo();
+	bool ConfigureCustomImageSettings();
+	bool ConfigureExposureTime();
+
+	// [UTILITY]
+	int PrintDeviceInfo();
+
+	// [ACCESSOR(S)/MUTATOR(S)]
+	bool GetCenter(int &x, int &y);
+	bool GetFullImage(int &x, int &y);
+	bool hasCameras();
+	int GetFitnessRadius();
+	bool SetExposure(double exposureTimeToSet);
+	double GetExposureRatio();
+	void HalfExposureTime();
+
+	// [SIMULATION]
+	// Make the frame the camera exposes of an SLM image, the image sampled down to the AOI with brightness in proportion to the exposure time
+	// Input: slmImage - image shown on the board, slmWidth, slmHeight - size of the board in pixels
+	// Output: returns the frame (caller is responsible for deleting it)
+	ImageController* SimulateFrame(const unsigned char * slmImage, int slmWidth, int slmHeight);
+	// Lose triggered frames (no frame is made and no trigger raised, as when the camera misses a pulse)
+	// Input: skip - triggered frames to expose normally first, count - number of frames after those to lose
+	void LoseFrames(int skip, int count);
+};
+
+#endif
+
+#endif
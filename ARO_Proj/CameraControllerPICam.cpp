@@ -10,11 +10,32 @@
 
 #include "MainDialog.h"
 #include "Utility.h"
+#include "Timing.h"		// Host time of acquisition start for frame time stamps
+#include <cstring>		// memcpy() of time stamp metadata
+#include <thread>		// yield() & sleep_for() while waiting on the acquisition callback
 
 CameraController::CameraController(MainDialog* dlg_) {
 	this->dlg = dlg_;
 	this->libraryInitialized = false;
 	this->buffer_.memory = NULL;
+	this->bufferReadouts_ = this->viewReadouts;
+	this->frameTimeStamps_ = false;
+	this->timeStampResolution_ = 1;
+	this->timeStampBytes_ = 8;
+	this->acquisitionStartHost_ = 0;
+	this->rejectedFrames_ = 0;
+	this->lastFrameTime_ = 0;
+	this->appliedBinning_ = 1;
+	this->frameSize_ = 0;
+	this->readoutStride_ = 0;
+	this->numPixels_ = 0;
+	this->framePeriod_ = 0;
+	this->readoutsPublished_ = 0;
+	this->acquisitionRunning_ = false;
+	this->acquisitionFailed_ = false;
+	this->droppedFrames_ = 0;
+	this->bufferOverruns_ = 0;
+	this->overrunReported_ = false;
 
 	this->UpdateConnectedCameraInfo();
 }
@@ -52,10 +73,6 @@ bool CameraController::setupCamera() {
 bool CameraController::startCamera() {
 	// Begin acquisition management when camera has been configured and is now ready to being acquiring images.
 
-	// Get the size that a readout would be
-	piint readout_size = 0;
-	Picam_GetParameterIntegerValue(this->camera_, PicamParameter_ReadoutStride, &readout_size);
-	
 	// Commiting buffer parameter
 	const PicamParameter* failed_parameters;
 	piint failed_parameters_count;
@@ -69,12 +86,27 @@ bool CameraController::startCamera() {
 	// - free picam-allocated resources for parameters
 	Picam_DestroyParameters(failed_parameters);
 
+	// Frame geometry as committed, fixed for the acquisition session
+	this->frameSize_ = getIntParameterValue(PicamParameter_FrameSize);
+	this->readoutStride_ = getIntParameterValue(PicamParameter_ReadoutStride);
+	this->numPixels_ = int(this->frameSize_) / 2; // Number of pixels is half the size in bytes (2-byte depth for each pixel)
+	const piflt frameRate = getFloatParameterValue(PicamParameter_FrameRateCalculation);
+	this->framePeriod_ = 1000000.0 / ((frameRate > 0) ? frameRate : piflt(this->fps));
+
+	// Time stamp resolution & size as committed
+	if (this->frameTimeStamps_) {
+		pi64s resolution = 0;
+		Picam_GetParameterLargeIntegerValue(this->camera_, PicamParameter_TimeStampResolution, &resolution);
+		this->timeStampResolution_ = (resolution > 0) ? double(resolution) : 1;
+		this->timeStampBytes_ = int(getIntParameterValue(PicamParameter_TimeStampBitDepth)) / 8;
+	}
+
 	// Setting up the buffer, making the available memory size sufficient
 	if (this->buffer_.memory == NULL) {
 		delete [] this->buffer_.memory;
 	}
-	this->buffer_.memory = new char[readout_size*2];
-	this->buffer_.memory_size = readout_size*2;
+	this->buffer_.memory = new char[this->readoutStride_*this->bufferReadouts_];
+	this->buffer_.memory_size = this->readoutStride_*this->bufferReadouts_;
 
 	// Setup acquisition buffer
 	err = PicamAdvanced_SetAcquisitionBuffer(this->camera_, &this->buffer_);
@@ -83,9 +115,25 @@ bool CameraController::startCamera() {
 		return false;
 	}
 
-	// Starting acquisition now that buffer has been setup!
+	// Readouts are handed over by the acquisition callback, so acquiring an image never waits in the SDK
+	this->readoutQueue_.reset(this->bufferReadouts_);
+	this->readoutsPublished_ = 0;
+	this->acquisitionFailed_ = false;
+	this->overrunReported_ = false;
+	PicamAdvanced_SetUserState(this->camera_, this);
+	err = PicamAdvanced_RegisterForAcquisitionUpdated(this->camera_, &CameraController::acquisitionUpdated);
+	if (err != PicamError_None) {
+		Utility::printLine("ERROR: Failed to register for acquisition updates!");
+		return false;
+	}
+
+	// Starting acquisition now that buffer has been setup! (time stamps count from here)
+	this->acquisitionRunning_ = true;
+	this->acquisitionStartHost_ = TimeStampGenerator::HostMicroS();
 	err = Picam_StartAcquisition(this->camera_);
 	if (err != PicamError_None) {
+		this->acquisitionRunning_ = false;
+		PicamAdvanced_UnregisterForAcquisitionUpdated(this->camera_, &CameraController::acquisitionUpdated);
 		Utility::printLine("ERROR: Failed to start acquisition!");
 		return false;
 	}
@@ -95,43 +143,225 @@ bool CameraController::startCamera() {
 	}
 }
 
+// Acquisition updated callback, the controller was set as the camera's user state by startCamera()
+PicamError PIL_CALL CameraController::acquisitionUpdated(PicamHandle device, const PicamAvailableData* available, const PicamAcquisitionStatus* status) {
+	void * controller = NULL;
+	if (PicamAdvanced_GetUserState(device, &controller) == PicamError_None && controller != NULL) {
+		static_cast<CameraController*>(controller)->publishReadouts(device, available, status);
+	}
+	return PicamError_None;
+}
+
+// Publish an update's readouts to the queue, oldest first
+void CameraController::publishReadouts(PicamHandle device, const PicamAvailableData* available, const PicamAcquisitionStatus* status) {
+	const double received = TimeStampGenerator::HostMicroS();
+	if (available != NULL && available->readout_count > 0) {
+		// Cast to char to offset by bytes
+		unsigned char* readout = (unsigned char*)available->initial_readout;
+		for (pi64s r = 0; r < available->readout_count; r++) {
+			unsigned char* curr_frame = readout + this->readoutStride_*r;
+			Readout entry;
+			entry.data = (const unsigned short *)curr_frame;
+			entry.frameStart = this->frameTimeStamps_ ? this->getFrameStartTime(curr_frame, this->frameSize_) : received;
+			entry.received = received;
+			entry.sequence = this->readoutsPublished_.load();
+			// Queue only fills if nothing has been read for a whole buffer, by which time the oldest readouts are being overwritten
+			if (!this->readoutQueue_.push(entry)) {
+				this->droppedFrames_++;
+			}
+			this->readoutsPublished_++;
+		}
+	}
+	// Count each time the SDK starts reporting an overrun (readouts written over before the update for them was made)
+	pibln overran = false;
+	if (PicamAdvanced_HasAcquisitionBufferOverrun(device, &overran) == PicamError_None) {
+		if (overran && !this->overrunReported_) {
+			this->bufferOverruns_++;
+		}
+		this->overrunReported_ = (overran != 0);
+	}
+	if ((status->errors & PicamAcquisitionErrorsMask_DataLost) != 0) {
+		this->bufferOverruns_++;
+	}
+	if ((status->errors & ~PicamAcquisitionErrorsMask_DataLost) != 0) {
+		this->acquisitionFailed_ = true;
+	}
+	if (!status->running) {
+		this->acquisitionRunning_ = false;
+	}
+}
+
+// Wait for the readout to acquire, readouts are checked oldest first when given an earliest start
+const unsigned short * CameraController::waitForReadout(double earliestStart, int timeoutMs, double & validUntil) {
+	const double waitStart = TimeStampGenerator::HostMicroS();
+	while (true) {
+		if (this->acquisitionFailed_) {
+			Utility::printLine("ERROR: Failed to acquire data from camera!");
+			return NULL;
+		}
+		Readout entry;
+		if (!this->readoutQueue_.pop(entry)) {
+			// Nothing more is coming once acquisition has ended
+			if (!this->acquisitionRunning_ && this->readoutQueue_.empty()) {
+				Utility::printLine("ERROR: Failed to acquire data from camera, acquisition is not running!");
+				return NULL;
+			}
+			if (timeoutMs >= 0 && TimeStampGenerator::HostMicroS() - waitStart > timeoutMs * 1000.0) {
+				return NULL;
+			}
+			std::this_thread::yield();
+			continue;
+		}
+		// The camera is writing the readout after the last one published, so the buffer comes round to this readout
+		// once the rest of the buffer less that one and the ones published after this one are filled
+		const long long readoutsLeft = this->bufferReadouts_ - 2 - (this->readoutsPublished_.load() - 1 - entry.sequence);
+		if (readoutsLeft < 0) {
+			this->droppedFrames_++;
+			continue;
+		}
+		// Without an earliest start, skip older readouts to the most recent
+		if (earliestStart < 0 && !this->readoutQueue_.empty()) {
+			continue;
+		}
+		if (entry.frameStart < earliestStart) {
+			// Exposed (at least partly) while the SLM was still settling
+			this->rejectedFrames_++;
+			continue;
+		}
+		this->lastFrameTime_ = entry.frameStart;
+		validUntil = entry.received + readoutsLeft * this->framePeriod_;
+		return entry.data;
+	}
+}
+
 // Get most recent image
 ImageController* CameraController::AcquireImage() {
-	// Get most recent image and return within ImageController class
-	PicamAvailableData curImageData;
-	PicamAcquisitionStatus curr_status;
-	PicamError result;
-
-	// Get the frame (size of image data itself in bytes) and readout (image and meta data)
-	piint frame_size = 0;
-	Picam_GetParameterIntegerValue(this->camera_, PicamParameter_FrameSize, &frame_size);
-	piint readout_size = 0;
-	Picam_GetParameterIntegerValue(this->camera_, PicamParameter_ReadoutStride, &readout_size);
-
-	int num_pixels = int(frame_size) / 2; // Number of pixels is half the size in bytes (2-byte depth for each pixel)
-
-	// Grab an image
-	// Attempt for acquisiton that is using (hopefully faster) asynchronous approach
-	try {
-		result = Picam_WaitForAcquisitionUpdate(this->camera_, -1, &curImageData, &curr_status);
-	}
-	catch (std::exception& e) {
-		Utility::printLine(e.what());
-	}
-	// Doing a check to make sure no issues (no reported errors and that there is at least one readout to get image from)
-	if (result != PicamError_None || curImageData.readout_count < 1 || curr_status.errors != PicamAcquisitionErrorsMask_None) {
-		Utility::printLine("ERROR: Failed to acquire data from camera!");
+	double validUntil;
+	const unsigned short * readout = this->waitForReadout(-1, -1, validUntil);
+	if (readout == NULL) {
 		return NULL;
 	}
+	// Copy data into ImageController, but be sure to convert from 2 byte elements to 1 byte
+	return new ImageController((unsigned short *)readout, this->numPixels_, this->cameraImageWidth, this->cameraImageHeight, this->appliedBinning_);
+}
 
-	// Getting a pointer to the most recent frame (our most recent image data) by skipping older readouts (simple method should have readout_count == 1)
-		// Cast to char to offset by bytes
-	unsigned char* curr_frame = (unsigned char*)curImageData.initial_readout;
-	curr_frame = curr_frame + readout_size*(curImageData.readout_count - 1);
+// Get the first frame exposed at least settleTime after the SLM write (received at least settleTime after it without frame time stamps)
+ImageController* CameraController::AcquireImageAfter(double writeTime) {
+	double validUntil;
+	const unsigned short * readout = this->waitForReadout(writeTime + this->settleTime, -1, validUntil);
+	if (readout == NULL) {
+		return NULL;
+	}
+	return new ImageController((unsigned short *)readout, this->numPixels_, this->cameraImageWidth, this->cameraImageHeight, this->appliedBinning_);
+}
 
-	// Copy data into ImageController, but be sure to convert from 2 byte elements to 1 byte
-		// Casting the frame pointer as type unsigned short (2 byte elements)
-	return new ImageController((unsigned short *)curr_frame, num_pixels, this->cameraImageWidth, this->cameraImageHeight);
+// Get the first frame exposed at least settleTime after the SLM write as a view of its readout, reusing a released view if there is one
+ImageController* CameraController::AcquireImageView(double writeTime) {
+	double validUntil;
+	const unsigned short * readout = this->waitForReadout(writeTime + this->settleTime, -1, validUntil);
+	if (readout == NULL) {
+		return NULL;
+	}
+	ImageController * view = NULL;
+	{
+		std::unique_lock<std::mutex> lock(this->viewsMutex_);
+		if (!this->freeViews_.empty()) {
+			view = this->freeViews_.back();
+			this->freeViews_.pop_back();
+		}
+	}
+	if (view == NULL) {
+		view = new ImageController();
+	}
+	view->setView(readout, this->numPixels_, this->cameraImageWidth, this->cameraImageHeight, validUntil, this->appliedBinning_);
+	return view;
+}
+
+// Give back an image when done with it
+void CameraController::ReleaseImage(ImageController * image) {
+	if (image == NULL) {
+		return;
+	}
+	if (!image->isView()) {
+		delete image;
+		return;
+	}
+	std::unique_lock<std::mutex> lock(this->viewsMutex_);
+	this->freeViews_.push_back(image);
+}
+
+// Get an image that can be held on to
+ImageController* CameraController::KeepImage(ImageController * image) {
+	if (image == NULL || !image->isView()) {
+		return image;
+	}
+	ImageController * kept = new ImageController(*image);
+	this->ReleaseImage(image);
+	return kept;
+}
+
+// Get the number of frames dropped by AcquireImageAfter() since the last call
+long long CameraController::TakeRejectedFrames() {
+	const long long rejected = this->rejectedFrames_;
+	this->rejectedFrames_ = 0;
+	return rejected;
+}
+
+// Get the number of frames lost for not being read in time since the last call
+long long CameraController::TakeDroppedFrames() {
+	return this->droppedFrames_.exchange(0);
+}
+
+// Get the number of acquisition buffer overruns since the last call
+long long CameraController::TakeBufferOverruns() {
+	return this->bufferOverruns_.exchange(0);
+}
+
+// Get the host time the exposure of the last acquired image started
+double CameraController::GetLastFrameTime() {
+	return this->lastFrameTime_;
+}
+
+// Get the host time a readout's exposure started, the exposure started time stamp is the first metadata after the frame
+double CameraController::getFrameStartTime(const unsigned char * readout, piint frameSize) {
+	unsigned long long ticks = 0;
+	memcpy(&ticks, readout + frameSize, (this->timeStampBytes_ > 0 && this->timeStampBytes_ < 8) ? this->timeStampBytes_ : 8);
+	return this->acquisitionStartHost_ + double(ticks) * 1000000.0 / this->timeStampResolution_;
+}
+
+// Get the next frames in the order they were read out, for sequences of triggered exposures
+int CameraController::AcquireSequence(int count, ImageController ** images, int timeoutMs) {
+	int acquired = 0;
+	while (acquired < count) {
+		// Every readout is kept, oldest first (unlike AcquireImage() which only takes the latest)
+		double validUntil;
+		const unsigned short * readout = this->waitForReadout(0, timeoutMs, validUntil);
+		if (readout == NULL) {
+			if (this->acquisitionRunning_ && !this->acquisitionFailed_) {
+				Utility::printLine("WARNING: Timed out waiting for frame " + std::to_string(acquired + 1) + " of " + std::to_string(count) + " in sequence!");
+			}
+			break;
+		}
+		images[acquired] = new ImageController((unsigned short *)readout, this->numPixels_, this->cameraImageWidth, this->cameraImageHeight, this->appliedBinning_);
+		acquired++;
+	}
+	return acquired;
+}
+
+// Set the camera to expose on its trigger input rather than freely, parameters are committed by startCamera()
+bool CameraController::SetExternalTrigger(bool enable, int bufferedFrames) {
+	// A readout for every trigger (positive level), or no response to the trigger input when free running
+	if (Picam_SetParameterIntegerValue(this->camera_, PicamParameter_TriggerResponse, enable ? PicamTriggerResponse_ReadoutPerTrigger : PicamTriggerResponse_NoResponse) != PicamError_None) {
+		Utility::printLine("ERROR: Failed to set trigger response!");
+		return false;
+	}
+	if (enable && Picam_SetParameterIntegerValue(this->camera_, PicamParameter_TriggerDetermination, PicamTriggerDetermination_PositivePolarity) != PicamError_None) {
+		Utility::printLine("ERROR: Failed to set trigger determination!");
+		return false;
+	}
+	// Triggered, two readouts more than the sequence so none of it is dropped as possibly overwritten before it is read
+	this->bufferReadouts_ = (enable && bufferedFrames + 2 > this->viewReadouts) ? bufferedFrames + 2 : this->viewReadouts;
+	return true;
 }
 
 // Stop acquisition process (but still holds camera instance and other resources)
@@ -141,14 +371,16 @@ bool CameraController::stopCamera() {
 	// End acquisition management but still need to have camera online for another run if needed
 	Picam_StopAcquisition(this->camera_);
 	
-	// Have to iterate through wait acquisition update until the running bool is false!
-	PicamAvailableData curImageData;
-	PicamAcquisitionStatus curr_status;
-	PicamError result;
-
-	do {
-		result = Picam_WaitForAcquisitionUpdate(this->camera_, -1, &curImageData, &curr_status);
-	} while (curr_status.running == pibln(true));
+	// Have to wait for the acquisition callback to report acquisition is no longer running before the buffer can go
+	const double stopStart = TimeStampGenerator::HostMicroS();
+	while (this->acquisitionRunning_ && TimeStampGenerator::HostMicroS() - stopStart < 5000000.0) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	if (this->acquisitionRunning_) {
+		Utility::printLine("WARNING: Acquisition callback did not report acquisition stopping!");
+		this->acquisitionRunning_ = false;
+	}
+	PicamAdvanced_UnregisterForAcquisitionUpdated(this->camera_, &CameraController::acquisitionUpdated);
 
 	// Deallocate the buffer
 	delete[] this->buffer_.memory;
@@ -243,6 +475,10 @@ bool CameraController::shutdownCamera() {
 	if (this->buffer_.memory != NULL) {
 		delete[] this->buffer_.memory;
 	}
+	for (int i = 0; i < int(this->freeViews_.size()); i++) {
+		delete this->freeViews_[i];
+	}
+	this->freeViews_.clear();
 
 	return true;
 }
@@ -284,6 +520,46 @@ bool CameraController::UpdateImageParameters() {
 		Utility::printLine("ERROR: Was unable to parse the initial exposure time input field!");
 		result = false;
 	}
+	// Settle time after an SLM write
+	try	{
+		CString path("");
+		dlg->m_cameraControlDlg.m_settleTime.GetWindowTextW(path);
+		if (path.IsEmpty()) throw new std::exception();
+		settleTime = _tstof(path);
+	}
+	catch (...)	{
+		Utility::printLine("ERROR: Was unable to parse the settle time input field!");
+		result = false;
+	}
+	// Auto readout settings
+	try	{
+		CString path("");
+		dlg->m_cameraControlDlg.m_readoutBinning.GetWindowTextW(path);
+		if (path.IsEmpty()) throw new std::exception();
+		readoutBinning = _tstoi(path);
+		autoReadout = (dlg->m_cameraControlDlg.m_autoReadout.GetCheck() == BST_CHECKED);
+	}
+	catch (...)	{
+		Utility::printLine("ERROR: Was unable to parse the readout binning input field!");
+		result = false;
+	}
+	// Acquisition buffer readouts when free running
+	try	{
+		CString path("");
+		dlg->m_cameraControlDlg.m_viewReadouts.GetWindowTextW(path);
+		if (path.IsEmpty()) throw new std::exception();
+		viewReadouts = _tstoi(path);
+		// A view is valid while all but two readouts are filled, so at least one more than that is needed
+		if (viewReadouts < 3) {
+			Utility::printLine("WARNING: View readouts must be at least 3, using 3");
+			viewReadouts = 3;
+		}
+		bufferReadouts_ = viewReadouts;
+	}
+	catch (...)	{
+		Utility::printLine("ERROR: Was unable to parse the view readouts input field!");
+		result = false;
+	}
 	// Get all AOI settings
 	try	{
 		CString path("");
@@ -453,9 +729,23 @@ bool CameraController::ConfigureCustomImageSettings() {
 
 	// ROI according to GUI, implementation approach based on PICam example rois.cpp //
 
-	// Checking if the GUI setup is invalid by checking against max dimensions and if our ROI is going out of bounds
 	int x_max, y_max;
 	this->GetFullImage(x_max, y_max);
+	// Auto readout, the smallest square of whole binned pixels holding the target's disc & margin, centered where the fitness is read
+	int binning = 1;
+	if (this->autoReadout) {
+		binning = (this->readoutBinning > 1) ? this->readoutBinning : 1;
+		int side = 2 * (this->targetRadius + this->autoReadoutMargin);
+		side = ((side + binning - 1) / binning) * binning;
+		const int centerX = this->x0 + this->cameraImageWidth / 2;
+		const int centerY = this->y0 + this->cameraImageHeight / 2;
+		this->x0 = (centerX - side / 2 < 0) ? 0 : ((centerX - side / 2 > x_max - side) ? x_max - side : centerX - side / 2);
+		this->y0 = (centerY - side / 2 < 0) ? 0 : ((centerY - side / 2 > y_max - side) ? y_max - side : centerY - side / 2);
+		this->cameraImageWidth = side;
+		this->cameraImageHeight = side;
+		Utility::printLine("INFO: Auto readout of " + std::to_string(side) + "x" + std::to_string(side) + " pixels at (" + std::to_string(this->x0) + ", " + std::to_string(this->y0) + ") binned by " + std::to_string(binning));
+	}
+	// Checking if the GUI setup is invalid by checking against max dimensions and if our ROI is going out of bounds
 	if ((this->x0 + this->cameraImageWidth) > x_max || (this->y0 + this->cameraImageHeight) > y_max) {
 		Utility::printLine("ERROR: Set ROI exceeds the camera constraints!  Defaulting to entire window for debug");
 		this->x0 = 0;
@@ -476,14 +766,18 @@ bool CameraController::ConfigureCustomImageSettings() {
 		region->roi_array[0].height = this->cameraImageHeight;
 		region->roi_array[0].width = this->cameraImageWidth;
 
-		region->roi_array[0].x_binning = 1;
-		region->roi_array[0].y_binning = 1;
+		region->roi_array[0].x_binning = binning;
+		region->roi_array[0].y_binning = binning;
 	}
 	PicamError errMsg = Picam_SetParameterRoisValue(this->camera_, PicamParameter_Rois, region);
 	if (errMsg != PicamError_None) {
 		Utility::printLine("ERROR: Failed to set ROI");
 		return false;
 	}
+	// Images are read out binned (binned pixels hold the sum of their charge, ImageController divides it back down so fitness keeps the unbinned scale)
+	this->appliedBinning_ = binning;
+	this->cameraImageWidth /= binning;
+	this->cameraImageHeight /= binning;
 	
 	// TODO: Figure out these two parameters
 	// Set gamma
@@ -493,6 +787,12 @@ bool CameraController::ConfigureCustomImageSettings() {
 	// Set FPS
 		// Unsure if there is a comparable setting for PICam
 	
+	// Time stamp the start of each exposure so frames can be matched to SLM writes (see AcquireImageAfter())
+	this->frameTimeStamps_ = (Picam_SetParameterIntegerValue(this->camera_, PicamParameter_TimeStamps, PicamTimeStampsMask_ExposureStarted) == PicamError_None);
+	if (!this->frameTimeStamps_) {
+		Utility::printLine("WARNING: Camera does not time stamp frames, the latest frame is used after each SLM write");
+	}
+
 	// Setting initial exposure and commiting parameters //
 	this->ConfigureExposureTime();
 
@@ -588,6 +888,15 @@ bool CameraController::ConfigureExposureTime() {
 	return SetExposure(finalExposureTime);
 }
 
+// Get the radius of the fitness target in binned pixels
+int CameraController::GetFitnessRadius() {
+	if (this->appliedBinning_ <= 1) {
+		return this->targetRadius;
+	}
+	const int radius = (this->targetRadius + this->appliedBinning_ / 2) / this->appliedBinning_;
+	return (radius > 1) ? radius : 1;
+}
+
 // Get the multiplier for exposure having been halved
 double CameraController::GetExposureRatio() {
 	return initialExposureTime / finalExposureTime;
@@ -9,11 +9,15 @@
 #ifdef USE_PICAM
 
 #include <string>
+#include <vector>	// Pool of image views
+#include <mutex>	// Views are released outside the hardware lock
+#include <atomic>	// State shared with the acquisition callback
 
 #include "picam.h" // core include for PICam SDK
 #include "picam_advanced.h" // advanced methods (buffer management) for async continuous acquisition for faster rate
 
 #include "ImageControllerPICam.h" // Image wrapper
+#include "FrameQueue.h"	// Readouts handed over by the acquisition callback
 
 class MainDialog;
 
@@ -42,11 +46,61 @@ public:
 
 	//Image target settings
 	int targetRadius = 5;
+
+	// Time (microseconds) after an SLM write finishes before a frame's exposure may start for AcquireImageAfter() to use it
+	double settleTime = 0;
+
+	// Auto readout, only the target's disc plus a margin is read out (centered on the AOI's center, where the fitness is read) and binned
+	//	once configured the AOI values are those of the readout, with the width & height in binned pixels
+	bool autoReadout = false;		// TRUE -> shrink the readout to the target when configuring the camera
+	int autoReadoutMargin = 2;		// Pixels (unbinned) read out around the target's disc
+	int readoutBinning = 1;			// Pixels binned together in x & y with auto readout (1 -> no binning)
+
+	// Readouts the circular acquisition buffer holds when free running (more give more time for a late read before the camera
+	//	comes round to a readout), an image view stays valid for the time the camera takes to fill all but two of them
+	int viewReadouts = 8;
 private:
 	MainDialog* dlg; // Pointer to GUI instance to access parameters with
 
 	PicamHandle camera_; // The connected camera to use
 	PicamAcquisitionBuffer buffer_; // User buffer for asynchronous acquisition
+	int bufferReadouts_;			// Number of readouts the acquisition buffer holds (more when triggered so a sequence is not overwritten)
+	bool frameTimeStamps_;			// TRUE -> readouts carry the time stamp of their exposure start (see AcquireImageAfter())
+	double timeStampResolution_;	// Time stamp ticks per second
+	int timeStampBytes_;			// Size of each time stamp in the readout metadata
+	double acquisitionStartHost_;	// Host time (microseconds) acquisition was started, which time stamps count from
+	long long rejectedFrames_;		// Frames dropped by AcquireImageAfter() for being exposed before the SLM settled
+	int appliedBinning_;			// Binning of the configured readout
+	double lastFrameTime_;			// Host time (microseconds) the exposure of the last acquired image started
+
+	// Frame geometry of the acquisition session (cached by startCamera())
+	piint frameSize_;				// Bytes of image data in a readout
+	piint readoutStride_;			// Bytes from one readout to the next in the acquisition buffer (image data and metadata)
+	int numPixels_;					// Pixels in a readout (2 bytes each)
+	double framePeriod_;			// Calculated time (microseconds) between readouts
+
+	std::vector<ImageController*> freeViews_;	// Released image views to reuse (see AcquireImageView())
+	std::mutex viewsMutex_;						// Guards freeViews_
+
+	// A readout published by the acquisition callback
+	struct Readout {
+		const unsigned short * data;	// Readout's image data in the acquisition buffer
+		double frameStart;				// Host time (microseconds) its exposure started (the time it was received without time stamps)
+		double received;				// Host time (microseconds) the callback received it
+		long long sequence;				// Number of readouts published before it this acquisition
+	};
+	FrameQueue<Readout> readoutQueue_;			// Readouts from the acquisition callback (producer) to waitForReadout() (consumer)
+	std::atomic<long long> readoutsPublished_;	// Readouts published this acquisition
+	std::atomic<bool> acquisitionRunning_;		// FALSE once the callback has reported acquisition has ended
+	std::atomic<bool> acquisitionFailed_;		// TRUE once the callback has reported an error other than lost data
+	std::atomic<long long> droppedFrames_;		// Readouts not read before the camera could come round to them (see TakeDroppedFrames())
+	std::atomic<long long> bufferOverruns_;		// Times the SDK reported the acquisition buffer overran (see TakeBufferOverruns())
+	bool overrunReported_;						// Last overrun state reported by the SDK (only used by the callback)
+
+	// Acquisition updated callback, called on the SDK's thread with each update's readouts
+	static PicamError PIL_CALL acquisitionUpdated(PicamHandle device, const PicamAvailableData* available, const PicamAcquisitionStatus* status);
+	// Publish an update's readouts to readoutQueue_, counting any the queue has no room for & any buffer overrun
+	void publishReadouts(PicamHandle device, const PicamAvailableData* available, const PicamAcquisitionStatus* status);
 
 
 	pibln * libraryInitialized; // library has been initialized or not
@@ -55,6 +109,16 @@ private:
 	piint getIntParameterValue(PicamParameter parameter);
 	piflt getFloatParameterValue(PicamParameter parameter);
 	std::string getStringParameterValue(PicamEnumeratedType type, PicamParameter parameterVal);
+	// Get the host time (microseconds) a readout's exposure started from its time stamp metadata
+	// Input: readout - start of the readout, frameSize - size of the frame data in bytes (the metadata follows it)
+	double getFrameStartTime(const unsigned char * readout, piint frameSize);
+	// Wait for the readout to acquire from the callback's queue (no SDK calls), the most recent one or the first whose exposure
+	// started at or after a time (such as settleTime after an SLM write), readouts the camera could have come round to are dropped
+	// Input: earliestStart - earliest host time (microseconds) the readout's exposure can have started at, negative for the most recent readout
+	//		timeoutMs - longest wait for a readout in milliseconds, negative to wait for as long as acquisition runs
+	// Output: returns the readout in the acquisition buffer, NULL if acquisition failed or timed out
+	//		validUntil - host time (microseconds) after which the camera may have overwritten the readout
+	const unsigned short * waitForReadout(double earliestStart, int timeoutMs, double & validUntil);
 	
 public:
 
@@ -65,6 +129,42 @@ public:
 	bool startCamera();
 	bool saveImage(ImageController * curImage, std::string path);
 	ImageController* AcquireImage();
+	// Acquire the first frame whose exposure started at least settleTime after the given host time, dropping frames exposed earlier
+	// Input: writeTime - host time (microseconds, TimeStampGenerator::HostMicroS()) the SLM write finished, such as SLMController::lastWriteTime
+	// Output: returns the image (caller is responsible for deleting it), NULL if acquisition failed
+	//		without frame time stamps the time a frame was received stands in for its exposure start, so frames received before then are dropped
+	ImageController* AcquireImageAfter(double writeTime);
+	// Acquire the same frame as AcquireImageAfter() as a view of the readout in the acquisition buffer, without copying or converting it
+	// Input: writeTime - as AcquireImageAfter()
+	// Output: returns the view (NULL if acquisition failed), to be given back with ReleaseImage() rather than deleted
+	//		the view is only valid while the camera has not come round the acquisition buffer to its readout (see ImageController::isValid())
+	//		and must be released before the camera is stopped, so its fitness should be found right away and KeepImage() used to hold on to it
+	ImageController* AcquireImageView(double writeTime);
+	// Give back an image when done with it, a view is returned to the pool for reuse and any other image is deleted
+	void ReleaseImage(ImageController * image);
+	// Get an image that can be held on to, a view is copied (then released) and any other image is returned as is
+	// Output: returns an image the caller is responsible for deleting
+	ImageController* KeepImage(ImageController * image);
+	// Get the number of frames dropped by AcquireImageAfter() since the last call, then start counting again
+	long long TakeRejectedFrames();
+	// Get the number of frames lost since the last call for not being read before the camera could overwrite them, then start counting again
+	// (while free running this includes frames exposed while no image was being acquired)
+	long long TakeDroppedFrames();
+	// Get the number of times the acquisition buffer overran (the SDK lost readouts) since the last call, then start counting again
+	long long TakeBufferOverruns();
+	// Get the host time (microseconds, TimeStampGenerator::HostMicroS()) the exposure of the last acquired image started
+	// (the time it was received when the camera does not time stamp frames)
+	double GetLastFrameTime();
+	// Acquire the next frames in the order they were exposed (none skipped), for sequences of triggered exposures
+	// Input: count - number of frames to get, images - array of count to fill, timeoutMs - longest wait for each frame
+	// Output: returns the number of frames acquired (fewer than count if a frame did not arrive in time or acquisition failed),
+	//		images[0 .. returned-1] hold new images (caller is responsible for deleting them)
+	int AcquireSequence(int count, ImageController ** images, int timeoutMs);
+	// Set the camera to expose on its trigger input (such as an SLM's output pulse) rather than freely, to be called while acquisition is stopped
+	// Input: enable - true for triggered exposures, false for free running
+	//		bufferedFrames - frames the acquisition buffer is to hold when triggered (a whole sequence, so none are lost before being read)
+	// Output: returns false if the camera could not be set, takes effect from the next startCamera()
+	bool SetExternalTrigger(bool enable, int bufferedFrames = 2);
 	bool stopCamera();
 	bool shutdownCamera();
 
@@ -82,6 +182,8 @@ public:
 	bool GetFullImage(int &x, int &y);
 	// Return true if this controller has access to at least one camera
 	bool hasCameras();
+	// Get the radius of the fitness target in the pixels of acquired images (the target radius scaled down by any binning)
+	int GetFitnessRadius();
 	// Setter for exposure setting
 	bool SetExposure(double exposureTimeToSet);
 	// Get the multiplier for exposure having been halved
@@ -7,6 +7,7 @@
 #include "CameraController.h"
 #include "MainDialog.h"
 #include "Utility.h"
+#include "Timing.h"		// Host time to line up frame time stamps with SLM writes
 
 #ifdef USE_SPINNAKER // Only include this implementation if using Spinnaker
 
@@ -86,17 +87,48 @@ bool CameraController::startCamera() {
 
 		// Setting buffer handler
 		//		Spinnaker defaults to OldestFirst, changed to NewestOnly as we are only interested in current image for individual being run
+		//		(unless triggered, where every frame of a sequence is read in order)
 		CEnumerationPtr ptrSBufferHandler = TLnodeMap.GetNode("StreamBufferHandlingMode");
 		if (!IsAvailable(ptrSBufferHandler) || !IsWritable(ptrSBufferHandler)) {
 			Utility::printLine("ERROR: Unable to set buffer handler mode (node retrieval).");
 			return false;
 		}
+		else if (this->externalTrigger_) {
+			ptrSBufferHandler->SetIntValue(Spinnaker::StreamBufferHandlingMode_OldestFirst);
+			// Enough buffers to hold a whole sequence
+			if (this->SetEnumNode(TLnodeMap, "StreamBufferCountMode", "Manual")) {
+				CIntegerPtr ptrBufferCount = TLnodeMap.GetNode("StreamBufferCountManual");
+				if (IsAvailable(ptrBufferCount) && IsWritable(ptrBufferCount)) {
+					const int64_t maxBuffers = ptrBufferCount->GetMax();
+					ptrBufferCount->SetValue((int64_t(this->bufferedFrames_) < maxBuffers) ? int64_t(this->bufferedFrames_) : maxBuffers);
+				}
+			}
+		}
 		else {
-			ptrSBufferHandler->SetIntValue(Spinnaker::StreamBufferHandlingMode_NewestOnly);
+			if (!this->SetEnumNode(TLnodeMap, "StreamBufferHandlingMode", this->streamBufferHandling.c_str())) {
+				Utility::printLine("WARNING: Unable to set buffer handler mode " + this->streamBufferHandling + ", using NewestOnly");
+				ptrSBufferHandler->SetIntValue(Spinnaker::StreamBufferHandlingMode_NewestOnly);
+			}
+			// Set buffer count (an image view holds one of the buffers until it is released)
+			if (this->streamBufferCount > 0 && this->SetEnumNode(TLnodeMap, "StreamBufferCountMode", "Manual")) {
+				CIntegerPtr ptrBufferCount = TLnodeMap.GetNode("StreamBufferCountManual");
+				if (IsAvailable(ptrBufferCount) && IsWritable(ptrBufferCount)) {
+					const int64_t maxBuffers = ptrBufferCount->GetMax();
+					ptrBufferCount->SetValue((int64_t(this->streamBufferCount) < maxBuffers) ? int64_t(this->streamBufferCount) : maxBuffers);
+				}
+			}
+			else if (this->streamBufferCount <= 0) {
+				this->SetEnumNode(TLnodeMap, "StreamBufferCountMode", "Auto");
+			}
 		}
 		//Begin Aquisition
 		cam->BeginAcquisition();
 		Utility::printLine("INFO: Successfully began acquiring images!");
+		// Frame time stamps are in the camera's clock, so line it up with the host's
+		if (this->frameTimeStamps_ && !this->LatchClock(nodeMap)) {
+			Utility::printLine("WARNING: Unable to latch camera clock, the latest frame is used after each SLM write");
+			this->frameTimeStamps_ = false;
+		}
 	}
 	catch (Spinnaker::Exception &e)	{
 		Utility::printLine("ERROR: Camera could not start - /n" + std::string(e.what()));
@@ -112,6 +144,11 @@ bool CameraController::stopCamera() {
 
 //Releases camera references - have to call setup camera again if need to use camer after this call
 bool CameraController::shutdownCamera() {
+	// Views left in the pool (any still held have to be released before the camera goes)
+	for (int i = 0; i < int(this->freeViews_.size()); i++) {
+		delete this->freeViews_[i];
+	}
+	this->freeViews_.clear();
 	//release camera
 	cam->DeInit();
 	//release system
@@ -142,24 +179,74 @@ bool CameraController::saveImage(ImageController * curImage, std::string path) {
 	return true;
 }
 
+// Get the next image from the stream whose exposure started at or after a time, releasing (rejecting) earlier ones back to the stream
+bool CameraController::NextImage(double earliestStart, Spinnaker::ImagePtr & image) {
+	try {
+		while (true) {
+			// Retrieve next received image
+			Spinnaker::ImagePtr curImage = cam->GetNextImage();
+
+			// Ensure image completion
+			if (curImage->IsIncomplete()) {
+				//TODO: implement proper handling of incomplete images (retake of image)
+				Utility::printLine("ERROR: Image incomplete: " + std::string(Spinnaker::Image::GetImageStatusDescription(curImage->GetImageStatus())));
+			}
+			// Time stamp is in nanoseconds of the camera's clock
+			const double exposureStart = this->frameTimeStamps_ ? double(curImage->GetChunkData().GetTimestamp()) / 1000.0 + this->clockOffset_ : TimeStampGenerator::HostMicroS();
+			if (earliestStart < 0 || exposureStart >= earliestStart) {
+				this->lastFrameTime_ = exposureStart;
+				image = curImage;
+				return true;
+			}
+			// Exposed (at least partly) while the SLM was still settling
+			curImage->Release();
+			this->rejectedFrames_++;
+		}
+	}
+	catch (Spinnaker::Exception &e) {
+		Utility::printLine("ERROR: " + std::string(e.what()));
+		return false;
+	}
+}
+
+// Copy a stream image into a new ImageController, converting it only if it is not already Mono8
+ImageController * CameraController::CopyImage(Spinnaker::ImagePtr & image) {
+	if (image->GetPixelFormat() == Spinnaker::PixelFormat_Mono8) {
+		return new ImageController(image, false);
+	}
+	// A converted image is not from the stream, so it does not need releasing
+		// Resource reference says so in example conversion to mono 8 -> http://softwareservices.flir.com/Spinnaker/latest/_acquisition_8cpp-example.html
+	Spinnaker::ImagePtr converted = image->Convert(Spinnaker::PixelFormat_Mono8);
+	return new ImageController(converted, false);
+}
+
 //AcquireImages: get one image from the camera
 ImageController * CameraController::AcquireImage() {
+	Spinnaker::ImagePtr curImage;
+	if (!this->NextImage(-1, curImage)) {
+		return NULL;
+	}
 	try {
-		// Retrieve next received image
-		Spinnaker::ImagePtr curImage = cam->GetNextImage();
-
-		// Ensure image completion
-		if (curImage->IsIncomplete()) {
-			//TODO: implement proper handling of incomplete images (retake of image)
-			Utility::printLine("ERROR: Image incomplete: " + std::string(Spinnaker::Image::GetImageStatusDescription(curImage->GetImageStatus())));
-		}
-		
-		// Assign the converted output image to outImage, since this is a converted image we don't need to release it
-			// Resource reference says so in example conversion to mono 8 -> http://softwareservices.flir.com/Spinnaker/latest/_acquisition_8cpp-example.html
-		ImageController* outImage = new ImageController(curImage->Convert(Spinnaker::PixelFormat_Mono8), false);
+		ImageController* outImage = this->CopyImage(curImage);
 		// Release from the buffer
 		curImage->Release();
+		return outImage;
+	}
+	catch (Spinnaker::Exception &e) {
+		Utility::printLine("ERROR: " + std::string(e.what()));
+		return NULL;
+	}
+}
 
+// Get the first frame exposed at least settleTime after the SLM write (the time stamp chunk is latched at exposure start)
+ImageController * CameraController::AcquireImageAfter(double writeTime) {
+	Spinnaker::ImagePtr curImage;
+	if (!this->NextImage(writeTime + this->settleTime, curImage)) {
+		return NULL;
+	}
+	try {
+		ImageController* outImage = this->CopyImage(curImage);
+		curImage->Release();
 		return outImage;
 	}
 	catch (Spinnaker::Exception &e) {
@@ -168,6 +255,191 @@ ImageController * CameraController::AcquireImage() {
 	}
 }
 
+// Get the same frame as AcquireImageAfter() in a pooled view, a Mono8 image keeps its stream buffer (no copy) until released
+ImageController * CameraController::AcquireImageView(double writeTime) {
+	Spinnaker::ImagePtr curImage;
+	if (!this->NextImage(writeTime + this->settleTime, curImage)) {
+		return NULL;
+	}
+	ImageController * view = NULL;
+	{
+		std::unique_lock<std::mutex> lock(this->viewsMutex_);
+		if (!this->freeViews_.empty()) {
+			view = this->freeViews_.back();
+			this->freeViews_.pop_back();
+		}
+	}
+	if (view == NULL) {
+		view = new ImageController();
+	}
+	try {
+		if (curImage->GetPixelFormat() == Spinnaker::PixelFormat_Mono8) {
+			view->setView(curImage, true);
+		}
+		else {
+			// Other formats are converted (the converted image is the view's own), so the stream buffer can go straight back
+			Spinnaker::ImagePtr converted = curImage->Convert(Spinnaker::PixelFormat_Mono8);
+			curImage->Release();
+			view->setView(converted, false);
+		}
+	}
+	catch (Spinnaker::Exception &e) {
+		Utility::printLine("ERROR: " + std::string(e.what()));
+		curImage->Release();
+		delete view;
+		return NULL;
+	}
+	return view;
+}
+
+// Give back an image when done with it, a view's stream buffer goes back to the stream & the view to the pool
+void CameraController::ReleaseImage(ImageController * image) {
+	if (image == NULL) {
+		return;
+	}
+	if (!image->isView()) {
+		delete image;
+		return;
+	}
+	image->releaseView();
+	std::unique_lock<std::mutex> lock(this->viewsMutex_);
+	this->freeViews_.push_back(image);
+}
+
+// Get an image that can be held on to, a view is copied (then released) and any other image is returned as is
+ImageController * CameraController::KeepImage(ImageController * image) {
+	if (image == NULL || !image->isView()) {
+		return image;
+	}
+	Spinnaker::ImagePtr viewed = image->getImage();
+	ImageController * kept = new ImageController(viewed, false);
+	this->ReleaseImage(image);
+	return kept;
+}
+
+// Get the number of frames dropped by AcquireImageAfter() since the last call
+long long CameraController::TakeRejectedFrames() {
+	const long long rejected = this->rejectedFrames_;
+	this->rejectedFrames_ = 0;
+	return rejected;
+}
+
+// Get the radius of the fitness target in binned pixels
+int CameraController::GetFitnessRadius() {
+	if (this->appliedBinning_ <= 1) {
+		return this->targetRadius;
+	}
+	const int radius = (this->targetRadius + this->appliedBinning_ / 2) / this->appliedBinning_;
+	return (radius > 1) ? radius : 1;
+}
+
+// Get the stream's lost frame count since the last call
+long long CameraController::TakeDroppedFrames() {
+	return this->TakeStreamCount("StreamLostFrameCount", this->droppedFramesTaken_);
+}
+
+// Get the stream's buffer underruns (a frame arriving with no free buffer) since the last call
+long long CameraController::TakeBufferOverruns() {
+	return this->TakeStreamCount("StreamBufferUnderrunCount", this->bufferOverrunsTaken_);
+}
+
+// Get the increase of a stream counter node since it was last taken
+long long CameraController::TakeStreamCount(const char * node, long long & taken) {
+	try {
+		CIntegerPtr ptrCount = cam->GetTLStreamNodeMap().GetNode(node);
+		if (!IsAvailable(ptrCount) || !IsReadable(ptrCount)) {
+			return 0;
+		}
+		const long long count = ptrCount->GetValue();
+		// Stream counters restart with the stream
+		const long long increase = (count >= taken) ? count - taken : count;
+		taken = count;
+		return increase;
+	}
+	catch (Spinnaker::Exception &e) {
+		Utility::printLine("WARNING: " + std::string(e.what()));
+		return 0;
+	}
+}
+
+// Get the host time the exposure of the last acquired image started
+double CameraController::GetLastFrameTime() {
+	return this->lastFrameTime_;
+}
+
+// Latch the camera's clock between two host times, taking the host time as their middle
+bool CameraController::LatchClock(INodeMap & nodeMap) {
+	CCommandPtr ptrLatch = nodeMap.GetNode("TimestampLatch");
+	CIntegerPtr ptrLatchValue = nodeMap.GetNode("TimestampLatchValue");
+	if (!IsAvailable(ptrLatch) || !IsWritable(ptrLatch) || !IsAvailable(ptrLatchValue) || !IsReadable(ptrLatchValue)) {
+		return false;
+	}
+	const double before = TimeStampGenerator::HostMicroS();
+	ptrLatch->Execute();
+	const double after = TimeStampGenerator::HostMicroS();
+	this->clockOffset_ = (before + after) / 2 - double(ptrLatchValue->GetValue()) / 1000.0;
+	return true;
+}
+
+// Get the next frames in the order they were exposed, for sequences of triggered exposures
+int CameraController::AcquireSequence(int count, ImageController ** images, int timeoutMs) {
+	int acquired = 0;
+	try {
+		for (; acquired < count; acquired++) {
+			Spinnaker::ImagePtr curImage = cam->GetNextImage(timeoutMs);
+			if (curImage->IsIncomplete()) {
+				Utility::printLine("ERROR: Image incomplete: " + std::string(Spinnaker::Image::GetImageStatusDescription(curImage->GetImageStatus())));
+			}
+			images[acquired] = this->CopyImage(curImage);
+			curImage->Release();
+		}
+	}
+	catch (Spinnaker::Exception &e) {
+		Utility::printLine("WARNING: Stopped acquiring sequence at frame " + std::to_string(acquired + 1) + " of " + std::to_string(count) + " - " + std::string(e.what()));
+	}
+	return acquired;
+}
+
+// Set the camera to expose on its trigger input (line 0, rising edge) rather than freely, buffer handling is set by startCamera()
+bool CameraController::SetExternalTrigger(bool enable, int bufferedFrames) {
+	try {
+		INodeMap &nodeMap = cam->GetNodeMap();
+		// Trigger mode has to be off to change the trigger source
+		if (!this->SetEnumNode(nodeMap, "TriggerMode", "Off")) {
+			Utility::printLine("ERROR: Unable to turn off trigger mode!");
+			return false;
+		}
+		if (enable) {
+			if (!this->SetEnumNode(nodeMap, "TriggerSelector", "FrameStart") || !this->SetEnumNode(nodeMap, "TriggerSource", "Line0")
+				|| !this->SetEnumNode(nodeMap, "TriggerActivation", "RisingEdge") || !this->SetEnumNode(nodeMap, "TriggerMode", "On")) {
+				Utility::printLine("ERROR: Unable to set external trigger!");
+				return false;
+			}
+		}
+	}
+	catch (Spinnaker::Exception &e) {
+		Utility::printLine("ERROR: " + std::string(e.what()));
+		return false;
+	}
+	this->externalTrigger_ = enable;
+	this->bufferedFrames_ = (bufferedFrames > 2) ? bufferedFrames : 2;
+	return true;
+}
+
+// Set an enumeration node to one of its entries by name
+bool CameraController::SetEnumNode(INodeMap & nodeMap, const char * node, const char * entry) {
+	CEnumerationPtr ptrNode = nodeMap.GetNode(node);
+	if (!IsAvailable(ptrNode) || !IsWritable(ptrNode)) {
+		return false;
+	}
+	CEnumEntryPtr ptrEntry = ptrNode->GetEntryByName(entry);
+	if (!IsAvailable(ptrEntry) || !IsReadable(ptrEntry)) {
+		return false;
+	}
+	ptrNode->SetIntValue(ptrEntry->GetValue());
+	return true;
+}
+
 // [CAMERA SETUP]
 // Pull camera settings from CameraControlDialog and AOIControlDialog
 bool CameraController::UpdateImageParameters() {
@@ -205,6 +477,44 @@ bool CameraController::UpdateImageParameters() {
 		Utility::printLine("ERROR: Was unable to parse the initial exposure time input field!");
 		result = false;
 	}
+	// Settle time after an SLM write
+	try	{
+		CString path("");
+		dlg->m_cameraControlDlg.m_settleTime.GetWindowTextW(path);
+		if (path.IsEmpty()) throw new std::exception();
+		settleTime = _tstof(path);
+	}
+	catch (...)	{
+		Utility::printLine("ERROR: Was unable to parse the settle time input field!");
+		result = false;
+	}
+	// Auto readout settings
+	try	{
+		CString path("");
+		dlg->m_cameraControlDlg.m_readoutBinning.GetWindowTextW(path);
+		if (path.IsEmpty()) throw new std::exception();
+		readoutBinning = _tstoi(path);
+		autoReadout = (dlg->m_cameraControlDlg.m_autoReadout.GetCheck() == BST_CHECKED);
+	}
+	catch (...)	{
+		Utility::printLine("ERROR: Was unable to parse the readout binning input field!");
+		result = false;
+	}
+	// Stream buffer settings when free running
+	try	{
+		CString path("");
+		dlg->m_cameraControlDlg.m_streamBufferCount.GetWindowTextW(path);
+		if (path.IsEmpty()) throw new std::exception();
+		streamBufferCount = _tstoi(path);
+		const int handling = dlg->m_cameraControlDlg.m_streamBufferHandling.GetCurSel();
+		if (handling == CB_ERR) throw new std::exception();
+		dlg->m_cameraControlDlg.m_streamBufferHandling.GetLBText(handling, path);
+		streamBufferHandling = std::string(CT2A(path));
+	}
+	catch (...)	{
+		Utility::printLine("ERROR: Was unable to parse the stream buffer input fields!");
+		result = false;
+	}
 	// Get all AOI settings
 	try	{
 		CString path("");
@@ -372,6 +682,43 @@ bool CameraController::ConfigureCustomImageSettings() {
 		else
 			Utility::printLine("ERROR: Pixel format not available...");
 
+		// Binning (only with auto readout), the AOI nodes are in binned pixels after this
+		int binning = (this->autoReadout && this->readoutBinning > 1) ? this->readoutBinning : 1;
+		CIntegerPtr ptrBinningH = cam->GetNodeMap().GetNode("BinningHorizontal");
+		CIntegerPtr ptrBinningV = cam->GetNodeMap().GetNode("BinningVertical");
+		if (IsAvailable(ptrBinningH) && IsWritable(ptrBinningH) && IsAvailable(ptrBinningV) && IsWritable(ptrBinningV)) {
+			// Average binned pixels (where the camera can) so fitness values keep the scale of unbinned images
+			this->SetEnumNode(cam->GetNodeMap(), "BinningHorizontalMode", "Average");
+			this->SetEnumNode(cam->GetNodeMap(), "BinningVerticalMode", "Average");
+			ptrBinningV->SetValue(binning);
+			ptrBinningH->SetValue(binning);
+		}
+		else if (binning > 1) {
+			Utility::printLine("WARNING: Binning not available, reading out unbinned");
+			binning = 1;
+		}
+		this->appliedBinning_ = binning;
+		// Auto readout, the smallest AOI holding the target's disc & margin, centered where the fitness is read
+		if (this->autoReadout) {
+			const int incX = int(cam->Width.GetInc()), incY = int(cam->Height.GetInc());
+			const int offsetIncX = int(cam->OffsetX.GetInc()), offsetIncY = int(cam->OffsetY.GetInc());
+			const int maxWidth = int(cam->WidthMax.GetValue()), maxHeight = int(cam->HeightMax.GetValue());
+			const int side = (2 * (this->targetRadius + this->autoReadoutMargin) + binning - 1) / binning;
+			const int centerX = (this->x0 + this->cameraImageWidth / 2) / binning;
+			const int centerY = (this->y0 + this->cameraImageHeight / 2) / binning;
+			this->cameraImageWidth = ((side + incX - 1) / incX) * incX;
+			this->cameraImageHeight = ((side + incY - 1) / incY) * incY;
+			int offsetX = centerX - this->cameraImageWidth / 2;
+			int offsetY = centerY - this->cameraImageHeight / 2;
+			offsetX = (offsetX < 0) ? 0 : ((offsetX > maxWidth - this->cameraImageWidth) ? maxWidth - this->cameraImageWidth : offsetX);
+			offsetY = (offsetY < 0) ? 0 : ((offsetY > maxHeight - this->cameraImageHeight) ? maxHeight - this->cameraImageHeight : offsetY);
+			// Offsets are kept in unbinned pixels like the AOI typed in
+			this->x0 = (offsetX - offsetX % offsetIncX) * binning;
+			this->y0 = (offsetY - offsetY % offsetIncY) * binning;
+			Utility::printLine("INFO: Auto readout of " + std::to_string(this->cameraImageWidth) + "x" + std::to_string(this->cameraImageHeight) + " binned pixels at ("
+				+ std::to_string(this->x0) + ", " + std::to_string(this->y0) + ") binned by " + std::to_string(binning));
+		}
+
 		//Apply initial zero offset in x direction (needed to minimize AOI errors)
 		if (cam->OffsetX != NULL && cam->OffsetX.GetAccessMode() == RW) {
 			cam->OffsetX.SetValue(0);
@@ -400,16 +747,16 @@ bool CameraController::ConfigureCustomImageSettings() {
 		else {
 			Utility::printLine("ERROR: Height not available");
 		}
-		//Apply final offset in x direction
+		//Apply final offset in x direction (in binned pixels)
 		if (cam->OffsetX != NULL && cam->OffsetX.GetAccessMode() == RW) {
-			cam->OffsetX.SetValue(x0);
+			cam->OffsetX.SetValue(x0 / this->appliedBinning_);
 		}
 		else {
 			Utility::printLine("ERROR: Final OffsetX not available");
 		}
-		//Apply final offset in y direction
+		//Apply final offset in y direction (in binned pixels)
 		if (cam->OffsetY != NULL && cam->OffsetY.GetAccessMode() == RW) {
-			cam->OffsetY.SetValue(y0);
+			cam->OffsetY.SetValue(y0 / this->appliedBinning_);
 		}
 		else {
 			Utility::printLine("ERROR: OffsetY not available");
@@ -486,6 +833,21 @@ bool CameraController::ConfigureCustomImageSettings() {
 			Utility::printLine("ERROR: Unable to set manual gamma enable to true");
 		}
 
+		// Time stamp chunk with each image, so frames can be matched to SLM writes (see AcquireImageAfter())
+		this->frameTimeStamps_ = false;
+		Spinnaker::GenApi::CBooleanPtr ptrChunkMode = nodeMap.GetNode("ChunkModeActive");
+		if (Spinnaker::GenApi::IsAvailable(ptrChunkMode) && Spinnaker::GenApi::IsWritable(ptrChunkMode)) {
+			ptrChunkMode->SetValue(true);
+			Spinnaker::GenApi::CBooleanPtr ptrChunkEnable = nodeMap.GetNode("ChunkEnable");
+			if (this->SetEnumNode(nodeMap, "ChunkSelector", "Timestamp") && Spinnaker::GenApi::IsAvailable(ptrChunkEnable) && Spinnaker::GenApi::IsWritable(ptrChunkEnable)) {
+				ptrChunkEnable->SetValue(true);
+				this->frameTimeStamps_ = true;
+			}
+		}
+		if (!this->frameTimeStamps_) {
+			Utility::printLine("WARNING: Camera does not time stamp frames, the latest frame is used after each SLM write");
+		}
+
 		if (PrintDeviceInfo() == -1) {
 			Utility::printLine("WARNING: Couldn't display camera information!");
 		}
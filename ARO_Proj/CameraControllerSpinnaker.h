@@ -9,6 +9,8 @@
 #ifdef USE_SPINNAKER
 
 #include <string>
+#include <vector>	// Pool of image views
+#include <mutex>	// Views are released outside the hardware lock
 
 #include "Spinnaker.h"
 #include "SpinGenApi\SpinnakerGenApi.h"
@@ -43,6 +45,19 @@ public:
 	//Image target settings
 	int targetRadius = 5;
 
+	// Time (microseconds) after an SLM write finishes before a frame's exposure may start for AcquireImageAfter() to use it
+	double settleTime = 0;
+
+	// Auto readout, only the target's disc plus a margin is read out (centered on the AOI's center, where the fitness is read) and binned
+	//	once configured the AOI values are those of the readout, with the width & height in binned pixels
+	bool autoReadout = false;		// TRUE -> shrink the readout to the target when configuring the camera
+	int autoReadoutMargin = 2;		// Pixels (unbinned) read out around the target's disc
+	int readoutBinning = 1;			// Pixels binned together in x & y with auto readout (1 -> no binning)
+
+	// Stream buffers when free running, an image view holds its stream buffer until released (see AcquireImageView())
+	int streamBufferCount = 0;							// Number of stream buffers (0 -> the driver's automatic count, otherwise at least 3 with NewestOnly)
+	std::string streamBufferHandling = "NewestOnly";	// StreamBufferHandlingMode entry (NewestOnly, NewestFirst, OldestFirst or OldestFirstOverwrite)
+
 private:
 	//UI/Equipment reference
 	MainDialog* dlg;
@@ -53,6 +68,39 @@ private:
 
 	//Logic control
 	bool isCamCreated = false;
+	bool externalTrigger_ = false;	// TRUE -> exposures on the trigger input, every frame kept in order (see SetExternalTrigger())
+	int bufferedFrames_ = 2;		// Number of stream buffers when triggered
+	bool frameTimeStamps_ = false;	// TRUE -> images carry the time stamp chunk of their exposure start (see AcquireImageAfter())
+	double clockOffset_ = 0;		// Host time (microseconds) less camera time (microseconds), latched when acquisition starts
+	long long rejectedFrames_ = 0;	// Frames dropped by AcquireImageAfter() for being exposed before the SLM settled
+	int appliedBinning_ = 1;		// Binning of the configured readout
+	double lastFrameTime_ = 0;		// Host time (microseconds) the exposure of the last acquired image started
+	std::vector<ImageController*> freeViews_;	// Released image views to reuse (see AcquireImageView())
+	std::mutex viewsMutex_;						// Guards freeViews_
+	long long droppedFramesTaken_ = 0;	// Stream's lost frame count when last taken by TakeDroppedFrames()
+	long long bufferOverrunsTaken_ = 0;	// Stream's buffer underrun count when last taken by TakeBufferOverruns()
+
+	// Latch the camera's clock against the host's, setting clockOffset_
+	// Output: returns false if the camera's clock could not be latched
+	bool LatchClock(INodeMap & nodeMap);
+
+	// Get the increase of a transport layer stream counter since it was last taken
+	// Input: node - name of the counter's node, taken - value of the counter when last taken (set to its current value)
+	// Output: returns the increase, 0 if the counter is not available
+	long long TakeStreamCount(const char * node, long long & taken);
+
+	// Get the next image from the stream whose exposure started at or after a time, setting lastFrameTime_
+	// Input: earliestStart - earliest host time (microseconds) the exposure can have started at, negative for the next image
+	// Output: returns false if acquisition failed, otherwise image is set to the stream's image (to be released back to the stream)
+	bool NextImage(double earliestStart, Spinnaker::ImagePtr & image);
+
+	// Copy a stream image into a new ImageController, converting it to Mono8 only if it is in another format
+	// Output: returns the new image (caller is responsible for deleting it), the stream image is left to be released
+	ImageController* CopyImage(Spinnaker::ImagePtr & image);
+
+	// Set an enumeration node to one of its entries by name
+	// Output: returns false if the node or entry is not available
+	bool SetEnumNode(INodeMap & nodeMap, const char * node, const char * entry);
 public:
 
 	CameraController(MainDialog* dlg_);
@@ -62,6 +110,41 @@ public:
 	bool startCamera();
 	bool saveImage(ImageController * curImage, std::string path);
 	ImageController* AcquireImage();
+	// Acquire the first frame whose exposure started at least settleTime after the given host time, dropping frames exposed earlier
+	// Input: writeTime - host time (microseconds, TimeStampGenerator::HostMicroS()) the SLM write finished, such as SLMController::lastWriteTime
+	// Output: returns the image (caller is responsible for deleting it), NULL if acquisition failed
+	//		without frame time stamps the time a frame was received stands in for its exposure start, so frames received before then are dropped
+	ImageController* AcquireImageAfter(double writeTime);
+	// Acquire the same frame as AcquireImageAfter() in a pooled view, holding the stream's image without copying it (Mono8 images are
+	// not converted) so its stream buffer is held until the view is given back with ReleaseImage() rather than deleted
+	// Input: writeTime - as AcquireImageAfter()
+	// Output: returns the view, NULL if acquisition failed, views must be released before the camera is stopped
+	ImageController* AcquireImageView(double writeTime);
+	// Give back an image when done with it, a view's stream buffer is released to the stream and the view returned to the pool for reuse
+	// and any other image is deleted
+	void ReleaseImage(ImageController * image);
+	// Get an image that can be held on to, a view is copied (then released) and any other image is returned as is
+	// Output: returns an image the caller is responsible for deleting
+	ImageController* KeepImage(ImageController * image);
+	// Get the number of frames dropped by AcquireImageAfter() since the last call, then start counting again
+	long long TakeRejectedFrames();
+	// Get the number of frames the stream lost since the last call (such as for no buffer being free), then start counting again
+	long long TakeDroppedFrames();
+	// Get the number of times a frame arrived with no free stream buffer since the last call, then start counting again
+	long long TakeBufferOverruns();
+	// Get the host time (microseconds, TimeStampGenerator::HostMicroS()) the exposure of the last acquired image started
+	// (the time it was received when the camera does not time stamp frames)
+	double GetLastFrameTime();
+	// Acquire the next frames in the order they were exposed (none skipped), for sequences of triggered exposures
+	// Input: count - number of frames to get, images - array of count to fill, timeoutMs - longest wait for each frame
+	// Output: returns the number of frames acquired (fewer than count if a frame did not arrive in time or acquisition failed),
+	//		images[0 .. returned-1] hold new images (caller is responsible for deleting them)
+	int AcquireSequence(int count, ImageController ** images, int timeoutMs);
+	// Set the camera to expose on its trigger input (such as an SLM's output pulse) rather than freely, to be called while acquisition is stopped
+	// Input: enable - true for triggered exposures, false for free running
+	//		bufferedFrames - frames the acquisition buffer is to hold when triggered (a whole sequence, so none are lost before being read)
+	// Output: returns false if the camera could not be set, takes effect from the next startCamera()
+	bool SetExternalTrigger(bool enable, int bufferedFrames = 2);
 	bool stopCamera();
 	bool shutdownCamera();
 
@@ -83,7 +166,8 @@ public:
 	// [ACCESSOR(S)/MUTATOR(S)]
 	bool GetCenter(int &x, int &y);
 	bool GetFullImage(int &x, int &y);
-
+	// Get the radius of the fitness target in the pixels of acquired images (the target radius scaled down by any binning)
+	int GetFitnessRadius();
 };
 
 #endif
@@ -0,0 +1,121 @@
+////////////////////
+// Checkpoint.cpp - implementation of the checkpoint file writer & reader
+////////////////////
+
+#include "stdafx.h"		// Required in source (also windows.h for MoveFileEx)
+
+#include <fstream>		// reading & writing checkpoint files
+#include <cstring>		// memcpy()
+
+#include "Checkpoint.h"
+#include "Utility.h"	// printLine()
+
+namespace {
+	// File starts with this tag and a version, bumped when the contents change
+	const char CHECKPOINT_TAG[8] = { 'A', 'R', 'O', 'C', 'K', 'P', 'T', '\0' };
+	const uint32_t CHECKPOINT_VERSION = 1;
+
+	// FNV-1a hash of the contents, stored at the end of the file
+	uint64_t checksum(const uint8_t * bytes, size_t size) {
+		uint64_t hash = 0xCBF29CE484222325ull;
+		for (size_t i = 0; i < size; i++) {
+			hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+		}
+		return hash;
+	}
+}
+
+CheckpointWriter::CheckpointWriter(const std::string & algorithm) {
+	this->putBytes(CHECKPOINT_TAG, sizeof(CHECKPOINT_TAG));
+	this->put(CHECKPOINT_VERSION);
+	this->put(uint32_t(algorithm.size()));
+	this->putBytes(algorithm.data(), algorithm.size());
+}
+
+void CheckpointWriter::putBytes(const void * bytes, size_t size) {
+	const uint8_t * start = static_cast<const uint8_t*>(bytes);
+	this->data_.insert(this->data_.end(), start, start + size);
+}
+
+bool CheckpointWriter::commit(const std::string & path) {
+	const uint64_t sum = checksum(this->data_.data(), this->data_.size());
+	const std::string tempPath = path + ".tmp";
+	{
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(this->data_.data()), this->data_.size());
+		file.write(reinterpret_cast<const char*>(&sum), sizeof(sum));
+		file.close();
+		if (!file) {
+			Utility::printLine("ERROR: Failed to write checkpoint file " + tempPath);
+			return false;
+		}
+	}
+	// Replace the previous checkpoint in one step (write through so it is on disk before returning)
+	if (!MoveFileExA(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+		Utility::printLine("ERROR: Failed to replace checkpoint file " + path + " (error " + std::to_string(GetLastError()) + ")");
+		return false;
+	}
+	return true;
+}
+
+CheckpointReader::CheckpointReader() {
+	this->pos_ = 0;
+	this->end_ = 0;
+}
+
+bool CheckpointReader::open(const std::string & path, const std::string & algorithm) {
+	this->data_.clear();
+	this->pos_ = 0;
+	this->end_ = 0;
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file) {
+		return false;
+	}
+	const std::streamoff size = file.tellg();
+	if (size < std::streamoff(sizeof(CHECKPOINT_TAG) + 2 * sizeof(uint32_t) + sizeof(uint64_t))) {
+		Utility::printLine("WARNING: Checkpoint file " + path + " is too short, ignoring it");
+		return false;
+	}
+	this->data_.resize(size_t(size));
+	file.seekg(0);
+	file.read(reinterpret_cast<char*>(this->data_.data()), size);
+	if (!file) {
+		Utility::printLine("WARNING: Failed to read checkpoint file " + path);
+		return false;
+	}
+
+	// Check the contents are whole
+	this->end_ = this->data_.size() - sizeof(uint64_t);
+	uint64_t storedSum;
+	memcpy(&storedSum, &this->data_[this->end_], sizeof(storedSum));
+	if (storedSum != checksum(this->data_.data(), this->end_)) {
+		Utility::printLine("WARNING: Checkpoint file " + path + " is damaged, ignoring it");
+		return false;
+	}
+	// Check the header
+	char tag[sizeof(CHECKPOINT_TAG)];
+	uint32_t version = 0, nameLength = 0;
+	if (!this->getBytes(tag, sizeof(tag)) || memcmp(tag, CHECKPOINT_TAG, sizeof(tag)) != 0 || !this->get(version) || version != CHECKPOINT_VERSION) {
+		Utility::printLine("WARNING: Checkpoint file " + path + " is not a checkpoint of this version, ignoring it");
+		return false;
+	}
+	std::string name;
+	if (this->get(nameLength) && nameLength <= this->end_ - this->pos_) {
+		name.assign(reinterpret_cast<const char*>(&this->data_[this->pos_]), nameLength);
+		this->pos_ += nameLength;
+	}
+	if (name != algorithm) {
+		Utility::printLine("WARNING: Checkpoint file " + path + " is from " + name + " rather than " + algorithm + ", ignoring it");
+		return false;
+	}
+	return true;
+}
+
+bool CheckpointReader::getBytes(void * bytes, size_t size) {
+	if (size > this->end_ - this->pos_) {
+		return false;
+	}
+	memcpy(bytes, &this->data_[this->pos_], size);
+	this->pos_ += size;
+	return true;
+}
@@ -0,0 +1,71 @@
+////////////////////
+// Checkpoint.h - compact binary checkpoint files so an optimization can be resumed after a process or hardware fault
+//		A checkpoint is built in memory by CheckpointWriter, written to a temporary file then moved over the previous checkpoint in one step,
+//		so a fault while writing leaves the previous checkpoint whole. Files end with a checksum of their contents, CheckpointReader refuses
+//		files that are torn, from another algorithm or from another checkpoint version
+////////////////////
+
+#ifndef CHECKPOINT_H_
+#define CHECKPOINT_H_
+
+#include <string>	// file paths & algorithm name
+#include <vector>	// checkpoint contents
+#include <cstdint>	// uint8_t contents, uint64_t checksum
+#include <cstddef>	// size_t
+
+class CheckpointWriter {
+private:
+	std::vector<uint8_t> data_;
+
+public:
+	// Constructor, starts the checkpoint with its header
+	// Input: algorithm - name of the algorithm writing the checkpoint (such as "SGA"), checked when it is read back
+	CheckpointWriter(const std::string & algorithm);
+
+	// Append raw bytes to the checkpoint
+	void putBytes(const void * bytes, size_t size);
+
+	// Append a value (plain data only, such as int, double or uint64_t)
+	template <typename T>
+	void put(const T & value) {
+		this->putBytes(&value, sizeof(T));
+	}
+
+	// Write the checkpoint to a file, replacing any previous checkpoint only once the new one is fully written
+	// Input: path - the checkpoint file
+	// Output: returns false if the file could not be written (the previous checkpoint is left as it was)
+	bool commit(const std::string & path);
+};
+
+class CheckpointReader {
+private:
+	std::vector<uint8_t> data_;
+	size_t pos_;	// Position of the next byte to read
+	size_t end_;	// End of the contents (start of the checksum)
+
+public:
+	CheckpointReader();
+
+	// Load & check a checkpoint file
+	// Input: path - the checkpoint file, algorithm - name of the algorithm reading it (must match the writer's)
+	// Output: returns false if there is no file or it is not a whole checkpoint of this algorithm, otherwise values can be read with get()
+	bool open(const std::string & path, const std::string & algorithm);
+
+	// Read raw bytes from the checkpoint
+	// Output: returns false if the checkpoint does not have size bytes left (bytes is left untouched)
+	bool getBytes(void * bytes, size_t size);
+
+	// Read a value written with CheckpointWriter::put()
+	// Output: returns false if the checkpoint does not have the value left
+	template <typename T>
+	bool get(T & value) {
+		return this->getBytes(&value, sizeof(T));
+	}
+
+	// Check every value in the checkpoint was read
+	bool finished() const {
+		return this->pos_ == this->end_;
+	}
+};
+
+#endif
@@ -0,0 +1,152 @@
+////////////////////
+// CrossoverKernel.h - uniform crossover and mutation kernels used by Population::Crossover()
+//		Parent choice for each gene comes from the bits of bulk random words instead of one RNG call per gene,
+//		8-bit genomes are blended with SSE2 (scalar fallback for other genome types or targets without SSE2)
+//		and mutations (full resets or small perturbations) are placed with geometric skip sampling rather than a random test at every gene
+////////////////////
+
+#ifndef CROSSOVER_KERNEL_H_
+#define CROSSOVER_KERNEL_H_
+
+#include <cstdint>	// uint8_t, uint32_t, uint64_t
+#include <cmath>	// log() for geometric skip sampling
+
+#include "BetterRandom.h"
+
+// SSE2 is always available for x64 builds, so it is used without any runtime check
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define CROSSOVER_USE_SSE2
+#endif
+
+#ifdef CROSSOVER_USE_SSE2
+	#include <emmintrin.h>
+#endif
+
+namespace CrossoverKernel {
+	// Number of random words drawn from the RNG at a time when building parent masks
+	const int WORD_BATCH = 64;
+
+	// Scalar blend of a run of genes using the bits of a mask word
+	// Input: a, b - parent genomes, child - output genome, count - number of genes (at most 32), mask - bit i set selects a[i]
+	// Output: child[0..count) filled
+	template <typename T>
+	inline void blendScalar(const T * a, const T * b, T * child, int count, uint32_t mask) {
+		for (int i = 0; i < count; i++) {
+			child[i] = ((mask >> i) & 1u) ? a[i] : b[i];
+		}
+	}
+
+#ifdef CROSSOVER_USE_SSE2
+	// Expand 16 mask bits into a 16 byte select mask (byte i is 0xFF if bit i is set)
+	inline __m128i expandMask16(uint32_t bits) {
+		const __m128i bitSelect = _mm_set_epi8(-128, 64, 32, 16, 8, 4, 2, 1, -128, 64, 32, 16, 8, 4, 2, 1);
+		const uint64_t lo = uint64_t(bits & 0xFFu) * 0x0101010101010101ull;
+		const uint64_t hi = uint64_t((bits >> 8) & 0xFFu) * 0x0101010101010101ull;
+		const __m128i spread = _mm_set_epi64x((long long)hi, (long long)lo);
+		return _mm_cmpeq_epi8(_mm_and_si128(spread, bitSelect), bitSelect);
+	}
+#endif
+
+	// Blend one run of up to 32 genes using the bits of a mask word, building block for kernels that blend several children at once
+	// Input: a, b - parent genomes, child - output genome, count - number of genes (at most 32), mask - bit i set selects a[i]
+	// Output: child[0..count) filled
+	template <typename T>
+	inline void blendWord(const T * a, const T * b, T * child, int count, uint32_t mask) {
+		blendScalar(a, b, child, count, mask);
+	}
+
+	// 8-bit genome version of blendWord(), full runs of 32 genes use SSE2
+	inline void blendWord(const uint8_t * a, const uint8_t * b, uint8_t * child, int count, uint32_t mask) {
+#ifdef CROSSOVER_USE_SSE2
+		if (count == 32) {
+			for (int half = 0; half < 2; half++) {
+				const __m128i va = _mm_loadu_si128((const __m128i*)(a + half * 16));
+				const __m128i vb = _mm_loadu_si128((const __m128i*)(b + half * 16));
+				const __m128i sel = expandMask16(mask >> (half * 16));
+				_mm_storeu_si128((__m128i*)(child + half * 16), _mm_or_si128(_mm_and_si128(sel, va), _mm_andnot_si128(sel, vb)));
+			}
+			return;
+		}
+#endif
+		blendScalar(a, b, child, count, mask);
+	}
+
+	// Uniform crossover of two parent genomes, each gene has a 50% chance of coming from either parent
+	// Each run of 32 genes is blended with blendWord(), so 8-bit genomes get the SSE2 select
+	// Input: a, b - parent genomes, child - output genome (must not overlap a or b), length - genome length, rng - random source
+	// Output: child is filled
+	template <typename T>
+	void blend(const T * a, const T * b, T * child, int length, BetterRandom * rng) {
+		uint32_t words[WORD_BATCH];
+		int i = 0;
+		while (i < length) {
+			const int batchGenes = (length - i < WORD_BATCH * 32) ? (length - i) : (WORD_BATCH * 32);
+			rng->fill(words, (batchGenes + 31) / 32);
+			for (int w = 0; w * 32 < batchGenes; w++) {
+				const int count = (batchGenes - w * 32 < 32) ? (batchGenes - w * 32) : 32;
+				blendWord(a + i + w * 32, b + i + w * 32, child + i + w * 32, count, words[w]);
+			}
+			i += batchGenes;
+		}
+	}
+
+	// Apply mutation to a genome, each gene independently has rate chance of being replaced by a random 0-255 value
+	// Rather than testing every gene, the gap to the next mutated gene is drawn from the geometric distribution
+	// Input: child - genome to mutate, length - genome length, rate - per gene mutation probability, rng - random source
+	// Output: child has its mutated genes replaced
+	template <typename T>
+	void mutate(T * child, int length, double rate, BetterRandom * rng) {
+		if (rate <= 0) {
+			return;
+		}
+		if (rate >= 1) {
+			for (int i = 0; i < length; i++) {
+				child[i] = T(rng->nextWord() & 0xFFu);
+			}
+			return;
+		}
+		const double logKeep = log(1.0 - rate);
+		double pos = -1;
+		while (true) {
+			// u in (0, 1], so log(u) is finite
+			const double u = 1.0 - rng->uniform();
+			pos += 1.0 + floor(log(u) / logKeep);
+			if (pos >= length) {
+				break;
+			}
+			child[int(pos)] = T(rng->nextWord() & 0xFFu);
+		}
+	}
+
+	// Perturb genes of a child by small phase steps, placed the same way as mutate()
+	// Input: child - genome to perturb, length - genome length, rate - per gene perturbation probability, step - largest change (1 to 128), rng - random source
+	// Output: each perturbed gene is moved by 1 to step (either direction), wrapping around as the genes are 8-bit phases
+	template <typename T>
+	void perturb(T * child, int length, double rate, int step, BetterRandom * rng) {
+		if (rate <= 0) {
+			return;
+		}
+		step = (step < 1) ? 1 : ((step > 128) ? 128 : step);
+		const double logKeep = (rate < 1) ? log(1.0 - rate) : 0;
+		double pos = -1;
+		while (true) {
+			if (rate < 1) {
+				const double u = 1.0 - rng->uniform();
+				pos += 1.0 + floor(log(u) / logKeep);
+			}
+			else {
+				pos += 1.0;
+			}
+			if (pos >= length) {
+				break;
+			}
+			// Low bit picks the direction, the rest the size of the change
+			const uint32_t word = rng->nextWord();
+			const int change = 1 + int((uint64_t(word >> 1) * uint64_t(step)) >> 31);
+			const int gene = int(child[int(pos)]) + ((word & 1u) ? change : -change);
+			child[int(pos)] = T(gene & 0xFF);
+		}
+	}
+};
+
+#endif
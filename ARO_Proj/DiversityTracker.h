@@ -0,0 +1,102 @@
+////////////////////
+// DiversityTracker.h - incremental diversity tracking for a population's genomes
+//		Each genome slot in the population's arena has a sketch, the genome's values at a fixed set of sampled positions
+//		Sketches are updated when a genome is created, so convergence & diversity can be found without reading genome memory
+//		The fraction of sampled positions that match between two sketches estimates how similar the full genomes are
+////////////////////
+
+#ifndef DIVERSITY_TRACKER_H_
+#define DIVERSITY_TRACKER_H_
+
+#include <cstring>	// memcpy() & memcmp()
+
+#include "BetterRandom.h"
+
+template <class T>
+class DiversityTracker {
+private:
+	int slot_count_;		// Number of genome slots being tracked
+	int sample_count_;		// Number of positions sampled in each genome (size of a sketch)
+	int * positions_;		// Sampled genome positions (ascending)
+	T * sketches_;			// slot_count_ sketches of sample_count_ values each
+
+public:
+	// Largest number of positions sampled per genome
+	static const int MAX_SAMPLES = 256;
+
+	// Constructor
+	// Input:
+	//	genome_length - number of genes in each genome
+	//	slot_count - number of genomes being tracked (such as the number of slots in the genome arena)
+	//	seed - seed used to pick the sampled positions
+	DiversityTracker(int genome_length, int slot_count, uint64_t seed) {
+		this->slot_count_ = slot_count;
+		this->sample_count_ = (genome_length < MAX_SAMPLES) ? genome_length : MAX_SAMPLES;
+		this->positions_ = new int[this->sample_count_];
+		this->sketches_ = new T[size_t(this->slot_count_) * this->sample_count_];
+		memset(this->sketches_, 0, sizeof(T) * size_t(this->slot_count_) * this->sample_count_);
+
+		// One position picked at random from each of sample_count_ equal strides, so the whole genome is covered
+		BetterRandom rng(seed, ~uint64_t(0));
+		for (int i = 0; i < this->sample_count_; i++) {
+			const int strideStart = int((int64_t(i) * genome_length) / this->sample_count_);
+			const int strideEnd = int((int64_t(i + 1) * genome_length) / this->sample_count_);
+			this->positions_[i] = strideStart + int((uint64_t(rng.nextWord()) * uint64_t(strideEnd - strideStart)) >> 32);
+		}
+	}
+
+	~DiversityTracker() {
+		delete[] this->positions_;
+		delete[] this->sketches_;
+	}
+
+	// Update the sketch of a slot, to be called whenever the genome in that slot is written
+	// Input: slot - index of the genome slot, genome - the genome now in that slot
+	void update(int slot, const T * genome) {
+		T * sketch = this->sketches_ + size_t(slot) * this->sample_count_;
+		for (int i = 0; i < this->sample_count_; i++) {
+			sketch[i] = genome[this->positions_[i]];
+		}
+	}
+
+	// Copy the sketch of one slot to another, for when a genome is copied as is
+	void copy(int toSlot, int fromSlot) {
+		memcpy(this->sketches_ + size_t(toSlot) * this->sample_count_, this->sketches_ + size_t(fromSlot) * this->sample_count_, sizeof(T) * this->sample_count_);
+	}
+
+	// Estimate the fraction of genes two genomes share
+	// Input: slotA, slotB - slots of the genomes to compare
+	// Output: fraction (0 to 1) of sampled positions that are equal
+	double similarity(int slotA, int slotB) const {
+		const T * a = this->sketches_ + size_t(slotA) * this->sample_count_;
+		const T * b = this->sketches_ + size_t(slotB) * this->sample_count_;
+		int same = 0;
+		for (int i = 0; i < this->sample_count_; i++) {
+			same += (a[i] == b[i]);
+		}
+		return double(same) / this->sample_count_;
+	}
+
+	// Measure a group of genomes against a reference genome (such as the best)
+	// Input:
+	//	slots - the slots of the genomes to measure, count - number of slots
+	//	referenceSlot - slot of the genome to compare against
+	//	accepted_similarity - fraction of genes that must be shared to count as the same
+	//	diversity - set to the mean fraction of sampled genes that differ from the reference (0 when all are identical)
+	// Output: returns true if every genome is at least accepted_similarity similar to the reference (the group has converged)
+	bool measure(const int * slots, int count, int referenceSlot, double accepted_similarity, double & diversity) const {
+		bool converged = true;
+		double differenceSum = 0;
+		for (int i = 0; i < count; i++) {
+			const double sim = this->similarity(slots[i], referenceSlot);
+			differenceSum += 1 - sim;
+			if (sim < accepted_similarity) {
+				converged = false;
+			}
+		}
+		diversity = (count > 0) ? differenceSum / count : 0;
+		return converged;
+	}
+};
+
+#endif
@@ -0,0 +1,179 @@
+////////////////////
+// FitnessMemo.h - table of measured fitness by genome, so repeated genomes can be served without another hardware evaluation
+//		Entries are keyed by a 64-bit hash of the genomes (one per board) and hold the running mean & variance of the measurements, their count and
+//		the generation of the latest one. A genome is served from the table only while the standard error of its mean is small and its latest
+//		measurement is recent, otherwise it is measured again and the measurement added (so a single noisy frame is never trusted for long)
+//		The table is split in stripes each with their own lock, so evaluating threads rarely wait on each other
+////////////////////
+
+#ifndef FITNESS_MEMO_H_
+#define FITNESS_MEMO_H_
+
+#include <unordered_map>	// entries of each stripe
+#include <mutex>			// lock of each stripe
+#include <cstring>			// memcpy() for reading genome words
+#include <cstdint>			// uint64_t hashes
+#include <atomic>			// lookup & hit counters
+
+class FitnessMemo {
+private:
+	// Measurements of one genome
+	struct Entry {
+		double mean;		// Mean of the measurements
+		double m2;			// Sum of squared differences from the mean (Welford), variance is m2 / (count - 1)
+		int count;			// Number of measurements
+		int generation;		// Generation of the latest measurement
+	};
+
+	// A part of the table with its own lock
+	struct Stripe {
+		std::mutex mutex;
+		std::unordered_map<uint64_t, Entry> entries;
+	};
+
+	static const int STRIPE_COUNT = 16;
+	Stripe stripes_[STRIPE_COUNT];
+
+	int max_age_;			// Generations a measurement can be served for
+	double max_error_;		// Largest standard error of the mean (relative to the mean) that can be served
+
+	// Noise pooled over every genome measured more than once, used for genomes measured once
+	std::mutex pooled_mutex_;
+	double pooled_m2_;		// Sum of every entry's m2 increments
+	int pooled_dof_;		// Degrees of freedom of pooled_m2_ (sum of count - 1)
+	std::atomic<uint64_t> lookups_, hits_;	// Lookups made & how many were served, for logs
+
+	Stripe & stripeOf(uint64_t hash) {
+		return this->stripes_[hash >> 60];
+	}
+
+	// Get the noise variance of single measurements, pooled over the table (negative if not yet known)
+	double pooledVariance() {
+		std::unique_lock<std::mutex> lock(this->pooled_mutex_);
+		return (this->pooled_dof_ > 0) ? this->pooled_m2_ / this->pooled_dof_ : -1;
+	}
+
+public:
+	// Constructor
+	// Input:
+	//	maxAge - generations a measurement can be served for before measuring again (default 10)
+	//	maxError - largest standard error of the mean, relative to the mean, that can be served (default 2%)
+	FitnessMemo(int maxAge = 10, double maxError = 0.02) {
+		this->max_age_ = maxAge;
+		this->max_error_ = maxError;
+		this->pooled_m2_ = 0;
+		this->pooled_dof_ = 0;
+		this->lookups_ = 0;
+		this->hits_ = 0;
+	}
+
+	// Hash the genomes of an individual (one genome per board)
+	// Input: genomes - array of genomeCount genomes, genomeCount - number of genomes, genomeLength - genes in each genome
+	// Output: returns 64-bit hash of the genomes
+	static uint64_t hashGenomes(const uint8_t * const * genomes, int genomeCount, int genomeLength) {
+		uint64_t h = 0x243F6A8885A308D3ull ^ uint64_t(genomeLength);
+		for (int b = 0; b < genomeCount; b++) {
+			const uint8_t * genome = genomes[b];
+			int i = 0;
+			for (; i + 8 <= genomeLength; i += 8) {
+				uint64_t word;
+				memcpy(&word, genome + i, 8);
+				h = (h ^ word) * 0x9E3779B97F4A7C15ull;
+				h ^= h >> 29;
+			}
+			uint64_t tail = 0;
+			memcpy(&tail, genome + i, genomeLength - i);
+			h = (h ^ tail ^ (uint64_t(b) << 56)) * 0x9E3779B97F4A7C15ull;
+			h ^= h >> 29;
+		}
+		// Final mix so all bits (the stripe uses the top ones) depend on every gene
+		h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+		h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+		return h ^ (h >> 31);
+	}
+
+	// Look up a genome, to be called before evaluating it (thread safe)
+	// Input: hash - from hashGenomes(), generation - the current generation
+	// Output: returns true if the fitness can be served (fitness is set to the mean of the measurements), false if it is to be measured
+	bool lookup(uint64_t hash, int generation, double & fitness) {
+		const double noise = this->pooledVariance();
+		Stripe & stripe = this->stripeOf(hash);
+		std::unique_lock<std::mutex> lock(stripe.mutex);
+		this->lookups_++;
+		std::unordered_map<uint64_t, Entry>::const_iterator it = stripe.entries.find(hash);
+		if (it == stripe.entries.end()) {
+			return false;
+		}
+		const Entry & entry = it->second;
+		if (generation - entry.generation > this->max_age_) {
+			return false;
+		}
+		// Genomes measured once use the pooled noise, if it isn't known yet they are measured again
+		const double variance = (entry.count > 1) ? entry.m2 / (entry.count - 1) : noise;
+		if (variance < 0) {
+			return false;
+		}
+		const double limit = this->max_error_ * (entry.mean < 0 ? -entry.mean : entry.mean);
+		if (variance / entry.count > limit * limit) {
+			return false;
+		}
+		fitness = entry.mean;
+		this->hits_++;
+		return true;
+	}
+
+	// Add a measurement of a genome, to be called after evaluating it (thread safe)
+	// Input: hash - from hashGenomes(), fitness - the measured fitness, generation - the current generation
+	// Output: returns the mean of the genome's measurements (to be used as its fitness)
+	double record(uint64_t hash, double fitness, int generation) {
+		Stripe & stripe = this->stripeOf(hash);
+		std::unique_lock<std::mutex> lock(stripe.mutex);
+		Entry & entry = stripe.entries[hash];
+		// New genomes and those last measured too long ago start over
+		if (entry.count == 0 || generation - entry.generation > this->max_age_) {
+			entry.mean = fitness;
+			entry.m2 = 0;
+			entry.count = 1;
+			entry.generation = generation;
+			return fitness;
+		}
+		entry.count++;
+		const double delta = fitness - entry.mean;
+		entry.mean += delta / entry.count;
+		const double m2Increment = delta * (fitness - entry.mean);
+		entry.m2 += m2Increment;
+		entry.generation = generation;
+		const double mean = entry.mean;
+		lock.unlock();
+
+		std::unique_lock<std::mutex> pooledLock(this->pooled_mutex_);
+		this->pooled_m2_ += m2Increment;
+		this->pooled_dof_++;
+		return mean;
+	}
+
+	// Remove entries too old to be served, to be called once a generation
+	// Input: generation - the current generation
+	void prune(int generation) {
+		for (int s = 0; s < STRIPE_COUNT; s++) {
+			std::unique_lock<std::mutex> lock(this->stripes_[s].mutex);
+			std::unordered_map<uint64_t, Entry> & entries = this->stripes_[s].entries;
+			for (std::unordered_map<uint64_t, Entry>::iterator it = entries.begin(); it != entries.end();) {
+				if (generation - it->second.generation > this->max_age_) {
+					it = entries.erase(it);
+				}
+				else {
+					++it;
+				}
+			}
+		}
+	}
+
+	// Get how many lookups were made & how many were served from the table
+	void getCounts(uint64_t & lookups, uint64_t & hits) const {
+		lookups = this->lookups_;
+		hits = this->hits_;
+	}
+};
+
+#endif
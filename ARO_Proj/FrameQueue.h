@@ -0,0 +1,75 @@
+////////////////////
+// FrameQueue.h - lock-free single-producer single-consumer ring of frames
+//		Used to hand readouts from the camera SDK's acquisition callback thread (the producer) to the thread acquiring images (the consumer)
+//		without either taking a lock or making an SDK call. The producer only writes tail_ and the consumer only writes head_, each slot
+//		is published by the release store of the index that passes it
+//		Only one thread may push and one thread pop at a time (the optimizations acquire images under their hardware lock)
+////////////////////
+
+#ifndef FRAME_QUEUE_H_
+#define FRAME_QUEUE_H_
+
+#include <atomic>	// head & tail indices
+#include <vector>	// slots
+#include <cstddef>	// size_t
+
+template <typename T>
+class FrameQueue {
+private:
+	std::vector<T> slots_;			// One more slot than the capacity, so a full ring can be told apart from an empty one
+	std::atomic<size_t> head_;		// Next slot to pop (written by the consumer)
+	std::atomic<size_t> tail_;		// Next slot to push (written by the producer)
+
+	size_t next(size_t index) {
+		return (index + 1 == this->slots_.size()) ? 0 : index + 1;
+	}
+
+public:
+	// Constructor
+	// Input: capacity - most items the queue holds
+	FrameQueue(int capacity = 2) {
+		this->head_ = 0;
+		this->tail_ = 0;
+		this->reset(capacity);
+	}
+
+	// Empty the queue and set its capacity, only while neither thread is using it
+	// Input: capacity - most items the queue holds
+	void reset(int capacity) {
+		this->slots_.assign(size_t((capacity > 1) ? capacity : 1) + 1, T());
+		this->head_.store(0, std::memory_order_relaxed);
+		this->tail_.store(0, std::memory_order_release);
+	}
+
+	// Add an item (producer only)
+	// Output: returns false if the queue is full (the item is not added)
+	bool push(const T & item) {
+		const size_t tail = this->tail_.load(std::memory_order_relaxed);
+		const size_t nextTail = this->next(tail);
+		if (nextTail == this->head_.load(std::memory_order_acquire)) {
+			return false;
+		}
+		this->slots_[tail] = item;
+		this->tail_.store(nextTail, std::memory_order_release);
+		return true;
+	}
+
+	// Take the oldest item (consumer only)
+	// Output: returns false if the queue is empty, otherwise item is set to the oldest item
+	bool pop(T & item) {
+		const size_t head = this->head_.load(std::memory_order_relaxed);
+		if (head == this->tail_.load(std::memory_order_acquire)) {
+			return false;
+		}
+		item = this->slots_[head];
+		this->head_.store(this->next(head), std::memory_order_release);
+		return true;
+	}
+
+	// Returns true if there is nothing to pop (consumer only, the producer may add an item straight after)
+	bool empty() {
+		return this->head_.load(std::memory_order_relaxed) == this->tail_.load(std::memory_order_acquire);
+	}
+};
+
+#endif
@@ -32,6 +32,26 @@ BOOL GA_ControlDialog::OnInitDialog() {
 	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_SKIP_ELITE_CHECK), L"Skip individuals in a pool that already have a determined fitness");
 	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_THREAD_COUNT_IND), L"Set number of threads used to evaluate individuals");
 	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_THREAD_COUNT_GA), L"Set number of threads for generating next generation (divided across number of SLMs)");
+	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_RUN_SEED), L"Seed for the random numbers of the GA, rerunning with the same seed and thread counts repeats the run (0 picks a random seed)");
+	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_ISLAND_COUNT), L"Number of independent islands to breed, each island is evaluated in turn while the others breed (1 indicates a single population)");
+	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_MIGRATION_INTERVAL), L"Generations between copying each island's best individual over the worst of the next island (0 indicates no migration)");
+	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_ISLAND_SPREAD), L"Mutation rate multiplier between neighbouring islands, spreading the islands around the default mutation rate");
+	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_STEADY_STATE_CHECK), L"Replace the worst individual with each child as soon as it is evaluated, breeding ahead so the hardware never waits (uses a single island)");
+	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_SPECULATIVE_CHECK), L"Start breeding the next generation while the last individuals are on the hardware, correcting the children their fitness changes (SGA, multithreaded, single island)");
+	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_SCREENING_CANDIDATES), L"Number of candidates bred for each child, only the one a surrogate model of the fitness scores best is evaluated (SGA, 1 indicates no prescreening)");
+	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_FITNESS_MEMO_CHECK), L"Keep measured fitness by genome so repeated genomes are not evaluated on the hardware again while their measurements are recent and consistent");
+	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_ADAPTIVE_MUTATION_CHECK), L"Let each genome carry its own mutation rate (and step) inherited with a random change, so selection keeps the rates breeding the fittest children (also turns on mutation for the uGA)");
+	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_MUTATION_STEP), L"Largest phase change either way of a mutated gene (0 indicates mutated genes are replaced with a random value)");
+	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_CHECKPOINT_INTERVAL), L"Generations between checkpoints of the run written to the output folder (0 indicates no checkpoints)");
+	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_RESUME_CHECK), L"Continue from the checkpoint of this algorithm in the output folder if there is one (same settings and boards as the checkpointed run)");
+	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_WARM_START_MASK), L"Mask to start the run from, \"{board}\" in the path is replaced with the board number (empty indicates a random start)");
+	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_SEQUENCE_CHECK), L"Evaluate each generation as one hardware sequence, the SLM writing masks back to back and triggering the camera (generational GA, self tested before the run)");
+	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_SELECTION_TYPE), L"How the SGA selects parents, by fitness (proportionate), by rank of fitness or by tournament");
+	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_TOURNAMENT_SIZE), L"Number of individuals competing in each draw when using tournament selection");
+	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_TILED_BREEDING_CHECK), L"Breed the SGA children tile by tile across the genome so parents are read from memory once per generation");
+	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_SEQUENCE_TRIGGER_CHECK), L"Have each mask of a hardware sequence wait on the SLM trigger input (the camera exposure end) instead of being held for the exposure and hold time");
+	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_SEQUENCE_HOLD_TIME), L"Time (microseconds) each mask of a hardware sequence is held beyond the camera exposure time when not waiting for the trigger");
+	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_SEQUENCE_TIMEOUT), L"Longest wait (milliseconds) for a trigger or frame before a hardware sequence is taken as broken");
 	this->m_mainToolTips->Activate(true);
 
 	return CDialogEx::OnInitDialog();
@@ -54,6 +74,26 @@ void GA_ControlDialog::DoDataExchange(CDataExchange* pDX) {
 	DDX_Control(pDX, IDC_SKIP_ELITE_CHECK, m_skipEliteReevaluation);
 	DDX_Control(pDX, IDC_THREAD_COUNT_IND, m_indEvalThreadCount);
 	DDX_Control(pDX, IDC_THREAD_COUNT_GA, m_PopGenThreadCount);
+	DDX_Control(pDX, IDC_RUN_SEED, m_runSeed);
+	DDX_Control(pDX, IDC_ISLAND_COUNT, m_islandCount);
+	DDX_Control(pDX, IDC_MIGRATION_INTERVAL, m_migrationInterval);
+	DDX_Control(pDX, IDC_ISLAND_SPREAD, m_islandMutationSpread);
+	DDX_Control(pDX, IDC_STEADY_STATE_CHECK, m_steadyState);
+	DDX_Control(pDX, IDC_SPECULATIVE_CHECK, m_speculativeBreeding);
+	DDX_Control(pDX, IDC_SCREENING_CANDIDATES, m_screeningCandidates);
+	DDX_Control(pDX, IDC_FITNESS_MEMO_CHECK, m_useFitnessMemo);
+	DDX_Control(pDX, IDC_ADAPTIVE_MUTATION_CHECK, m_adaptiveMutation);
+	DDX_Control(pDX, IDC_MUTATION_STEP, m_mutationStep);
+	DDX_Control(pDX, IDC_CHECKPOINT_INTERVAL, m_checkpointInterval);
+	DDX_Control(pDX, IDC_RESUME_CHECK, m_resumeFromCheckpoint);
+	DDX_Control(pDX, IDC_WARM_START_MASK, m_warmStartMask);
+	DDX_Control(pDX, IDC_SEQUENCE_CHECK, m_sequenceEvaluation);
+	DDX_Control(pDX, IDC_SELECTION_TYPE, m_selectionType);
+	DDX_Control(pDX, IDC_TOURNAMENT_SIZE, m_tournamentSize);
+	DDX_Control(pDX, IDC_TILED_BREEDING_CHECK, m_tiledBreeding);
+	DDX_Control(pDX, IDC_SEQUENCE_TRIGGER_CHECK, m_sequenceWaitForTrigger);
+	DDX_Control(pDX, IDC_SEQUENCE_HOLD_TIME, m_sequenceHoldTime);
+	DDX_Control(pDX, IDC_SEQUENCE_TIMEOUT, m_sequenceTriggerTimeout);
 }
 
 
@@ -78,6 +118,31 @@ void GA_ControlDialog::setDefaultUI() {
 	CString hardwareThreads = CString(std::to_string(std::thread::hardware_concurrency()).c_str());
 	this->m_indEvalThreadCount.SetWindowTextW(hardwareThreads);
 	this->m_PopGenThreadCount.SetWindowTextW(hardwareThreads);
+	this->m_runSeed.SetWindowTextW(_T("0")); // 0 indicates a random seed
+	this->m_islandCount.SetWindowTextW(_T("1")); // 1 indicates a single population
+	this->m_migrationInterval.SetWindowTextW(_T("20"));
+	this->m_islandMutationSpread.SetWindowTextW(_T("2.0"));
+	this->m_steadyState.SetCheck(BST_UNCHECKED);
+	this->m_speculativeBreeding.SetCheck(BST_UNCHECKED);
+	this->m_screeningCandidates.SetWindowTextW(_T("1")); // 1 indicates no prescreening
+	this->m_useFitnessMemo.SetCheck(BST_UNCHECKED);
+	this->m_adaptiveMutation.SetCheck(BST_UNCHECKED);
+	this->m_mutationStep.SetWindowTextW(_T("0")); // 0 indicates random replacement
+	this->m_checkpointInterval.SetWindowTextW(_T("0")); // 0 indicates no checkpoints
+	this->m_resumeFromCheckpoint.SetCheck(BST_UNCHECKED);
+	this->m_warmStartMask.SetWindowTextW(_T("")); // Empty indicates a random start
+	this->m_sequenceEvaluation.SetCheck(BST_UNCHECKED);
+	// Selection types in the order of SelectionType
+	this->m_selectionType.ResetContent();
+	this->m_selectionType.AddString(_T("Proportionate"));
+	this->m_selectionType.AddString(_T("Rank"));
+	this->m_selectionType.AddString(_T("Tournament"));
+	this->m_selectionType.SetCurSel(0);
+	this->m_tournamentSize.SetWindowTextW(_T("2"));
+	this->m_tiledBreeding.SetCheck(BST_UNCHECKED);
+	this->m_sequenceWaitForTrigger.SetCheck(BST_UNCHECKED);
+	this->m_sequenceHoldTime.SetWindowTextW(_T("0"));
+	this->m_sequenceTriggerTimeout.SetWindowTextW(_T("1000"));
 }
 
 BEGIN_MESSAGE_MAP(GA_ControlDialog, CDialogEx)
@@ -48,4 +48,44 @@ public:
 	CEdit m_indEvalThreadCount;
 	// The number of threads to use for generating pools
 	CEdit m_PopGenThreadCount;
+	// Seed for the GA's random numbers so a run can be reproduced, 0 for a random seed
+	CEdit m_runSeed;
+	// Number of islands (independent populations) to breed, 1 for a single population
+	CEdit m_islandCount;
+	// Generations between migrations of each island's best to the next island
+	CEdit m_migrationInterval;
+	// Mutation rate multiplier between neighbouring islands
+	CEdit m_islandMutationSpread;
+	// If toggled, children replace the worst individual as soon as they are evaluated instead of breeding generations
+	CButton m_steadyState;
+	// If toggled, the next generation starts breeding before the last individuals are evaluated
+	CButton m_speculativeBreeding;
+	// Number of candidates bred for each child and prescreened with the surrogate model, 1 for no prescreening
+	CEdit m_screeningCandidates;
+	// If toggled, repeated genomes are served their measured fitness from the memo instead of the hardware
+	CButton m_useFitnessMemo;
+	// If toggled, each genome carries its own mutation rate that adapts through selection
+	CButton m_adaptiveMutation;
+	// Largest phase change of a mutated gene, 0 to replace mutated genes with a random value
+	CEdit m_mutationStep;
+	// Generations between checkpoints written to the output folder, 0 for no checkpoints
+	CEdit m_checkpointInterval;
+	// If toggled, the run continues from the checkpoint in the output folder
+	CButton m_resumeFromCheckpoint;
+	// Path of a mask to start the populations from, empty for a random start
+	CEdit m_warmStartMask;
+	// If toggled, each generation is evaluated as one hardware sequence triggered by the SLM
+	CButton m_sequenceEvaluation;
+	// How the SGA selects parents (index is the SelectionType)
+	CComboBox m_selectionType;
+	// Number of individuals competing in each draw of tournament selection
+	CEdit m_tournamentSize;
+	// If toggled, the SGA breeds children tile by tile across the genome
+	CButton m_tiledBreeding;
+	// If toggled, each mask of a hardware sequence waits on the SLM trigger input instead of a timed hold
+	CButton m_sequenceWaitForTrigger;
+	// Time (microseconds) each mask of a hardware sequence is held beyond the exposure time
+	CEdit m_sequenceHoldTime;
+	// Longest wait (milliseconds) for a trigger or frame in a hardware sequence
+	CEdit m_sequenceTriggerTimeout;
 };
@@ -5,10 +5,36 @@
 
 #include "stdafx.h"				// Required in source
 #include "GA_Optimization.h"	// Header file
+#include <cmath>				// pow() for island mutation rates
+#include <chrono>				// hold time of masks in a hardware sequence
+#include <limits>				// lowest fitness before the steady-state initial population is evaluated
+#include <cstring>				// memcpy() of genomes in the hardware sequence test
 
 bool GA_Optimization::runOptimization() {
 	Utility::printLine("INFO: Starting " + this->algorithm_name_ + " Optimization!");
 
+	// Getting the GA's settings from the GUI
+	CString optionBuff;
+	this->dlg->m_ga_ControlDlg.m_islandCount.GetWindowTextW(optionBuff);
+	this->islandCount = _tstoi(optionBuff);
+	this->dlg->m_ga_ControlDlg.m_migrationInterval.GetWindowTextW(optionBuff);
+	this->migrationInterval = _tstoi(optionBuff);
+	this->dlg->m_ga_ControlDlg.m_islandMutationSpread.GetWindowTextW(optionBuff);
+	this->islandMutationSpread = _tstof(optionBuff);
+	this->steadyState = (this->dlg->m_ga_ControlDlg.m_steadyState.GetCheck() == BST_CHECKED);
+	this->speculativeBreeding = (this->dlg->m_ga_ControlDlg.m_speculativeBreeding.GetCheck() == BST_CHECKED);
+	this->dlg->m_ga_ControlDlg.m_screeningCandidates.GetWindowTextW(optionBuff);
+	this->screeningCandidates = _tstoi(optionBuff);
+	this->useFitnessMemo = (this->dlg->m_ga_ControlDlg.m_useFitnessMemo.GetCheck() == BST_CHECKED);
+	this->adaptiveMutation = (this->dlg->m_ga_ControlDlg.m_adaptiveMutation.GetCheck() == BST_CHECKED);
+	this->dlg->m_ga_ControlDlg.m_mutationStep.GetWindowTextW(optionBuff);
+	this->mutationStep = _tstof(optionBuff);
+	this->sequenceEvaluation = (this->dlg->m_ga_ControlDlg.m_sequenceEvaluation.GetCheck() == BST_CHECKED);
+	this->sequenceWaitForTrigger = (this->dlg->m_ga_ControlDlg.m_sequenceWaitForTrigger.GetCheck() == BST_CHECKED);
+	this->dlg->m_ga_ControlDlg.m_sequenceHoldTime.GetWindowTextW(optionBuff);
+	this->sequenceHoldTime = _tstoi(optionBuff);
+	this->dlg->m_ga_ControlDlg.m_sequenceTriggerTimeout.GetWindowTextW(optionBuff);
+	this->sequenceTriggerTimeout = _tstoi(optionBuff);
 
 	if (this->multithreadEnable) {
 		Utility::printLine("INFO: The CPU being used has " + std::to_string(std::thread::hardware_concurrency()) + " logical processors");
@@ -21,7 +47,8 @@ bool GA_Optimization::runOptimization() {
 		this->gaPoolThreadCount = _tstoi(tempBuff);
 
 		// If the indThreadCount and gaPoolThreadCount are less than what the hardware supports, than we don't need the additional threads to be created in the pool
-		const int threadPool_size = std::min(int(std::thread::hardware_concurrency()), std::max(this->indThreadCount, this->gaPoolThreadCount));
+		// (the steady-state GA needs a thread for its breeder alongside the evaluating threads)
+		const int threadPool_size = std::min(int(std::thread::hardware_concurrency()), std::max(this->indThreadCount + (this->steadyState ? 1 : 0), this->gaPoolThreadCount));
 		this->myThreadPool_ = new threadPool(threadPool_size);
 
 		Utility::printLine("INFO: Using up to " + std::to_string(threadPool_size) + " threads");
@@ -31,6 +58,16 @@ bool GA_Optimization::runOptimization() {
 		this->gaPoolThreadCount = 1;
 	}
 
+	// Get the run seed, if 0 (or not given) then pick a random one so it can still be recorded and reproduced
+	CString seedBuff;
+	this->dlg->m_ga_ControlDlg.m_runSeed.GetWindowTextW(seedBuff);
+	this->runSeed = _tcstoui64(seedBuff, NULL, 10);
+	if (this->runSeed == 0) {
+		std::random_device rd;
+		this->runSeed = (uint64_t(rd()) << 32) | rd();
+	}
+	Utility::printLine("INFO: Using run seed " + std::to_string(this->runSeed));
+
 	// Setup before optimization (see base class for implementation)
 	if (!prepareSoftwareHardware()) {
 		Utility::printLine("ERROR: Failed to prepare software or/and hardware for " + this->algorithm_name_ + " Optimization");
@@ -41,6 +78,28 @@ bool GA_Optimization::runOptimization() {
 		Utility::printLine("ERROR: Failed to prepare values and files for " + this->algorithm_name_ + " Optimization");
 		return false;
 	}
+	// Hardware-sequenced evaluation has the camera expose on the SLM's output pulse, buffering a whole generation of frames
+	if (this->sequenceEvaluation && this->steadyState) {
+		Utility::printLine("WARNING: Steady-state GA does not use hardware sequences, evaluating individuals one at a time");
+		this->sequenceEvaluation = false;
+	}
+	if (this->sequenceEvaluation && this->sequenceTriggerTimeout <= 0) {
+		Utility::printLine("WARNING: Hardware sequence trigger timeout must be positive, using 1000 ms");
+		this->sequenceTriggerTimeout = 1000;
+	}
+	if (this->sequenceEvaluation) {
+		this->cc->stopCamera();
+		if (this->cc->SetExternalTrigger(true, this->populationSize) && this->cc->startCamera()) {
+			Utility::printLine("INFO: Evaluating each generation as a hardware sequence");
+		}
+		else {
+			Utility::printLine("WARNING: Failed to set the camera to expose on the SLM's pulse, evaluating individuals one at a time");
+			this->sequenceEvaluation = false;
+			this->cc->stopCamera();
+			this->cc->SetExternalTrigger(false);
+			this->cc->startCamera();
+		}
+	}
 
 	// Doubles to track time elapsed during optimization
 	double opt_start, opt_end, generation_start, generation_end, individuals_start, individuals_end, nextGen_start, nextGen_end;
@@ -68,20 +127,80 @@ bool GA_Optimization::runOptimization() {
 				if (this->skipEliteReevaluation == false || (this->skipEliteReevaluation == true && this->population[0]->getFitness(id) == -1)) {
 					this->runIndividual(id);
 				}
+				this->markEvaluated(id);
 			}
 		};
 
+		if (this->islandCount > 1) {
+			Utility::printLine("INFO: Using " + std::to_string(this->islandCount) + " islands, migrating every " + std::to_string(this->migrationInterval) + " generations");
+		}
+		// Continue from the last checkpoint if asked to
+		int startGen = 0;
+		if (this->resumeFromCheckpoint && !this->loadCheckpoint(startGen)) {
+			Utility::printLine("WARNING: No usable checkpoint to resume from, starting from the first generation");
+			startGen = 0;
+		}
 		Utility::printLine("INFO: Beginning optimization loop");
 		this->timestamp = new TimeStampGenerator();		// Starting time stamp to track elapsed time
+		bool hardwareFailed = false;	// Set if the run ends on a critical hardware error (its checkpoint is kept)
+#ifdef USE_MOCK_CAMERA
+		// With the simulated hardware, check hardware sequences before the run (the stage times are reset after)
+		if (this->sequenceEvaluation && !this->testSequence()) {
+			Utility::printLine("ERROR: Hardware sequence self test failed, ending the run");
+			hardwareFailed = true;
+			this->stopConditionsMetFlag = true;
+		}
+#endif
+		// Stage timings are counted from the start of the loop
+		for (int stage = 0; stage < STAGE_COUNT; stage++) {
+			this->stageTimes[stage] = 0;
+		}
+		this->stageEvaluations = 0;
 		opt_start = this->timestamp->MicroS_SinceStart();
 		// Optimization loop for each generation
-		for (this->curr_gen = 0; this->curr_gen < this->maxGenenerations && !this->stopConditionsMetFlag && !this->dlg->stopFlag; this->curr_gen++) {
+		// Island being evaluated this generation (always 0 without the island model), when resuming the island evaluated last is still to be bred
+		int curIsland = (startGen > 0) ? (startGen - 1) % this->islandCount : 0;
+		// (the steady-state GA replaces this loop, see runSteadyState())
+		for (this->curr_gen = startGen; !this->steadyState && this->curr_gen < this->maxGenenerations && !this->stopConditionsMetFlag && !this->dlg->stopFlag; this->curr_gen++) {
 			generation_start = this->timestamp->MicroS_SinceStart();
 			individuals_start = generation_start;
+			// Island model, evaluate the next island in turn while the island evaluated last generation breeds
+			const int breedingIsland = curIsland;
+			const bool islandBreeding = (this->islandCount > 1 && this->curr_gen > 0);
+			if (this->islandCount > 1) {
+				curIsland = this->curr_gen % this->islandCount;
+				this->population = this->islands[curIsland];
+			}
 			// Run each individual, giving them all fitness values as a result of their genome
 
-			if (this->multithreadEnable == true) {
+			if (this->sequenceEvaluation) {
+				// Whole generation as one hardware sequence, while the island evaluated last generation breeds
+				this->speculationStarted = true;
+				if (islandBreeding && this->multithreadEnable) {
+					this->myThreadPool_->pushJob(std::bind(&GA_Optimization::breedIsland, this, breedingIsland));
+				}
+				const bool sequenceOK = this->evaluateSequence();
+				if (islandBreeding) {
+					if (this->multithreadEnable) {
+						this->myThreadPool_->wait();
+					}
+					else {
+						this->breedIsland(breedingIsland);
+					}
+				}
+				if (!sequenceOK) {
+					hardwareFailed = true;
+					break;
+				}
+			}
+			else if (this->multithreadEnable == true) {
 				// Parallel
+				this->evaluatedIDs.clear();
+				this->speculationStarted = !(this->speculativeBreeding && this->islandCount == 1);
+				// Breeding is queued first so it gets a thread before the evaluation jobs (which mostly wait on the hardware)
+				if (islandBreeding) {
+					this->myThreadPool_->pushJob(std::bind(&GA_Optimization::breedIsland, this, breedingIsland));
+				}
 				for (int indID = 0; indID < this->indThreadCount; indID++) {
 					this->myThreadPool_->pushJob(std::bind(evaluateSubGroup, indID));
 				}
@@ -94,6 +213,9 @@ bool GA_Optimization::runOptimization() {
 						this->runIndividual(indID); // Serial
 					}
 				}
+				if (islandBreeding) {
+					this->breedIsland(breedingIsland);
+				}
 			}
 			individuals_end = this->timestamp->MicroS_SinceStart();
 
@@ -102,24 +224,34 @@ bool GA_Optimization::runOptimization() {
 				this->timePerGenFile << this->curr_gen + 1 << "," << individuals_end - individuals_start << ",";
 			}
 			// Perform GA crossover/breeding to produce next generation
+			// (island model breeds alongside evaluation above, so here only migration is done)
 			nextGen_start = this->timestamp->MicroS_SinceStart();
-			for (int popID = 0; popID < this->population.size(); popID++) {
-				this->population[popID]->nextGeneration();
+			if (this->islandCount > 1) {
+				if (this->migrationInterval > 0 && (this->curr_gen + 1) % this->migrationInterval == 0) {
+					this->migrateIslands();
+				}
+			}
+			else {
+				for (int popID = 0; popID < this->population.size(); popID++) {
+					this->population[popID]->nextGeneration();
+				}
 			}
 			nextGen_end = this->timestamp->MicroS_SinceStart();
+			// Best individual of the evaluated populations (with islands the evaluated island has not been bred yet, so the best is not at the last index)
+			const int bestID = (this->islandCount > 1) ? this->population[0]->getBestIndex() : this->populationSize - 1;
 
 			// Record how long it took to generate next generation
 			if (this->logAllFiles || this->saveTimeVSFitness) {
 				this->timePerGenFile << nextGen_end - nextGen_start << ",";
 			}
 
-			// Update displays with best individual now that they are done
-			if (this->displayCamImage) {
+			// Update displays with best individual now that they are done (no best image yet when resumed with the elite not evaluated again)
+			if (this->displayCamImage && this->bestImage != NULL) {
 				this->camDisplay->UpdateDisplay(this->bestImage->getRawData());
 			}
 			if (this->displaySLMImage) {
 				for (int slmID = 0; slmID < this->popCount; slmID++) {
-					this->scalers[slmID]->TranslateImage(this->population[slmID]->getGenome(this->populationSize - 1), this->slmScaledImages[slmID]);
+					this->scalers[slmID]->TranslateImage(this->population[slmID]->getGenome(bestID), this->slmScaledImages[slmID]);
 					this->slmDisplayVector[slmID]->UpdateDisplay(this->slmScaledImages[slmID]);
 				}
 			}
@@ -133,22 +265,78 @@ bool GA_Optimization::runOptimization() {
 			}
 			// Output to the terminal progress to help show progress
 			if (this->curr_gen % 10 == 0) {
-				Utility::printLine("INFO: Finished generation #" + std::to_string(this->curr_gen) + " with a fitness of " + std::to_string(this->population[0]->getFitness(this->populationSize - 1)));
+				Utility::printLine("INFO: Finished generation #" + std::to_string(this->curr_gen) + " with a fitness of " + std::to_string(this->population[0]->getFitness(bestID)));
+				if (this->surrogate != NULL) {
+					Utility::printLine("INFO: Surrogate mean prediction error of " + std::to_string(this->surrogate->getError()));
+				}
+				if (this->adaptiveMutation) {
+					Utility::printLine("INFO: Mutation rate of " + std::to_string(this->population[0]->getMutationRate()) + " (step " + std::to_string(this->population[0]->getMutationStep()) + ") for the first board");
+				}
+				if (this->memo != NULL) {
+					uint64_t lookups, hits;
+					this->memo->getCounts(lookups, hits);
+					Utility::printLine("INFO: Fitness memo has served " + std::to_string(hits) + " of " + std::to_string(lookups) + " evaluations");
+				}
+				const long long rejectedFrames = this->cc->TakeRejectedFrames();
+				if (rejectedFrames > 0) {
+					Utility::printLine("INFO: Dropped " + std::to_string(rejectedFrames) + " camera frames exposed before the SLM settled");
+				}
+				const long long droppedFrames = this->cc->TakeDroppedFrames();
+				const long long bufferOverruns = this->cc->TakeBufferOverruns();
+				if (droppedFrames > 0 || bufferOverruns > 0) {
+					Utility::printLine("INFO: Lost " + std::to_string(droppedFrames) + " camera frames before they were read, acquisition buffer overran " + std::to_string(bufferOverruns) + " times");
+				}
+			}
+			// Drop memo entries too old to be served again
+			if (this->memo != NULL) {
+				this->memo->prune(this->curr_gen);
 			}
 			// Check stop conditions, only assign true if we reached the condition
-			this->stopConditionsMetFlag = stopConditionsReached((this->population[0]->getFitness(this->populationSize - 1)*this->cc->GetExposureRatio()), this->timestamp->S_SinceStart(), this->curr_gen + 1);
+			this->stopConditionsMetFlag = stopConditionsReached((this->population[0]->getFitness(bestID)*this->cc->GetExposureRatio()), this->timestamp->S_SinceStart(), this->curr_gen + 1);
 
 			// Record the time it took to perform this generation, then update start to now (for getting duration next generation)
 			if (this->logAllFiles || this->saveTimeVSFitness) {
 				generation_end = this->timestamp->MicroS_SinceStart();
-				this->timePerGenFile << generation_end - generation_start << std::endl;
+				// Diversity of the bred generation (averaged across populations), 0 means every individual matches the best
+				double diversity = 0, mutationRate = 0, mutationStep = 0;
+				for (int popID = 0; popID < this->population.size(); popID++) {
+					diversity += this->population[popID]->getDiversity();
+					mutationRate += this->population[popID]->getMutationRate();
+					mutationStep += this->population[popID]->getMutationStep();
+				}
+				this->timePerGenFile << generation_end - generation_start << "," << diversity / this->population.size() << "," << mutationRate / this->population.size() << "," << mutationStep / this->population.size();
+				double stageMeans[STAGE_COUNT];
+				this->takeStageTimes(stageMeans);
+				for (int stage = 0; stage < STAGE_COUNT; stage++) {
+					this->timePerGenFile << "," << stageMeans[stage];
+				}
+				this->timePerGenFile << std::endl;
+			}
+			// Checkpoint the bred generation (not when stopped part way through evaluating it)
+			if (this->checkpointInterval > 0 && (this->curr_gen + 1) % this->checkpointInterval == 0 && !this->dlg->stopFlag) {
+				this->saveCheckpoint(this->curr_gen + 1);
 			}
 		} // ... optimization loop
 
+		if (this->steadyState) {
+			if (!this->runSteadyState()) {
+				Utility::printLine("ERROR: Steady-state optimization ended with a critical error");
+				hardwareFailed = true;
+			}
+		}
+		if (this->islandCount > 1) {
+			this->finishIslands(curIsland);
+		}
+		// A finished run is not to be resumed, its checkpoint is only kept when stopped by the user (or ended by an error)
+		if (!this->dlg->stopFlag && !hardwareFailed) {
+			std::remove(this->checkpointPath().c_str());
+		}
+
 		if (this->logAllFiles || this->saveTimeVSFitness) {
 			opt_end = this->timestamp->MicroS_SinceStart();
 			this->timePerGenFile << "\nOverall Time in Microseconds," << opt_end - opt_start << std::endl;
 		}
+		this->deleteStaging();
 
 		// Cleanup & Save resulting instance
 		if (shutdownOptimizationInstance()) {
@@ -157,9 +345,19 @@ bool GA_Optimization::runOptimization() {
 		else {
 			Utility::printLine("WARNING: Failure to properly end optimization instance!");
 		}
+		// Back to free running exposures
+		if (this->sequenceEvaluation) {
+			this->cc->stopCamera();
+			this->cc->SetExternalTrigger(false);
+		}
 	}
 	catch (std::exception &e) {
 		Utility::printLine("ERROR: " + std::string(e.what()));
+		this->deleteStaging();
+		if (this->sequenceEvaluation) {
+			this->cc->stopCamera();
+			this->cc->SetExternalTrigger(false);
+		}
 		return false;
 	}
 
@@ -180,38 +378,177 @@ bool GA_Optimization::runOptimization() {
 //     shortenExposureFlag is set to true if fitness value is high enough
 //     stopConditionsMetFlag is set to true if conditions met
 bool GA_Optimization::runIndividual(int indID) {
-
+	// Gather the individual's genome for each board, assumes there are as many boards as populations
+	std::vector<uint8_t*> genomes(this->popCount);
+	for (int i = 0; i < this->popCount; i++) {
+		genomes[i] = this->population[i]->getGenome(indID);
+	}
+	double fitness;
+	// Serve repeated genomes from the memo when their measurements can be trusted
+	// The elite (last index) is always measured, finishIndividual() needs its image for the best image & elite saves
+	uint64_t genomeHash = 0;
+	if (this->memo != NULL) {
+		genomeHash = FitnessMemo::hashGenomes(genomes.data(), this->popCount, this->population[0]->getGenomeLength());
+		if (indID != this->population[0]->getSize() - 1 && this->memo->lookup(genomeHash, this->curr_gen, fitness)) {
+			for (int popID = 0; popID < this->population.size(); popID++) {
+				this->population[popID]->setFitness(indID, fitness);
+			}
+			return true;
+		}
+	}
+	// Only the image of the elite (or with the steady-state GA, any of its initial population) may be kept by finishIndividual()
+	const bool mayKeep = this->steadyState || indID == (this->population[0]->getSize() - 1);
+	const double keepAbove = mayKeep ? std::numeric_limits<double>::lowest() : std::numeric_limits<double>::max();
 	ImageController * curImage = NULL;
+	if (!this->evaluateGenomes(genomes.data(), keepAbove, fitness, curImage)) {
+		return false;
+	}
+	// Pre end the result for the individual if the stop flag has been raised while waiting
+	if (curImage == NULL) {
+		return true;
+	}
+	this->finishIndividual(indID, fitness, curImage, genomeHash);
+	return true;
+}
+
+// Give an evaluated individual its fitness, saving the elite's images & keeping its camera image as the best image
+// Input: indID - index of the evaluated individual, fitness - its measured fitness, curImage - its camera image (kept as bestImage or released to the camera)
+//		genomeHash - hash of its genomes for the memo (unused without the memo)
+void GA_Optimization::finishIndividual(int indID, double fitness, ImageController * curImage, uint64_t genomeHash) {
+	// Use the mean of every measurement of this genome as its fitness
+	if (this->memo != NULL) {
+		fitness = this->memo->record(genomeHash, fitness, this->curr_gen);
+	}
+	std::unique_lock<std::mutex> scalerLock(this->slmScalersMutex, std::defer_lock);
+
+	//Save elite info of last generation (the steady-state GA saves its elite as each of its generations finishes)
+	if (!this->steadyState && indID == (population[0]->getSize() - 1)) {
+		if ((this->saveEliteImages) && (this->curr_gen % this->saveEliteFrequency == 0)) {
+			// Save Info
+			std::unique_lock<std::mutex> tFileLock(this->tfileMutex, std::defer_lock);
+			tFileLock.lock();
+			this->tfile << this->curr_gen << "," << fitness << std::endl;
+			tFileLock.unlock();
+			// Save camera image
+			std::string curTime = Utility::getCurDateTime(); // Get current time to use as timeStamp
+			this->cc->saveImage(curImage, std::string(this->outputFolder + curTime + "_" + this->algorithm_name_ + "_Gen_" + std::to_string(this->curr_gen + 1) + "_Elite_Camera" + ".bmp"));
+			// Save SLM image(s)
+			scalerLock.lock();
+			for (int popID = 0; popID < this->popCount; popID++) {
+				scalers[popID]->TranslateImage(this->population[popID]->getGenome(this->population[popID]->getSize() - 1), this->slmScaledImages[popID]);
+				cv::Mat m_ary = cv::Mat(this->sc->getBoardWidth(popID), this->sc->getBoardHeight(popID), CV_8UC1, this->slmScaledImages[popID]);
+				cv::imwrite(this->outputFolder + curTime + "_" + this->algorithm_name_ + "_Gen_" + std::to_string(this->curr_gen + 1) + "_Elite_SLM_" + std::to_string(this->optBoards[popID]->board_id) + ".bmp", m_ary);
+			}
+			scalerLock.unlock();
+		}
+	}
+	// Keep the image as the current best, the elite's when breeding generations
+	// The steady-state GA's initial population is unsorted, so there it is the fittest image so far
+	if (this->steadyState || indID == (population[0]->getSize() - 1)) {
+		std::unique_lock<std::mutex> imageLock(this->imageMutex, std::defer_lock);
+		imageLock.lock();
+		if (!this->steadyState || fitness > this->steadyStateBestFitness) {
+			// With islands the image replaces the one of the evaluated island's elite, so each island keeps its own
+			ImageController ** keptImage = &this->bestImage;
+			for (int islandID = 0; this->islandCount > 1 && islandID < this->islandCount; islandID++) {
+				if (this->islands[islandID][0] == this->population[0]) {
+					keptImage = &this->islandBestImages[islandID];
+				}
+			}
+			delete *keptImage;
+			*keptImage = this->cc->KeepImage(curImage);
+			this->bestImage = *keptImage;
+			curImage = this->bestImage;
+			if (this->steadyState) {
+				this->steadyStateBestFitness = fitness;
+			}
+		}
+		imageLock.unlock();
+	}
+
+	// Update fitness for the individuals
+	for (int popID = 0; popID < this->population.size(); popID++) {
+		this->population[popID]->setFitness(indID, fitness);
+	}
+	// If the pointer to current image does not also point to the best image we are safe to release it
+	if (curImage != this->bestImage) {
+		this->cc->ReleaseImage(curImage);
+	}
+}
+
+// Method for evaluating genomes on the hardware, writing them to the SLMs and getting the fitness from the camera image
+// Input: genomes - the genome to write to each board being optimized (popCount genomes)
+//	keepAbove - the image is copied out of the camera's buffer (see CameraController::KeepImage()) while the hardware is held if its fitness is above this
+// Output: returns false if a critical error occurs, true otherwise
+//	image - set to the acquired image (caller is responsible for giving it back with CameraController::ReleaseImage()), NULL if the stop flag was raised before the hardware was used
+//	fitness - set to the image's fitness (scaled by the exposure ratio)
+//     shortenExposureFlag is set to true if fitness value is high enough
+bool GA_Optimization::evaluateGenomes(uint8_t * const * genomes, double keepAbove, double & fitness, ImageController *& image) {
+	image = NULL;
 	// Setting up mutex locks
 	std::unique_lock<std::mutex> consoleLock(this->consoleMutex, std::defer_lock);
 	std::unique_lock<std::mutex> hardwareLock(this->hardwareMutex, std::defer_lock);
-	std::unique_lock<std::mutex> scalerLock(this->slmScalersMutex, std::defer_lock);
+	double times[STAGE_COUNT];
+	double stageStart = this->timestamp->MicroS_SinceStart(), stageEnd;
+
+	// Scale the genomes to fit the SLMs before taking the hardware, into this evaluation's own staging images (scaling only reads the scalers)
+	unsigned char* const* staging = this->acquireStaging();
+	for (int i = 0; i < this->popCount; i++) {
+		this->scalers[i]->TranslateImage(genomes[i], staging[i]); // Translate the vector genome into char array image
+	}
+	stageEnd = this->timestamp->MicroS_SinceStart();
+	times[STAGE_SCALE] = stageEnd - stageStart;
+	stageStart = stageEnd;
 
 	hardwareLock.lock();
+	stageEnd = this->timestamp->MicroS_SinceStart();
+	times[STAGE_HARDWARE_WAIT] = stageEnd - stageStart;
+	stageStart = stageEnd;
 
-	// Pre end the result for the individual if the stop flag has been raised while waiting
+	// Pre end the result if the stop flag has been raised while waiting
 	if (this->dlg->stopFlag == true) {
 		hardwareLock.unlock();
+		this->releaseStaging(staging);
 		return true;
 	}
 
-	// Write translated image to SLM boards, assumes there are as many boards as populations (accessing optBoards)
-	scalerLock.lock(); // Scaler lock as the scaler is closely used with the slm
-	int * genome;
+	// Write scaled images to SLM boards, assumes there are as many boards as populations (accessing optBoards)
 	for (int i = 0; i < this->popCount; i++) {
-		// Scale the individual genome to fit SLMs
-		genome = this->population[i]->getGenome(indID);
-
-		this->scalers[i]->TranslateImage(genome, this->slmScaledImages[i]); // Translate the vector genome into char array image
 		// Write to SLM, getting the board position according to optBoards and correcting to 0 base
-		this->sc->writeImageToBoard(this->optBoards[i]->board_id, this->slmScaledImages[i]);
+		this->sc->writeImageToBoard(this->optBoards[i]->board_id, staging[i]);
 	}
-	scalerLock.unlock();
+	stageEnd = this->timestamp->MicroS_SinceStart();
+	times[STAGE_WRITE] = stageEnd - stageStart;
+	stageStart = stageEnd;
+	this->releaseStaging(staging);
 
-	// Acquire image
-	curImage = this->cc->AcquireImage();
+	// Acquire the first image exposed once the SLMs have settled on the images written, as a view of the camera's buffer
+	// The view is read (and copied out of the buffer if it may be kept) before the hardware is released,
+	// a view the camera has overwritten before it was read is taken as a failed acquisition and acquired again
+	ImageController * curImage = NULL;
+	double rawFitness = 0;
+	for (int attempt = 0; attempt < 3 && curImage == NULL; attempt++) {
+		curImage = this->cc->AcquireImageView(this->sc->lastWriteTime);
+		if (curImage == NULL) {
+			break;
+		}
+		rawFitness = curImage->getTargetAverage(this->cc->GetFitnessRadius());
+		if (!curImage->isValid()) {
+			this->cc->ReleaseImage(curImage);
+			curImage = NULL;
+			consoleLock.lock();
+			Utility::printLine("WARNING: Image view was overwritten before it was read, acquiring the image again");
+			consoleLock.unlock();
+		}
+		else if (rawFitness * this->cc->GetExposureRatio() > keepAbove) {
+			curImage = this->cc->KeepImage(curImage);
+		}
+	}
 
 	hardwareLock.unlock(); // Now done with the hardware
+	stageEnd = this->timestamp->MicroS_SinceStart();
+	times[STAGE_ACQUIRE] = stageEnd - stageStart;
+	stageStart = stageEnd;
 
 	// Giving error and ends early if there is no data
 	if (curImage == NULL) {
@@ -220,8 +557,19 @@ bool GA_Optimization::runIndividual(int indID) {
 		consoleLock.unlock();
 		return false;
 	}
-	// Using the image data from resulting image to determine the fitness by intensity of the image within circle of target radius
-	double fitness = Utility::FindAverageValue(curImage->getRawData(), curImage->getWidth(), curImage->getHeight(), this->cc->targetRadius);
+	fitness = this->scoreImage(genomes, rawFitness);
+	image = curImage;
+	times[STAGE_FITNESS] = this->timestamp->MicroS_SinceStart() - stageStart;
+
+	this->addStageTimes(times, 1);
+	return true;
+}
+
+// Find the fitness of an acquired image, logging it & flagging the exposure to be shortened if the image is too bright
+// Input: genomes - the genomes the image was acquired with (popCount genomes)
+//	rawFitness - the image's intensity within circle of target radius (ImageController::getTargetAverage() of the fitness radius)
+// Output: returns the image's fitness (scaled by the exposure ratio), the surrogate is fitted to it
+double GA_Optimization::scoreImage(uint8_t * const * genomes, double rawFitness) {
 	// Get current exposure setting of camera (relative to initial)
 	double exposureTimesRatio = this->cc->GetExposureRatio();	// needed for proper fitness value across changing exposure time
 
@@ -229,51 +577,818 @@ bool GA_Optimization::runIndividual(int indID) {
 	if (this->logAllFiles || this->saveTimeVSFitness) {
 		std::unique_lock<std::mutex> tVfLock(this->timeVsFitMutex, std::defer_lock);
 		tVfLock.lock();
-		this->timeVsFitnessFile << this->timestamp->MS_SinceStart() << "," << fitness*exposureTimesRatio << "," << this->cc->finalExposureTime << "," << exposureTimesRatio << std::endl;
+		this->timeVsFitnessFile << this->timestamp->MS_SinceStart() << "," << rawFitness*exposureTimesRatio << "," << this->cc->finalExposureTime << "," << exposureTimesRatio << std::endl;
 		tVfLock.unlock();
 	}
-	//Save elite info of last generation
-	if (indID == (population[0]->getSize() - 1)) {
-		if ((this->saveEliteImages) && (this->curr_gen % this->saveEliteFrequency == 0)) {
-			// Save Info
-			std::unique_lock<std::mutex> tFileLock(this->tfileMutex, std::defer_lock);
-			tFileLock.lock();
-			this->tfile << this->curr_gen << "," << fitness*exposureTimesRatio << std::endl;
-			tFileLock.unlock();
-			// Save camera image
-			std::string curTime = Utility::getCurDateTime(); // Get current time to use as timeStamp
-			this->cc->saveImage(curImage, std::string(this->outputFolder + curTime + "_" + this->algorithm_name_ + "_Gen_" + std::to_string(this->curr_gen + 1) + "_Elite_Camera" + ".bmp"));
-			// Save SLM image(s)
-			scalerLock.lock();
-			for (int popID = 0; popID < this->popCount; popID++) {
-				scalers[popID]->TranslateImage(this->population[popID]->getGenome(this->population[popID]->getSize() - 1), this->slmScaledImages[popID]);
-				cv::Mat m_ary = cv::Mat(this->sc->getBoardWidth(popID), this->sc->getBoardHeight(popID), CV_8UC1, this->slmScaledImages[popID]);
-				cv::imwrite(this->outputFolder + curTime + "_" + this->algorithm_name_ + "_Gen_" + std::to_string(this->curr_gen + 1) + "_Elite_SLM_" + std::to_string(this->optBoards[popID]->board_id) + ".bmp", m_ary);
+	// If the fitness value is too high, flag that the exposure needs to be shortened
+	if (rawFitness > this->maxFitnessValue) {
+		std::unique_lock<std::mutex> exposureFlagLock(this->exposureFlagMutex, std::defer_lock);
+		exposureFlagLock.lock();
+		this->shortenExposureFlag = true;
+		exposureFlagLock.unlock();
+	}
+	const double fitness = rawFitness * exposureTimesRatio;
+	// Fit the surrogate to this result
+	if (this->surrogate != NULL) {
+		this->surrogate->update(genomes, fitness);
+	}
+	return fitness;
+}
+
+// Evaluate the individuals of the current generation as one hardware sequence
+// Output: returns false if the sequence could not be completed even when written again (a critical error), true otherwise
+bool GA_Optimization::evaluateSequence() {
+	std::unique_lock<std::mutex> hardwareLock(this->hardwareMutex, std::defer_lock);
+	double times[STAGE_COUNT];
+	for (int stage = 0; stage < STAGE_COUNT; stage++) {
+		times[stage] = 0;
+	}
+	double stageStart = this->timestamp->MicroS_SinceStart(), stageEnd;
+
+	// Individuals to put on the hardware, the rest keep their fitness or are served from the memo
+	std::vector<uint8_t*> genomes(this->popCount);
+	std::vector<int> indIDs;
+	std::vector<uint64_t> genomeHashes;
+	for (int indID = 0; indID < this->populationSize; indID++) {
+		if (this->skipEliteReevaluation == true && this->population[0]->getFitness(indID) != -1) {
+			continue;
+		}
+		uint64_t genomeHash = 0;
+		if (this->memo != NULL) {
+			for (int i = 0; i < this->popCount; i++) {
+				genomes[i] = this->population[i]->getGenome(indID);
+			}
+			genomeHash = FitnessMemo::hashGenomes(genomes.data(), this->popCount, this->population[0]->getGenomeLength());
+			double fitness;
+			// The elite (last index) is always measured, as in runIndividual()
+			if (indID != this->populationSize - 1 && this->memo->lookup(genomeHash, this->curr_gen, fitness)) {
+				for (int popID = 0; popID < this->population.size(); popID++) {
+					this->population[popID]->setFitness(indID, fitness);
+				}
+				continue;
 			}
-			scalerLock.unlock();
 		}
-		// Also save the image as current best regardless
-		std::unique_lock<std::mutex> imageLock(this->imageMutex, std::defer_lock);
-		imageLock.lock();
-		delete this->bestImage;
-		this->bestImage = curImage;
+		indIDs.push_back(indID);
+		genomeHashes.push_back(genomeHash);
+	}
+	const int count = int(indIDs.size());
+	if (count == 0) {
+		return true;
+	}
+
+	// Scale every individual into its own staging set before the sequence starts
+	std::vector<unsigned char* const*> stagings(count);
+	for (int k = 0; k < count; k++) {
+		stagings[k] = this->acquireStaging();
+		for (int i = 0; i < this->popCount; i++) {
+			this->scalers[i]->TranslateImage(this->population[i]->getGenome(indIDs[k]), stagings[k][i]);
+		}
+	}
+	stageEnd = this->timestamp->MicroS_SinceStart();
+	times[STAGE_SCALE] = stageEnd - stageStart;
+	stageStart = stageEnd;
+
+	hardwareLock.lock();
+	stageEnd = this->timestamp->MicroS_SinceStart();
+	times[STAGE_HARDWARE_WAIT] = stageEnd - stageStart;
+	stageStart = stageEnd;
+
+	// Write the masks on the writer thread while reading the frames here, frames come in the order the masks were written
+	std::vector<ImageController*> frames(count, NULL);
+	int acquired = 0;
+	for (int attempt = 0; attempt < 2 && acquired < count && !this->dlg->stopFlag; attempt++) {
+		if (attempt > 0) {
+			Utility::printLine("WARNING: Hardware sequence lost frames after " + std::to_string(acquired) + " of " + std::to_string(count) + " individuals, writing the rest again");
+			// Restarting the camera drops any frames exposed after the lost one
+			this->cc->stopCamera();
+			if (!this->cc->startCamera()) {
+				break;
+			}
+		}
+		std::atomic<bool> stopWriting(false);
+		bool writeFailed = false;
+		double writeTime = 0;
+		std::thread writer(&GA_Optimization::writeSequence, this, &stagings, acquired, &stopWriting, &writeFailed, &writeTime);
+		const int got = this->cc->AcquireSequence(count - acquired, frames.data() + acquired, this->sequenceTriggerTimeout);
+		if (got < count - acquired) {
+			// End the writer, releasing a write waiting on a trigger that is not coming
+			stopWriting = true;
+			this->sc->stopSequence();
+		}
+		writer.join();
+		// Ending the sequence also drops the trigger from the last exposure, so it cannot release the next sequence's second mask early
+		this->sc->stopSequence();
+		if (writeFailed && !this->dlg->stopFlag) {
+			Utility::printLine("WARNING: SLM write failed during hardware sequence: " + std::string(this->sc->blink_sdk->Get_last_error_message()));
+		}
+		acquired += got;
+		times[STAGE_WRITE] += writeTime;
+	}
+	hardwareLock.unlock(); // Now done with the hardware
+	for (int k = 0; k < count; k++) {
+		this->releaseStaging(stagings[k]);
+	}
+	stageEnd = this->timestamp->MicroS_SinceStart();
+	times[STAGE_ACQUIRE] = stageEnd - stageStart;	// (overlaps the writes)
+	stageStart = stageEnd;
+
+	// Score the individuals in the order they were exposed
+	for (int k = 0; k < acquired; k++) {
+		for (int i = 0; i < this->popCount; i++) {
+			genomes[i] = this->population[i]->getGenome(indIDs[k]);
+		}
+		const double fitness = this->scoreImage(genomes.data(), frames[k]->getTargetAverage(this->cc->GetFitnessRadius()));
+		this->finishIndividual(indIDs[k], fitness, frames[k], genomeHashes[k]);
+	}
+	times[STAGE_FITNESS] = this->timestamp->MicroS_SinceStart() - stageStart;
+	this->addStageTimes(times, acquired);
+
+	if (acquired < count && !this->dlg->stopFlag) {
+		Utility::printLine("ERROR: Hardware sequence failed after " + std::to_string(acquired) + " of " + std::to_string(count) + " individuals!");
+		return false;
+	}
+	return true;
+}
+
+// Sequence writer thread, each individual's images are written to the boards in turn with the last board raising the output pulse
+// so the camera exposes once the whole mask is shown, the mask is then held for the exposure (or until the camera's trigger comes back)
+void GA_Optimization::writeSequence(const std::vector<unsigned char* const*> * stagings, int start, std::atomic<bool> * stop, bool * writeFailed, double * writeTime) {
+	*writeFailed = false;
+	*writeTime = 0;
+	const long long holdTime = (long long)(this->cc->finalExposureTime) + this->sequenceHoldTime;
+	for (int k = start; k < int(stagings->size()) && !*stop && !this->dlg->stopFlag; k++) {
+		const double writeStart = this->timestamp->MicroS_SinceStart();
+		for (int i = 0; i < this->popCount; i++) {
+			// After the first mask, the first board waits for the camera to end the last exposure before it changes
+			const bool waitForTrigger = this->sequenceWaitForTrigger && k > start && i == 0;
+			if (!this->sc->writeImageToBoard(this->optBoards[i]->board_id, (*stagings)[k][i], waitForTrigger, i == this->popCount - 1, this->sequenceTriggerTimeout)) {
+				*writeFailed = true;
+				*writeTime += this->timestamp->MicroS_SinceStart() - writeStart;
+				return;
+			}
+		}
+		*writeTime += this->timestamp->MicroS_SinceStart() - writeStart;
+		if (!this->sequenceWaitForTrigger) {
+			std::this_thread::sleep_for(std::chrono::microseconds(holdTime));
+		}
+	}
+}
+
+#ifdef USE_MOCK_CAMERA
+// Check hardware sequences with the simulated camera & boards
+bool GA_Optimization::testSequence() {
+	const int genomeLength = this->population[0]->getGenomeLength();
+	// Keep what the test changes
+	std::vector<std::vector<uint8_t>> keptGenomes(this->popCount);
+	std::vector<double> keptFitness(this->populationSize);
+	for (int popID = 0; popID < this->popCount; popID++) {
+		keptGenomes[popID].resize(size_t(genomeLength) * this->populationSize);
+		for (int indID = 0; indID < this->populationSize; indID++) {
+			memcpy(keptGenomes[popID].data() + size_t(indID) * genomeLength, this->population[popID]->getGenome(indID), genomeLength);
+		}
+	}
+	for (int indID = 0; indID < this->populationSize; indID++) {
+		keptFitness[indID] = this->population[0]->getFitness(indID);
+	}
+	FitnessMemo * keptMemo = this->memo;
+	SurrogateModel * keptSurrogate = this->surrogate;
+	const bool keptSaveElite = this->saveEliteImages, keptLogAll = this->logAllFiles, keptTimeVSFitness = this->saveTimeVSFitness;
+	this->memo = NULL;
+	this->surrogate = NULL;
+	this->saveEliteImages = this->logAllFiles = this->saveTimeVSFitness = false;
+
+	// Distinct uniform genomes, so a frame scored against the wrong individual shows as the wrong fitness
+	for (int indID = 0; indID < this->populationSize; indID++) {
+		const uint8_t value = uint8_t(32 + (indID * 191) / ((this->populationSize > 1) ? this->populationSize - 1 : 1));
+		for (int popID = 0; popID < this->popCount; popID++) {
+			memset(this->population[popID]->getGenome(indID), value, genomeLength);
+			this->population[popID]->setFitness(indID, -1);
+		}
+	}
+	// Lose a frame half way through the sequence when each mask waits on the trigger, without the trigger only a lost last frame
+	// can be told apart (the frames after a lost one would be taken for the masks before them)
+	const int lostFrame = this->sequenceWaitForTrigger ? this->populationSize / 2 : this->populationSize - 1;
+	this->cc->TakeDroppedFrames();
+	this->cc->LoseFrames(lostFrame, 1);
+	const long long writesBefore = this->sc->blink_sdk->getWriteCount();
+	Utility::printLine("INFO: Testing hardware sequences with the simulated camera (frame " + std::to_string(lostFrame + 1) + " will be lost)");
+	bool passed = this->evaluateSequence();
+	if (!passed) {
+		Utility::printLine("ERROR: Hardware sequence test could not complete the sequence");
+	}
+	const long long lostFrames = this->cc->TakeDroppedFrames();
+	const long long extraWrites = this->sc->blink_sdk->getWriteCount() - writesBefore - (long long)(this->populationSize) * this->popCount;
+	if (passed && (lostFrames != 1 || extraWrites <= 0)) {
+		Utility::printLine("ERROR: Hardware sequence test expected the lost frame to be written again (" + std::to_string(lostFrames) + " frames lost, " + std::to_string(extraWrites) + " extra writes)");
+		passed = false;
+	}
+	// Each individual's fitness must be that of the frame of its own mask (the last board raises the pulse the camera exposes on)
+	unsigned char * shown = new unsigned char[this->optBoards[this->popCount - 1]->GetArea()];
+	for (int indID = 0; indID < this->populationSize && passed; indID++) {
+		this->scalers[this->popCount - 1]->TranslateImage(this->population[this->popCount - 1]->getGenome(indID), shown);
+		ImageController * frame = this->cc->SimulateFrame(shown, this->sc->getBoardWidth(this->popCount - 1), this->sc->getBoardHeight(this->popCount - 1));
+		const double expected = frame->getTargetAverage(this->cc->GetFitnessRadius()) * this->cc->GetExposureRatio();
+		this->cc->ReleaseImage(frame);
+		if (std::abs(this->population[0]->getFitness(indID) - expected) > 1e-9) {
+			Utility::printLine("ERROR: Hardware sequence test gave individual " + std::to_string(indID) + " a fitness of " + std::to_string(this->population[0]->getFitness(indID)) + ", expected " + std::to_string(expected));
+			passed = false;
+		}
+	}
+	delete[] shown;
+	if (passed) {
+		Utility::printLine("INFO: Hardware sequence test passed, " + std::to_string(this->populationSize) + " individuals scored in order with the lost frame written again");
+	}
+
+	// Put everything back
+	this->cc->LoseFrames(0, 0);
+	for (int popID = 0; popID < this->popCount; popID++) {
+		for (int indID = 0; indID < this->populationSize; indID++) {
+			memcpy(this->population[popID]->getGenome(indID), keptGenomes[popID].data() + size_t(indID) * genomeLength, genomeLength);
+			this->population[popID]->setFitness(indID, keptFitness[indID]);
+		}
+	}
+	this->memo = keptMemo;
+	this->surrogate = keptSurrogate;
+	this->saveEliteImages = keptSaveElite;
+	this->logAllFiles = keptLogAll;
+	this->saveTimeVSFitness = keptTimeVSFitness;
+	this->shortenExposureFlag = false;
+	std::unique_lock<std::mutex> imageLock(this->imageMutex);
+	delete this->bestImage;
+	this->bestImage = NULL;
+	this->islandBestImages.assign(this->islandCount, NULL);
+	return passed;
+}
+#endif
+
+// Take a set of staging images, a new set is only made when more evaluations are in progress than ever before (at most the evaluator thread count)
+unsigned char* const* GA_Optimization::acquireStaging() {
+	std::unique_lock<std::mutex> stagingLock(this->stagingMutex);
+	if (!this->freeStaging.empty()) {
+		unsigned char* const* staging = this->freeStaging.back();
+		this->freeStaging.pop_back();
+		return staging;
+	}
+	// Each set is its own allocation, so adding to stagingImages never moves a set another evaluation is using
+	unsigned char** images = new unsigned char*[this->popCount];
+	for (int i = 0; i < this->popCount; i++) {
+		images[i] = new unsigned char[this->optBoards[i]->GetArea()];
+		this->scalers[i]->ZeroOutputImage(images[i]);
+	}
+	this->stagingImages.push_back(images);
+	return images;
+}
+
+// Give back a set of staging images
+void GA_Optimization::releaseStaging(unsigned char* const* staging) {
+	std::unique_lock<std::mutex> stagingLock(this->stagingMutex);
+	this->freeStaging.push_back(staging);
+}
+
+// Delete every set of staging images
+void GA_Optimization::deleteStaging() {
+	std::unique_lock<std::mutex> stagingLock(this->stagingMutex);
+	for (int staging = 0; staging < this->stagingImages.size(); staging++) {
+		for (int i = 0; i < this->popCount; i++) {
+			delete[] this->stagingImages[staging][i];
+		}
+		delete[] this->stagingImages[staging];
+	}
+	this->stagingImages.clear();
+	this->freeStaging.clear();
+}
+
+// Add the time spent in each stage by evaluations
+// Input: times - array of STAGE_COUNT (microseconds, totals over the evaluations), evaluations - number of evaluations the times are for
+void GA_Optimization::addStageTimes(const double * times, int evaluations) {
+	std::unique_lock<std::mutex> stagingLock(this->stagingMutex);
+	for (int stage = 0; stage < STAGE_COUNT; stage++) {
+		this->stageTimes[stage] += times[stage];
+	}
+	this->stageEvaluations += evaluations;
+}
+
+// Get the mean time spent in each stage per evaluation since the last call
+int GA_Optimization::takeStageTimes(double * meanTimes) {
+	std::unique_lock<std::mutex> stagingLock(this->stagingMutex);
+	const int evaluations = this->stageEvaluations;
+	for (int stage = 0; stage < STAGE_COUNT; stage++) {
+		meanTimes[stage] = (evaluations > 0) ? this->stageTimes[stage] / evaluations : 0;
+		this->stageTimes[stage] = 0;
+	}
+	this->stageEvaluations = 0;
+	return evaluations;
+}
+
+// Record an individual as evaluated this generation, starting speculative breeding once enough are
+// Input: indID - index of the individual that has its fitness
+void GA_Optimization::markEvaluated(int indID) {
+	std::unique_lock<std::mutex> speculationLock(this->speculationMutex);
+	if (this->speculationStarted) {
+		return;
+	}
+	this->evaluatedIDs.push_back(indID);
+	// Start once indThreadCount individuals are left, each evaluating thread works through its own contiguous block (see evaluateSubGroup)
+	// and they take turns on the hardware, so by then each thread usually only has its last individual left (already in progress)
+	// and the rest of the generation's time is hardware time (a thread behind the others can still have some to start, which is only
+	// less time to breed in, as nextGeneration() corrects any child whose parents' fitness changes)
+	const int startCount = (this->populationSize - this->indThreadCount > 1) ? this->populationSize - this->indThreadCount : 1;
+	if (int(this->evaluatedIDs.size()) < startCount) {
+		return;
+	}
+	this->speculationStarted = true;
+	speculationLock.unlock();
+
+	// Jobs pushed from this job are still waited for by the loop's wait(), the populations breed in these jobs without using the pool themselves
+	const int threadsPerPop = (this->gaPoolThreadCount / this->popCount > 1) ? this->gaPoolThreadCount / this->popCount : 1;
+	for (int popID = 0; popID < this->popCount; popID++) {
+		if (this->population[popID]->prepareSpeculation(this->evaluatedIDs.data(), int(this->evaluatedIDs.size()))) {
+			for (int i = 0; i < threadsPerPop; i++) {
+				this->myThreadPool_->pushJob(std::bind(&Population<uint8_t>::speculateRange, this->population[popID], i, threadsPerPop));
+			}
+		}
+	}
+}
+
+// Create the islands of populations, one population per board being optimized on each island
+bool GA_Optimization::setupPopulations() {
+	if (this->islandCount < 1) {
+		Utility::printLine("WARNING: Island count of " + std::to_string(this->islandCount) + " is invalid, using 1");
+		this->islandCount = 1;
+	}
+	if (this->steadyState && this->islandCount > 1) {
+		Utility::printLine("WARNING: Steady-state GA does not use islands, using 1");
+		this->islandCount = 1;
+	}
+	this->population.clear();
+	this->islands.clear();
+	for (int islandID = 0; islandID < this->islandCount; islandID++) {
+		std::vector<Population<uint8_t>*> islandPops;
+		for (int i = 0; i < this->popCount; i++) {
+			// First island uses the same seeds as a run without islands
+			const uint64_t popSeed = BetterRandom::deriveSeed(this->runSeed, (uint64_t(islandID) << 16) + i + 1);
+			// With islands, each island breeds as a single pool job so its populations do not use the pool themselves
+			Population<uint8_t>* newPop = this->createPopulation(popSeed, this->multithreadEnable && this->islandCount == 1);
+			if (newPop == NULL) {
+				Utility::printLine("ERROR: Failed to create population for island " + std::to_string(islandID));
+				return false;
+			}
+			if (this->islandCount > 1) {
+				// Spread mutation rates around the default, lowest rate on island 0 and highest on the last island
+				newPop->setMutationRate(newPop->getMutationRate() * pow(this->islandMutationSpread, islandID - (this->islandCount - 1) / 2.0));
+			}
+			newPop->setMutationStep(this->mutationStep);
+			newPop->setAdaptiveMutation(this->adaptiveMutation, this->minMutationRate, this->maxMutationRate);
+			islandPops.push_back(newPop);
+		}
+		this->islands.push_back(islandPops);
+	}
+	this->population = this->islands[0];
+	this->islandBestImages.assign(this->islandCount, NULL);
+	if (this->adaptiveMutation) {
+		Utility::printLine("INFO: Using self-adaptive mutation rates");
+	}
+	// Warm start every island's population of a board from the board's saved mask
+	if (!this->warmStartMask.empty()) {
+		std::vector<uint8_t> mask(this->population[0]->getGenomeLength(), 0);
+		for (int i = 0; i < this->popCount; i++) {
+			if (this->loadWarmStart(this->optBoards[i]->board_id - 1, mask.data())) {
+				for (int islandID = 0; islandID < this->islandCount; islandID++) {
+					this->islands[islandID][i]->seedGenome(mask.data(), this->warmStartPerturbRate, this->warmStartPerturbStep);
+				}
+			}
+		}
+	}
+
+	// Surrogate for prescreening children, shared by every island as they are evaluated on the same hardware
+	if (this->screeningCandidates > 1) {
+		this->surrogate = new SurrogateModel(this->popCount, this->population[0]->getGenomeLength());
+		for (int islandID = 0; islandID < this->islandCount; islandID++) {
+			for (int i = 0; i < this->popCount; i++) {
+				this->islands[islandID][i]->setScreening(this->surrogate, i, this->screeningCandidates);
+			}
+		}
+		Utility::printLine("INFO: Prescreening " + std::to_string(this->screeningCandidates) + " candidates for each child with a surrogate model");
+	}
+	// Memo of measured fitness, shared by every island for the same reason
+	if (this->useFitnessMemo) {
+		this->memo = new FitnessMemo(this->memoMaxAge, this->memoMaxError);
+		Utility::printLine("INFO: Serving repeated genomes from a fitness memo (max age " + std::to_string(this->memoMaxAge) + " generations, max error " + std::to_string(this->memoMaxError) + ")");
+	}
+	return true;
+}
+
+// Delete the populations of every island
+void GA_Optimization::deletePopulations() {
+	for (int islandID = 0; islandID < this->islands.size(); islandID++) {
+		for (int i = 0; i < this->islands[islandID].size(); i++) {
+			delete this->islands[islandID][i];
+		}
+	}
+	this->islands.clear();
+	this->population.clear();
+	// Images of islands not chosen by finishIslands() (the run ended early), bestImage is deleted by the caller
+	for (int islandID = 0; islandID < this->islandBestImages.size(); islandID++) {
+		if (this->islandBestImages[islandID] != this->bestImage) {
+			delete this->islandBestImages[islandID];
+		}
+	}
+	this->islandBestImages.clear();
+	delete this->surrogate;
+	this->surrogate = NULL;
+	if (this->memo != NULL) {
+		uint64_t lookups, hits;
+		this->memo->getCounts(lookups, hits);
+		Utility::printLine("INFO: Fitness memo served " + std::to_string(hits) + " of " + std::to_string(lookups) + " evaluations");
+	}
+	delete this->memo;
+	this->memo = NULL;
+}
+
+// Breed the next generation for every population (board) of an island
+void GA_Optimization::breedIsland(int islandID) {
+	for (int popID = 0; popID < this->islands[islandID].size(); popID++) {
+		this->islands[islandID][popID]->nextGeneration();
+	}
+}
+
+// Copy each island's best individual over the worst individual of the next island
+void GA_Optimization::migrateIslands() {
+	// Take copies of all the migrants first, so a migrant isn't passed on again in the same migration
+	// All boards of an island share fitness, so the best individual is found using the first board's population
+	std::vector<std::vector<uint8_t>> migrants(this->islandCount * this->popCount);
+	std::vector<double> migrantFitness(this->islandCount);
+	for (int islandID = 0; islandID < this->islandCount; islandID++) {
+		const int bestID = this->islands[islandID][0]->getBestIndex();
+		migrantFitness[islandID] = this->islands[islandID][0]->getFitness(bestID);
+		for (int popID = 0; popID < this->popCount; popID++) {
+			const uint8_t * genome = this->islands[islandID][popID]->getGenome(bestID);
+			migrants[islandID * this->popCount + popID].assign(genome, genome + this->islands[islandID][popID]->getGenomeLength());
+		}
+	}
+	for (int islandID = 0; islandID < this->islandCount; islandID++) {
+		const int toIsland = (islandID + 1) % this->islandCount;
+		for (int popID = 0; popID < this->popCount; popID++) {
+			this->islands[toIsland][popID]->replaceWorst(migrants[islandID * this->popCount + popID].data(), migrantFitness[islandID]);
+		}
+	}
+}
+
+// Finish the islands after the optimization loop
+void GA_Optimization::finishIslands(int lastIsland) {
+	// The last evaluated island has not been bred yet, breeding puts its best at the last index like the other islands
+	this->breedIsland(lastIsland);
+
+	// Use the island with the fittest best individual for the final results
+	int bestIsland = 0;
+	for (int islandID = 1; islandID < this->islandCount; islandID++) {
+		if (this->islands[islandID][0]->getFitness(this->populationSize - 1) > this->islands[bestIsland][0]->getFitness(this->populationSize - 1)) {
+			bestIsland = islandID;
+		}
+	}
+	this->population = this->islands[bestIsland];
+	// Keep the camera image of that island's elite so it matches the saved masks & fitness, the other islands' images are not needed
+	std::unique_lock<std::mutex> imageLock(this->imageMutex);
+	for (int islandID = 0; islandID < this->islandCount; islandID++) {
+		if (islandID != bestIsland) {
+			delete this->islandBestImages[islandID];
+		}
+	}
+	this->bestImage = this->islandBestImages[bestIsland];
+	this->islandBestImages.assign(this->islandCount, NULL);
+	imageLock.unlock();
+	Utility::printLine("INFO: Island " + std::to_string(bestIsland) + " has the best result with a fitness of " + std::to_string(this->population[0]->getFitness(this->populationSize - 1)));
+}
+
+// Run the steady-state GA in place of the generation loop
+//	The initial population is evaluated once, after that each evaluated child replaces the worst individual as soon as its fitness is known
+//	while a breeder job keeps children bred ahead, so the hardware never waits for a generation to be bred
+// Output: returns false if a critical error occurs, true otherwise
+//	the best individual of each population is at the last index (as after nextGeneration())
+bool GA_Optimization::runSteadyState() {
+	Utility::printLine("INFO: Using steady-state GA");
+	if (this->curr_gen == 0) {
+		// Evaluate the initial population, finishIndividual() keeps the fittest image as bestImage
+		this->steadyStateBestFitness = std::numeric_limits<double>::lowest();
+		if (this->multithreadEnable == true) {
+			for (int indID = 0; indID < this->populationSize; indID++) {
+				this->myThreadPool_->pushJob(std::bind(&GA_Optimization::runIndividual, this, indID));
+			}
+			this->myThreadPool_->wait();
+		}
+		else {
+			for (int indID = 0; indID < this->populationSize; indID++) {
+				this->runIndividual(indID);
+			}
+		}
+		this->curr_gen = 1; // The initial population counts as the first generation
+	}
+	// The best individual's fitness is the one to beat (after a resume from a checkpoint there is no best image until a child beats it)
+	this->steadyStateBestFitness = this->population[0]->getFitness(this->population[0]->getBestIndex());
+	this->steadyStateEvaluations = 0;
+	this->steadyStateBreedTime = 0;
+	this->steadyStateGenStart = this->timestamp->MicroS_SinceStart();
+	this->steadyStateDone = this->dlg->stopFlag;
+	this->steadyStateFailed = false;
+
+	// Child buffers, enough that every evaluator has one in flight with another bred & waiting, plus one for the breeder
+	const int genomeLength = this->population[0]->getGenomeLength();
+	const int bufferCount = (this->multithreadEnable == true) ? (2 * this->indThreadCount + 1) : 1;
+	this->steadyStateChildren.clear();
+	this->readyChildren.clear();
+	this->freeChildren.clear();
+	for (int i = 0; i < bufferCount; i++) {
+		this->steadyStateChildren.push_back(new uint8_t[size_t(genomeLength) * this->popCount]);
+		this->freeChildren.push_back(i);
+	}
+
+	if (this->multithreadEnable == true) {
+		// Evaluators first so they get the pool's threads, if the pool is too small for the breeder the evaluators breed for themselves
+		for (int threadID = 0; threadID < this->indThreadCount; threadID++) {
+			this->myThreadPool_->pushJob(std::bind(&GA_Optimization::steadyStateEvaluator, this, threadID));
+		}
+		this->myThreadPool_->pushJob(std::bind(&GA_Optimization::steadyStateBreeder, this));
+		this->myThreadPool_->wait();
+	}
+	else {
+		this->steadyStateEvaluator(0);
+	}
+
+	for (int i = 0; i < this->steadyStateChildren.size(); i++) {
+		delete[] this->steadyStateChildren[i];
+	}
+	this->steadyStateChildren.clear();
+	this->readyChildren.clear();
+	this->freeChildren.clear();
+
+	// Put the best at the last index for saving the results
+	for (int popID = 0; popID < this->population.size(); popID++) {
+		this->population[popID]->placeBestLast();
+	}
+	return !this->steadyStateFailed;
+}
+
+// Steady-state breeder job, keeps free child buffers filled with bred children until steadyStateDone
+void GA_Optimization::steadyStateBreeder() {
+	BetterRandom rng_machine(this->runSeed, uint64_t(1) << 32);
+	std::unique_lock<std::mutex> queueLock(this->steadyStateMutex);
+	while (true) {
+		this->steadyStateListen.wait(queueLock, [this] {return (this->steadyStateDone || !this->freeChildren.empty()); });
+		if (this->steadyStateDone) {
+			break;
+		}
+		const int bufID = this->freeChildren.front();
+		this->freeChildren.pop_front();
+		queueLock.unlock();
+
+		this->breedSteadyStateChild(this->steadyStateChildren[bufID], &rng_machine);
+
+		queueLock.lock();
+		this->readyChildren.push_back(bufID);
+	}
+}
+
+// Steady-state evaluator job, evaluates bred children (breeding one itself if none are ready) until steadyStateDone
+// Input: threadID - index of the evaluator, selects its random stream
+void GA_Optimization::steadyStateEvaluator(int threadID) {
+	BetterRandom rng_machine(this->runSeed, (uint64_t(2) << 32) | uint64_t(threadID));
+	const int genomeLength = this->population[0]->getGenomeLength();
+	std::vector<uint8_t*> genomes(this->popCount);
+	std::unique_lock<std::mutex> queueLock(this->steadyStateMutex, std::defer_lock);
+	while (true) {
+		// Take a bred child, or a free buffer to breed into if the breeder has not kept up
+		//	(a buffer is always available, there are more buffers than evaluators and the breeder can hold)
+		queueLock.lock();
+		if (this->steadyStateDone) {
+			queueLock.unlock();
+			break;
+		}
+		int bufID;
+		bool breedHere = this->readyChildren.empty();
+		if (breedHere) {
+			bufID = this->freeChildren.front();
+			this->freeChildren.pop_front();
+		}
+		else {
+			bufID = this->readyChildren.front();
+			this->readyChildren.pop_front();
+		}
+		queueLock.unlock();
+
+		double breedTime = 0;
+		if (breedHere) {
+			const double breedStart = this->timestamp->MicroS_SinceStart();
+			this->breedSteadyStateChild(this->steadyStateChildren[bufID], &rng_machine);
+			breedTime = this->timestamp->MicroS_SinceStart() - breedStart;
+		}
+
+		for (int popID = 0; popID < this->popCount; popID++) {
+			genomes[popID] = this->steadyStateChildren[bufID] + size_t(popID) * genomeLength;
+		}
+		// Only a child fitter than the best so far has its image kept by insertSteadyStateChild()
+		std::unique_lock<std::mutex> imageLock(this->imageMutex);
+		const double keepAbove = this->steadyStateBestFitness;
 		imageLock.unlock();
+		double fitness;
+		ImageController * image = NULL;
+		const bool success = this->evaluateGenomes(genomes.data(), keepAbove, fitness, image);
+		// Stop if there was an error or the stop flag was raised, otherwise the child joins the population
+		bool stop = true;
+		if (success && image != NULL) {
+			stop = this->insertSteadyStateChild(this->steadyStateChildren[bufID], fitness, image, breedTime);
+		}
+
+		queueLock.lock();
+		this->freeChildren.push_back(bufID);
+		if (!success) {
+			this->steadyStateFailed = true;
+		}
+		if (stop) {
+			this->steadyStateDone = true;
+		}
+		queueLock.unlock();
+		this->steadyStateListen.notify_all();
 	}
+}
 
-	// Update fitness for the individuals
+// Breed a child for the steady-state GA, parents are picked by tournament and shared across boards
+// Input: child - child buffer to fill (popCount genomes), rng_machine - the RNG to use
+void GA_Optimization::breedSteadyStateChild(uint8_t * child, BetterRandom * rng_machine) {
+	// Parents can't be replaced while being read
+	std::unique_lock<std::mutex> populationLock(this->populationMutex);
+	// All boards share fitness, so parents are selected using the first board's population
+	const int parentA = this->population[0]->tournamentSelect(this->steadyStateTournamentSize, rng_machine);
+	const int parentB = this->population[0]->tournamentSelect(this->steadyStateTournamentSize, rng_machine);
+	const int genomeLength = this->population[0]->getGenomeLength();
+	for (int popID = 0; popID < this->popCount; popID++) {
+		this->population[popID]->breedGenome(parentA, parentB, child + size_t(popID) * genomeLength, rng_machine);
+	}
+}
+
+// Replace the worst individual with an evaluated child, finishing a generation every populationSize evaluations
+// Input: child - the evaluated child buffer, fitness - its fitness, image - its image (kept as bestImage or released to the camera), breedTime - time spent breeding it in the evaluator
+// Output: returns true if a stop condition was reached
+bool GA_Optimization::insertSteadyStateChild(const uint8_t * child, double fitness, ImageController * image, double breedTime) {
+	std::unique_lock<std::mutex> populationLock(this->populationMutex);
+	const int genomeLength = this->population[0]->getGenomeLength();
+	for (int popID = 0; popID < this->popCount; popID++) {
+		this->population[popID]->replaceWorst(child + size_t(popID) * genomeLength, fitness);
+	}
+
+	// Keep the image if this is the best child so far
+	if (fitness > this->steadyStateBestFitness) {
+		std::unique_lock<std::mutex> imageLock(this->imageMutex);
+		delete this->bestImage;
+		this->bestImage = this->cc->KeepImage(image);
+		this->steadyStateBestFitness = fitness;
+	}
+	else {
+		this->cc->ReleaseImage(image);
+	}
+
+	this->steadyStateBreedTime += breedTime;
+	this->steadyStateEvaluations++;
+	if (this->steadyStateEvaluations % this->populationSize == 0) {
+		return this->finishSteadyStateGeneration();
+	}
+	return this->dlg->stopFlag;
+}
+
+// Log, display & check stop conditions at the end of a steady-state generation (every populationSize evaluations), called with populationMutex held
+// Output: returns true if a stop condition was reached
+bool GA_Optimization::finishSteadyStateGeneration() {
+	// Measuring diversity also puts the best at the last index for the displays & saved images
+	double diversity = 0, mutationRate = 0, mutationStep = 0;
 	for (int popID = 0; popID < this->population.size(); popID++) {
-		this->population[popID]->setFitness(indID, fitness * exposureTimesRatio);
+		diversity += this->population[popID]->measureDiversity();
+		mutationRate += this->population[popID]->getMutationRate();
+		mutationStep += this->population[popID]->getMutationStep();
 	}
-	// If the fitness value is too high, flag that the exposure needs to be shortened
-	if (fitness > this->maxFitnessValue) {
-		std::unique_lock<std::mutex> exposureFlagLock(this->exposureFlagMutex, std::defer_lock);
-		exposureFlagLock.lock();
-		this->shortenExposureFlag = true;
-		exposureFlagLock.unlock();
+
+	// Update displays with best individual
+	if (this->displayCamImage && this->bestImage != NULL) {
+		std::unique_lock<std::mutex> imageLock(this->imageMutex);
+		this->camDisplay->UpdateDisplay(this->bestImage->getRawData());
 	}
-	// If the pointer to current image does not also point to the best image we are safe to delete
-	if (curImage != this->bestImage) {
-		delete curImage;
+	if (this->displaySLMImage) {
+		std::unique_lock<std::mutex> scalerLock(this->slmScalersMutex);
+		for (int slmID = 0; slmID < this->popCount; slmID++) {
+			this->scalers[slmID]->TranslateImage(this->population[slmID]->getGenome(this->populationSize - 1), this->slmScaledImages[slmID]);
+			this->slmDisplayVector[slmID]->UpdateDisplay(this->slmScaledImages[slmID]);
+		}
+	}
+	// Save elite info
+	if ((this->saveEliteImages) && (this->curr_gen % this->saveEliteFrequency == 0)) {
+		std::unique_lock<std::mutex> tFileLock(this->tfileMutex);
+		this->tfile << this->curr_gen << "," << this->steadyStateBestFitness << std::endl;
+		tFileLock.unlock();
+		std::string curTime = Utility::getCurDateTime(); // Get current time to use as timeStamp
+		std::unique_lock<std::mutex> imageLock(this->imageMutex);
+		if (this->bestImage != NULL) this->cc->saveImage(this->bestImage, std::string(this->outputFolder + curTime + "_" + this->algorithm_name_ + "_Gen_" + std::to_string(this->curr_gen + 1) + "_Elite_Camera" + ".bmp"));
+		imageLock.unlock();
+		std::unique_lock<std::mutex> scalerLock(this->slmScalersMutex);
+		for (int popID = 0; popID < this->popCount; popID++) {
+			scalers[popID]->TranslateImage(this->population[popID]->getGenome(this->populationSize - 1), this->slmScaledImages[popID]);
+			cv::Mat m_ary = cv::Mat(this->sc->getBoardWidth(popID), this->sc->getBoardHeight(popID), CV_8UC1, this->slmScaledImages[popID]);
+			cv::imwrite(this->outputFolder + curTime + "_" + this->algorithm_name_ + "_Gen_" + std::to_string(this->curr_gen + 1) + "_Elite_SLM_" + std::to_string(this->optBoards[popID]->board_id) + ".bmp", m_ary);
+		}
 	}
+	// Half exposure time if fitness value is too high (with the hardware lock, as other evaluators may be using the camera)
+	if (this->shortenExposureFlag) {
+		std::unique_lock<std::mutex> hardwareLock(this->hardwareMutex);
+		this->cc->HalfExposureTime();
+		this->shortenExposureFlag = false;
+		if (this->saveExposureShorten || this->logAllFiles) {
+			this->efile << "Exposure shortened after gen: " << this->curr_gen + 1 << " with new ratio " << this->cc->GetExposureRatio() << std::endl;
+		}
+	}
+	// Output to the terminal progress to help show progress
+	if (this->curr_gen % 10 == 0) {
+		Utility::printLine("INFO: Finished generation #" + std::to_string(this->curr_gen) + " with a fitness of " + std::to_string(this->steadyStateBestFitness));
+	}
+	// Check stop conditions
+	this->stopConditionsMetFlag = stopConditionsReached((this->steadyStateBestFitness*this->cc->GetExposureRatio()), this->timestamp->S_SinceStart(), this->curr_gen + 1);
+
+	// Record the time of this generation, breeding time being how long evaluators had to breed for themselves (time the hardware could have been waiting)
+	if (this->logAllFiles || this->saveTimeVSFitness) {
+		const double generation_end = this->timestamp->MicroS_SinceStart();
+		this->timePerGenFile << this->curr_gen + 1 << "," << generation_end - this->steadyStateGenStart << "," << this->steadyStateBreedTime << "," << generation_end - this->steadyStateGenStart << "," << diversity / this->population.size() << "," << mutationRate / this->population.size() << "," << mutationStep / this->population.size();
+		double stageMeans[STAGE_COUNT];
+		this->takeStageTimes(stageMeans);
+		for (int stage = 0; stage < STAGE_COUNT; stage++) {
+			this->timePerGenFile << "," << stageMeans[stage];
+		}
+		this->timePerGenFile << std::endl;
+	}
+	this->steadyStateGenStart = this->timestamp->MicroS_SinceStart();
+	this->steadyStateBreedTime = 0;
+	this->curr_gen++;
+	// Checkpoint the population (children still being bred or evaluated are not kept)
+	if (this->checkpointInterval > 0 && this->curr_gen % this->checkpointInterval == 0 && !this->dlg->stopFlag) {
+		this->saveCheckpoint(this->curr_gen);
+	}
+	return this->stopConditionsMetFlag;
+}
+
+// Write a checkpoint of the run, the populations of every island with their RNG streams, the exposure and the generation to continue from
+bool GA_Optimization::saveCheckpoint(int nextGen) {
+	CheckpointWriter out(this->algorithm_name_);
+	out.put(nextGen);
+	out.put(this->runSeed);
+	out.put(this->cc->finalExposureTime);
+	out.put(int(this->islands.size()));
+	out.put(this->popCount);
+	for (int islandID = 0; islandID < this->islands.size(); islandID++) {
+		for (int popID = 0; popID < this->islands[islandID].size(); popID++) {
+			this->islands[islandID][popID]->saveState(out);
+		}
+	}
+	return out.commit(this->checkpointPath());
+}
+
+// Restore the run from its checkpoint, populations must already be set up with the same sizes (same settings & boards as the checkpointed run)
+bool GA_Optimization::loadCheckpoint(int & nextGen) {
+	CheckpointReader in;
+	if (!in.open(this->checkpointPath(), this->algorithm_name_)) {
+		return false;
+	}
+	int islandCount = 0, popCount = 0;
+	double exposure = 0;
+	uint64_t seed = 0;
+	if (!in.get(nextGen) || !in.get(seed) || !in.get(exposure) || !in.get(islandCount) || !in.get(popCount)) {
+		return false;
+	}
+	if (islandCount != this->islands.size() || popCount != this->popCount) {
+		Utility::printLine("ERROR: Checkpoint has " + std::to_string(islandCount) + " islands of " + std::to_string(popCount) + " boards, this run has " + std::to_string(this->islands.size()) + " of " + std::to_string(this->popCount));
+		return false;
+	}
+	for (int islandID = 0; islandID < this->islands.size(); islandID++) {
+		for (int popID = 0; popID < this->islands[islandID].size(); popID++) {
+			if (!this->islands[islandID][popID]->loadState(in)) {
+				// Populations are partly restored, start them over
+				Utility::printLine("ERROR: Checkpoint populations could not be restored!");
+				this->deletePopulations();
+				this->setupPopulations();
+				return false;
+			}
+		}
+	}
+	this->runSeed = seed;
+	this->cc->finalExposureTime = exposure;
+	this->cc->SetExposure(exposure);
+	this->population = this->islands[(nextGen > 0) ? (nextGen - 1) % this->islandCount : 0];
+	Utility::printLine("INFO: Resuming from checkpoint at generation #" + std::to_string(nextGen) + " (run seed " + std::to_string(this->runSeed) + ", exposure " + std::to_string(exposure) + ")");
 	return true;
 }
+
+// Method to write the GA's settings to the parameters file
+void GA_Optimization::saveAlgorithmParameters(std::ofstream & paramFile) {
+	paramFile << "Sequence Evaluation - " << (this->sequenceEvaluation ? "true" : "false") << std::endl;
+	if (this->sequenceEvaluation) {
+		paramFile << "Sequence Wait For Trigger - " << (this->sequenceWaitForTrigger ? "true" : "false") << std::endl;
+		if (!this->sequenceWaitForTrigger) {
+			paramFile << "Sequence Hold Time - " << std::to_string(this->sequenceHoldTime) << std::endl;
+		}
+		paramFile << "Sequence Trigger Timeout - " << std::to_string(this->sequenceTriggerTimeout) << std::endl;
+	}
+}
@@ -4,8 +4,15 @@
 // Last edited: 08/12/2021 by Andrew O'Kins
 ////////////////////
 
+#include <cstdint> // uint8_t genome type
+#include <deque>   // queues of steady-state child buffers
+#include <condition_variable> // steady-state breeder waiting for free child buffers
+#include <atomic>	// ending a hardware sequence's writer early
+
 #include "Optimization.h"
 #include "Population.h"
+#include "SurrogateModel.h"
+#include "FitnessMemo.h"
 
 #include "threadPool.h"
 
@@ -14,10 +21,94 @@
 
 class GA_Optimization : public Optimization {
 protected:
-	// Vector to hold genetic algorithm's populations
-	std::vector<Population<int>*> population;
+	// Vector to hold genetic algorithm's populations (genome values are 8-bit phases, 0-255)
+	// When using islands this is the set of populations (one per board) of the island currently being evaluated
+	std::vector<Population<uint8_t>*> population;
+	// Every island's set of populations (one per board), a single island when not using the island model
+	std::vector<std::vector<Population<uint8_t>*>> islands;
+	// Camera image of each island's elite when using the island model (bestImage is the one of the island evaluated last)
+	std::vector<ImageController*> islandBestImages;
 	threadPool * myThreadPool_;
 
+	// Island model parameters
+	//	With more than one island, each generation one island is evaluated on the hardware while the island evaluated before it breeds on a pool thread,
+	//	so islands add search diversity on otherwise idle cores without adding hardware time (each island is evaluated every islandCount generations)
+	int islandCount = 1;				// Number of independent islands (1 -> standard single population per board)
+	int migrationInterval = 20;			// Every this many generations each island's best is copied over the worst of the next island (ring)
+	double islandMutationSpread = 2.0;	// Mutation rate multiplier between neighbouring islands (islands are spread around the population's default rate)
+
+	// Mutation parameters
+	//	Mutated genes are replaced with a random value, or with a mutation step moved by a small phase change (up to the step either way)
+	//	With adaptive mutation each genome carries its own rate (and step), children inherit their parents' with a random change
+	//	and selection keeps the rates breeding the fittest children (generational breeding only, the steady-state GA uses the set rate)
+	bool adaptiveMutation = false;		// TRUE -> self-adaptive mutation rates (also turns on mutation for the uGA)
+	double mutationStep = 0;			// Largest phase change of a mutated gene (0 -> mutated genes are replaced with a random value)
+	double minMutationRate = 0;			// Lowest adapted mutation rate (0 -> a quarter of the starting rate)
+	double maxMutationRate = 0.05;		// Highest adapted mutation rate
+
+	// Speculative breeding parameters & state
+	//	Once every individual not yet evaluated is already waiting on the hardware, the next generation's children are bred on pool threads
+	//	from the parents evaluated so far, nextGeneration() then only corrects the children whose parents the late fitness changes (SGA only)
+	bool speculativeBreeding = false;	// TRUE -> start breeding before the last individuals are evaluated (multithreaded, single island)
+	std::vector<int> evaluatedIDs;		// Individuals evaluated so far this generation
+	bool speculationStarted = true;		// Set once the children of this generation have started being bred (or speculation is not used)
+
+	// Surrogate prescreening parameters
+	//	A surrogate model of the fitness is fitted from every hardware evaluation, when breeding this many candidates are bred for each child
+	//	and only the one the model scores best is sent to the hardware (SGA only, 1 -> no prescreening)
+	int screeningCandidates = 1;
+	SurrogateModel * surrogate = NULL;	// Model shared by the populations (created by setupPopulations() when screening)
+
+	// Fitness memo parameters
+	//	Measured fitness is kept by genome so repeated genomes (elites, converged uGA populations) are not evaluated on the hardware again,
+	//	unless the noise of their measurements is too high for the number of measurements or the latest measurement is too old
+	bool useFitnessMemo = false;		// TRUE -> serve repeated genomes from the memo
+	int memoMaxAge = 10;				// Generations a measurement can be served for
+	double memoMaxError = 0.02;			// Largest standard error of a genome's mean fitness (relative to the mean) that can be served
+	FitnessMemo * memo = NULL;			// The memo (created by setupPopulations() when used)
+
+	// Steady-state GA parameters
+	//	Instead of generations, each evaluated child immediately replaces the worst individual while a breeder thread keeps children bred ahead,
+	//	so the SLM & camera never wait on breeding (every populationSize evaluations is counted as a generation for logs & stop conditions)
+	bool steadyState = false;			// TRUE -> steady-state GA instead of generations (uses a single island)
+	int steadyStateTournamentSize = 2;	// Number of individuals competing in each parent selection
+
+	// Steady-state GA state
+	std::vector<uint8_t*> steadyStateChildren;	// Child buffers, each holding a genome for every board (popCount genomes)
+	std::deque<int> readyChildren;				// Indices of child buffers bred and waiting to be evaluated
+	std::deque<int> freeChildren;				// Indices of child buffers free to breed into
+	bool steadyStateDone;				// Set when the steady-state GA should stop
+	bool steadyStateFailed;				// Set if an evaluation had a critical error
+	int steadyStateEvaluations;			// Number of children evaluated
+	double steadyStateBestFitness;		// Fitness of bestImage
+	double steadyStateGenStart;			// Time stamp (microseconds) the current generation's evaluations started
+	double steadyStateBreedTime;		// Time (microseconds) evaluators spent breeding because no bred child was ready this generation
+
+	// Evaluation pipeline
+	//	Each evaluation scales its genomes into its own staging images before waiting on the hardware, so the hardware stage is only
+	//	writing the boards & acquiring the frame, while other evaluator threads scale the next individual and find the fitness of the last
+	enum EvaluationStage {
+		STAGE_SCALE,			// Scaling genomes into staging images
+		STAGE_HARDWARE_WAIT,	// Waiting for the hardware to be free
+		STAGE_WRITE,			// Writing the boards
+		STAGE_ACQUIRE,			// Acquiring the camera image
+		STAGE_FITNESS,			// Finding the fitness & logging it
+		STAGE_COUNT
+	};
+	std::vector<unsigned char**> stagingImages;		// Sets of scaled images (an array with one per board), a set per evaluation in progress
+	std::vector<unsigned char* const*> freeStaging;	// Staging sets not in use
+	double stageTimes[STAGE_COUNT];		// Total time (microseconds) spent in each stage since the last takeStageTimes()
+	int stageEvaluations = 0;			// Evaluations counted in stageTimes
+
+	// Hardware-sequenced evaluation parameters
+	//	Every individual of a generation is scaled up front, then a writer thread writes the masks to the boards back to back with the last board
+	//	raising its output pulse to trigger the camera's exposure, and the frames are read in order once the sequence is under way
+	//	(generational GA only, a sequence that loses frames is written again from the first lost individual once)
+	bool sequenceEvaluation = false;	// TRUE -> evaluate each generation as one hardware sequence
+	bool sequenceWaitForTrigger = false;	// TRUE -> each mask waits on the SLM's trigger input (the camera's exposure end) instead of a timed hold
+	int sequenceHoldTime = 0;			// Time (microseconds) each mask is held beyond the exposure time when not waiting on the trigger
+	int sequenceTriggerTimeout = 1000;	// Longest wait (milliseconds) for a trigger or frame before the sequence is taken as broken
+
 	int populationSize;	// Size of the populations being used (number of individuals in a population class)
 	int popCount;		// Number of populations working with (should be equal to number of boards being optimized)
 	int eliteSize;		// Number of elite individuals within the population (should be less than populationSize)
@@ -34,6 +125,11 @@ protected:
 	std::mutex tfileMutex, timeVsFitMutex;			// Mutex to protect file i/o
 	std::mutex exposureFlagMutex;					// Mutex to protect important flag(s)
 	std::mutex slmScalersMutex; // Mutex to protect the usage of the the SLM scalers (which are used in both for hardware and in image output)
+	std::mutex speculationMutex;	// Mutex to protect the list of evaluated individuals for speculative breeding
+	std::mutex populationMutex;		// Mutex to protect the populations when breeding & replacing individuals in the steady-state GA
+	std::mutex steadyStateMutex;	// Mutex to protect the steady-state child buffer queues
+	std::condition_variable steadyStateListen;	// Breeder waits on this for a free child buffer
+	std::mutex stagingMutex;		// Mutex to protect the list of free staging image sets & the stage times
 
 	// Method for handling the execution of an individual
 	// Input:
@@ -46,6 +142,133 @@ protected:
 	//		stopConditionsMetFlag is set to true if conditions met
 	bool runIndividual(int indID);
 
+	// Record an individual as evaluated this generation, starting speculative breeding once enough are
+	// Input: indID - index of the individual that has its fitness
+	void markEvaluated(int indID);
+
+	// Method for evaluating genomes on the hardware, writing them to the SLMs and getting the fitness from the camera image
+	// Input: genomes - the genome to write to each board being optimized (popCount genomes)
+	//		keepAbove - the image is copied out of the camera's buffer (see CameraController::KeepImage()) while the hardware is held if its fitness is above this
+	// Output: returns false if a critical error occurs, true otherwise
+	//		image - set to the acquired image (caller is responsible for giving it back with CameraController::ReleaseImage()), NULL if the stop flag was raised before the hardware was used
+	//		fitness - set to the image's fitness (scaled by the exposure ratio)
+	//		shortenExposureFlag is set to true if fitness value is high enough
+	bool evaluateGenomes(uint8_t * const * genomes, double keepAbove, double & fitness, ImageController *& image);
+
+	// Find the fitness of an acquired image, logging it & flagging the exposure to be shortened if the image is too bright
+	// Input: genomes - the genomes the image was acquired with (popCount genomes)
+	//		rawFitness - the image's intensity within circle of target radius (ImageController::getTargetAverage() of the fitness radius)
+	// Output: returns the image's fitness (scaled by the exposure ratio), the surrogate is fitted to it
+	double scoreImage(uint8_t * const * genomes, double rawFitness);
+
+	// Give an evaluated individual its fitness, saving the elite's images & keeping its camera image as the best image
+	// Input: indID - index of the evaluated individual, fitness - its measured fitness, curImage - its camera image (kept as bestImage or released to the camera)
+	//		genomeHash - hash of its genomes for the memo (unused without the memo)
+	void finishIndividual(int indID, double fitness, ImageController * curImage, uint64_t genomeHash);
+
+	// Evaluate the individuals of the current generation as one hardware sequence (sequenceEvaluation == true)
+	// Output: returns false if the sequence could not be completed even when written again (a critical error), true otherwise
+	//		individuals evaluated are given their fitness as runIndividual() would
+	bool evaluateSequence();
+
+	// Sequence writer thread, writes each individual's staging images to the boards in turn (see evaluateSequence())
+	// Input: stagings - staging set of each individual in the sequence (from acquireStaging()), start - index into stagings to start from, stop - raised to end early
+	// Output: writeFailed - set if a write failed or timed out waiting on the trigger, writeTime - set to the time spent writing (microseconds)
+	void writeSequence(const std::vector<unsigned char* const*> * stagings, int start, std::atomic<bool> * stop, bool * writeFailed, double * writeTime);
+
+#ifdef USE_MOCK_CAMERA
+	// Check hardware sequences with the simulated camera & boards, each individual is given a distinct genome and evaluateSequence()
+	// is run with a frame lost part way through, so the lost-frame retry path is taken
+	// The population's genomes & fitness (and any state the evaluation changes) are put back afterwards
+	// Output: returns true if every individual got the fitness of its own frame and the lost frame was written again
+	bool testSequence();
+#endif
+
+	// Take a set of staging images (one per board) to scale an evaluation's genomes into, creating a new set if none are free
+	// Output: returns the set (its image for each board), to be given back with releaseStaging()
+	//	The set stays where it is while other sets are made, so it is used without holding stagingMutex
+	unsigned char* const* acquireStaging();
+
+	// Give back a set of staging images once its images are written to the boards
+	void releaseStaging(unsigned char* const* staging);
+
+	// Delete every set of staging images, only to be called when no evaluations are in progress
+	void deleteStaging();
+
+	// Add the time spent in each stage by evaluations
+	// Input: times - array of STAGE_COUNT (microseconds, totals over the evaluations), evaluations - number of evaluations the times are for
+	void addStageTimes(const double * times, int evaluations);
+
+	// Get the mean time spent in each stage per evaluation since the last call, then start counting again
+	// Input: meanTimes - array of STAGE_COUNT to write to (microseconds)
+	// Output: returns the number of evaluations the means are over
+	int takeStageTimes(double * meanTimes);
+
+	// Run the steady-state GA in place of the generation loop (steadyState == true)
+	// Output: returns false if a critical error occurs, true otherwise
+	//		the best individual of each population is at the last index (as after nextGeneration())
+	bool runSteadyState();
+
+	// Steady-state breeder job, keeps free child buffers filled with bred children until steadyStateDone
+	void steadyStateBreeder();
+
+	// Steady-state evaluator job, evaluates bred children (breeding one itself if none are ready) until steadyStateDone
+	// Input: threadID - index of the evaluator, selects its random stream
+	void steadyStateEvaluator(int threadID);
+
+	// Breed a child for the steady-state GA, parents are picked by tournament and shared across boards
+	// Input: child - child buffer to fill (popCount genomes), rng_machine - the RNG to use
+	void breedSteadyStateChild(uint8_t * child, BetterRandom * rng_machine);
+
+	// Replace the worst individual with an evaluated child, finishing a generation every populationSize evaluations
+	// Input: child - the evaluated child buffer, fitness - its fitness, image - its image (kept as bestImage or released to the camera), breedTime - time spent breeding it in the evaluator
+	// Output: returns true if a stop condition was reached
+	bool insertSteadyStateChild(const uint8_t * child, double fitness, ImageController * image, double breedTime);
+
+	// Log, display & check stop conditions at the end of a steady-state generation, called with populationMutex held
+	// Output: returns true if a stop condition was reached
+	bool finishSteadyStateGeneration();
+
+	// Create a population for the algorithm being used (SGA or uGA), to be implemented by child classes
+	// Input:
+	//	seed - seed for the population's random streams
+	//	multiThread - if the population may use the thread pool to breed (false when breeding as a single pool job for the island model)
+	// Output: returns the new population (caller is responsible for deleting it)
+	virtual Population<uint8_t>* createPopulation(uint64_t seed, bool multiThread) = 0;
+
+	// Create the islands of populations using createPopulation(), one population per board being optimized on each island
+	// Output: islands and population are set, returns false if an error occurs
+	bool setupPopulations();
+
+	// Delete the populations of every island
+	void deletePopulations();
+
+	// Copy each island's best individual over the worst of the next island (in a ring), only to be called when no island is breeding or being evaluated
+	void migrateIslands();
+
+	// Breed the next generation for every population of an island (island model, run as a pool job)
+	// Input: islandID - index of the island to breed
+	void breedIsland(int islandID);
+
+	// Write a checkpoint of the run (populations of every island, their RNG streams, exposure & generation), see Checkpoint.h
+	// Input: nextGen - the generation the run would continue from
+	// Output: returns false if the checkpoint could not be written
+	bool saveCheckpoint(int nextGen);
+
+	// Restore the run from its checkpoint, to be called after setupInstanceVariables()
+	// Output: returns false if there is no usable checkpoint (the run then starts from the beginning)
+	//		nextGen - set to the generation to continue from
+	bool loadCheckpoint(int & nextGen);
+
+	// Finish the island model after the optimization loop, breeding any island that was evaluated but not yet bred
+	// and setting population to the island with the best individual (so its best is at the last index like the single population case)
+	// with bestImage set to that island's elite image
+	// Input: lastIsland - index of the island evaluated in the last generation
+	void finishIslands(int lastIsland);
+
+	// Method to write the GA's settings to the parameters file (hardware sequence settings when one was used)
+	void saveAlgorithmParameters(std::ofstream & paramFile);
+
 public:
 	// Constructor - inherits from base class
 	GA_Optimization(MainDialog* dlg, CameraController* cc, SLMController* sc) : Optimization(dlg, cc, sc) {
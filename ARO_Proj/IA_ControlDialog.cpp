@@ -24,6 +24,9 @@ BOOL IA_ControlDialog::OnInitDialog() {
 	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_EDIT_NUMBER_BINS), L"Square dimension of the image being made to optimize onto the SLMs");
 	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_PHASE_RESOLUTION), L"Set the depth resolution of the optimal image (do not exceed 16!)");
 	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_EDIT_TARGET_RADIUS), L"Radius of image to focus for optimizing intensity of");
+	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_CHECKPOINT_INTERVAL), L"Bins between checkpoints of the run written to the output folder (0 indicates no checkpoints)");
+	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_RESUME_CHECK), L"Continue from the checkpoint of this algorithm in the output folder if there is one (same settings and boards as the checkpointed run)");
+	this->m_mainToolTips->AddTool(this->GetDlgItem(IDC_WARM_START_MASK), L"Mask to start the run from, \"{board}\" in the path is replaced with the board number (empty indicates a blank start)");
 	this->m_mainToolTips->Activate(true);
 
 	return CDialogEx::OnInitDialog();
@@ -41,6 +44,9 @@ void IA_ControlDialog::DoDataExchange(CDataExchange* pDX) {
 	DDX_Control(pDX, IDC_EDIT_BIN_SIZE, m_binSize);
 	DDX_Control(pDX, IDC_EDIT_NUMBER_BINS, m_numBins);
 	DDX_Control(pDX, IDC_PHASE_RESOLUTION, m_phaseResolution);
+	DDX_Control(pDX, IDC_CHECKPOINT_INTERVAL, m_checkpointInterval);
+	DDX_Control(pDX, IDC_RESUME_CHECK, m_resumeFromCheckpoint);
+	DDX_Control(pDX, IDC_WARM_START_MASK, m_warmStartMask);
 	DDX_Control(pDX, IDC_EDIT_TARGET_RADIUS, m_targetRadius);
 }
 
@@ -49,6 +55,9 @@ void IA_ControlDialog::setDefaultUI() {
 	this->m_numBins.SetWindowTextW(_T("32"));
 	this->m_phaseResolution.SetWindowTextW(_T("16"));
 	this->m_targetRadius.SetWindowTextW(_T("2"));
+	this->m_checkpointInterval.SetWindowTextW(_T("0")); // 0 indicates no checkpoints
+	this->m_resumeFromCheckpoint.SetCheck(BST_UNCHECKED);
+	this->m_warmStartMask.SetWindowTextW(_T("")); // Empty indicates a blank start
 }
 
 BEGIN_MESSAGE_MAP(IA_ControlDialog, CDialogEx)
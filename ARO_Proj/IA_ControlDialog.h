@@ -38,4 +38,10 @@ public:
 	CEdit m_binSize;
 	CEdit m_numBins;
 	CEdit m_targetRadius;
+	// Bins between checkpoints written to the output folder, 0 for no checkpoints
+	CEdit m_checkpointInterval;
+	// If toggled, the run continues from the checkpoint in the output folder
+	CButton m_resumeFromCheckpoint;
+	// Path of a mask to start the optimized images from, empty to start from a blank image
+	CEdit m_warmStartMask;
 };
@@ -0,0 +1,92 @@
+////////////////////
+// ImageControllerMock.h - Header file of ImageController for the simulated camera (see CameraControllerMock.h)
+//		Images are 8 bit monochrome and always own their data
+////////////////////
+
+#ifndef IMAGE_CONTROLLER_MOCK_H_
+#define IMAGE_CONTROLLER_MOCK_H_
+
+#ifdef USE_MOCK_CAMERA // Only include implementation if building with the simulated camera
+
+#include <opencv2\core\core.hpp> // Using OpenCV to save image info
+#include <opencv2\highgui\highgui.hpp>
+
+#include "Utility.h"	// Fitness of the image
+
+class ImageController {
+private:
+	unsigned char * data_; // Raw data of the image (each element in array is a pixel)
+	int width_;			   // Width of the image in pixels
+	int height_;		   // Height of the image in pixels
+	int size_;			   // Total size of the image in bytes
+public:
+	// Constructor of an empty image
+	// Input: width, height - size of the image in pixels (filled with 0)
+	ImageController(int width = 0, int height = 0) {
+		this->width_ = width;
+		this->height_ = height;
+		this->size_ = width * height;
+		this->data_ = new unsigned char[this->size_]();
+	}
+
+	// Copy constructor
+	ImageController(ImageController & other) {
+		this->width_ = other.getWidth();
+		this->height_ = other.getHeight();
+		this->size_ = other.getSize();
+		this->data_ = new unsigned char[this->size_];
+		unsigned char * otherData = other.getRawData();
+		for (int index = 0; index < this->size_; index++) {
+			this->data_[index] = otherData[index];
+		}
+	}
+
+	// Desturctor
+	~ImageController() {
+		delete[] this->data_;
+	}
+
+	// Getter for size (used in copy constructor)
+	const int getSize() {
+		return this->size_;
+	}
+
+	// Simulated images are never views of a camera buffer
+	const bool isView() {
+		return false;
+	}
+
+	// Simulated images own their data, so are always valid
+	const bool isValid() {
+		return true;
+	}
+
+	// Returns pointer to data associated with the image
+	unsigned char * getRawData() {
+		return this->data_;
+	}
+
+	// Calculate the fitness of the image, the average intensity within radius r of its center
+	double getTargetAverage(int r) {
+		return Utility::FindAverageValue(this->data_, this->width_, this->height_, r);
+	}
+
+	// Return width of the Image
+	const int getWidth() {
+		return this->width_;
+	}
+
+	// Return height of the image
+	const int getHeight() {
+		return this->height_;
+	}
+
+	// Output the image with given file path
+	void saveImage(std::string path) {
+		cv::imwrite(path, cv::Mat(this->height_, this->width_, CV_8UC1, this->data_));
+	}
+};
+
+#endif // inclusion for only the simulated camera
+
+#endif // file inclusion
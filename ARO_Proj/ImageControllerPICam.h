@@ -11,6 +11,9 @@
 #include <opencv2\core\core.hpp> // Using OpenCV to save image info
 #include <opencv2\highgui\highgui.hpp>
 
+#include "Timing.h"		// Host time a view's readout may be overwritten at
+#include "Utility.h"	// Fitness of the image
+
 // Note / TODO: Consider how to handle issue of image size received being larger (16 bit versus 8 bit)
 
 class ImageController {
@@ -19,10 +22,41 @@ private:
 	int width_;			   // Width of the image in pixels
 	int height_;		   // Height of the image in pixels
 	int size_;			   // Total size of the image in bytes (which should be with current format equal to width*height)
+	int binning_;		   // Pixels summed along each side into each readout pixel (divided back out so binned images keep the unbinned scale, as Spinnaker's averaged binning does)
+
+	// View over a readout in the acquisition buffer (see CameraController::AcquireImageView())
+	const unsigned short * view_;	// Readout the image views (NULL -> the image owns its data)
+	double validUntil_;				// Host time (microseconds) after which the camera may have overwritten the readout
+	bool converted_;				// TRUE -> data_ holds the 8 bit conversion of the viewed readout
+	int capacity_;					// Size data_ has been allocated with (kept when a pooled view is reused)
+
+	// Convert the viewed readout into data_ (only done when the 8 bit data is asked for, such as saving the image)
+	void convertView() {
+		if (this->capacity_ < this->size_) {
+			delete[] this->data_;
+			this->data_ = new unsigned char[this->size_];
+			this->capacity_ = this->size_;
+		}
+		const int divisor = 257 * this->binning_ * this->binning_;
+		for (int index = 0; index < this->size_; index++) {
+			this->data_[index] = unsigned char(this->view_[index] / divisor);
+		}
+		if (!this->isValid()) {
+			Utility::printLine("WARNING: Image view was converted after its readout may have been overwritten!");
+		}
+		this->converted_ = true;
+	}
 public:
 	ImageController() {
 		this->data_ = nullptr;
+		this->width_ = 0;
+		this->height_ = 0;
 		this->size_ = 0;
+		this->binning_ = 1;
+		this->view_ = NULL;
+		this->validUntil_ = 0;
+		this->converted_ = false;
+		this->capacity_ = 0;
 	}
 
 	// Constructor with set image to assign
@@ -31,16 +65,24 @@ public:
 	//			size - number of elements in rawData
 	//		    width - width of the image in pixels
 	//			height - height of the image in piels
-	ImageController(unsigned short * rawData, int size, int width, int height) {
+	//			binning - pixels summed along each side into each pixel of rawData (1 when not binned)
+	ImageController(unsigned short * rawData, int size, int width, int height, int binning = 1) {
 		this->size_ = size;
 		this->width_ = width;
 		this->height_ = height;
+		this->binning_ = (binning > 1) ? binning : 1;
+
+		this->view_ = NULL;
+		this->validUntil_ = 0;
+		this->converted_ = false;
+		this->capacity_ = size;
 
 		this->data_ = new unsigned char[size];
+		const int divisor = 257 * this->binning_ * this->binning_;
 		for (int index = 0; index < size; index++) {
 			// Attempting a kind of compression to convert short size value to byte size (1/2 the size) by dividing it down so max is reduced to 255 and so on.
 			// Note that this not at all a lossless compression, but should work to having data comparable to Spinnaker's
-			unsigned char byteData = unsigned char(rawData[index] / 257);
+			unsigned char byteData = unsigned char(rawData[index] / divisor);
 			this->data_[index] = byteData;
 		}
 	}
@@ -51,6 +93,11 @@ public:
 		this->height_ = other.getHeight();
 		this->size_ = other.getSize();
 		unsigned char * otherData = other.getRawData();
+		this->binning_ = 1; // The 8 bit data is already scaled
+		this->view_ = NULL;
+		this->validUntil_ = 0;
+		this->converted_ = false;
+		this->capacity_ = this->size_;
 
 		this->data_ = new unsigned char[this->size_];
 		for (int index = 0; index < this->size_; index++) {
@@ -68,11 +115,54 @@ public:
 		return this->size_;
 	}
 
-	// Returns pointer to data associated with the image
+	// Point the image at a readout in the acquisition buffer without copying it, making it a view
+	// Input:	readout - pointer to the readout's 16 bit data
+	//			size - number of pixels in the readout
+	//			width, height - size of the image in pixels
+	//			validUntil - host time (microseconds) after which the camera may have overwritten the readout
+	//			binning - pixels summed along each side into each readout pixel (1 when not binned)
+	void setView(const unsigned short * readout, int size, int width, int height, double validUntil, int binning) {
+		this->binning_ = (binning > 1) ? binning : 1;
+		this->view_ = readout;
+		this->size_ = size;
+		this->width_ = width;
+		this->height_ = height;
+		this->validUntil_ = validUntil;
+		this->converted_ = false;
+	}
+
+	// Returns true if the image views a readout in the acquisition buffer (rather than owning its data)
+	const bool isView() {
+		return this->view_ != NULL;
+	}
+
+	// Returns false once a view's readout may have been overwritten by the camera (an owned image is always valid)
+	const bool isValid() {
+		return this->view_ == NULL || TimeStampGenerator::HostMicroS() < this->validUntil_;
+	}
+
+	// Returns pointer to data associated with the image (a view is converted to 8 bit on the first call)
 	unsigned char * getRawData() {
+		if (this->view_ != NULL && !this->converted_) {
+			this->convertView();
+		}
 		return this->data_;
 	}
 
+	// Calculate the fitness of the image, the average intensity within radius r of its center
+	// a view is read directly from the 16 bit readout (no copy or conversion)
+	// Output: average intensity scaled as 8 bit & unbinned (see Utility::FindAverageValue16())
+	double getTargetAverage(int r) {
+		if (this->view_ == NULL) {
+			return Utility::FindAverageValue(this->data_, this->width_, this->height_, r);
+		}
+		const double average = Utility::FindAverageValue16(this->view_, this->width_, this->height_, r, this->binning_);
+		if (!this->isValid()) {
+			Utility::printLine("WARNING: Image view was read after its readout may have been overwritten!");
+		}
+		return average;
+	}
+
 	// Return width of the Image
 	const int getWidth() {
 		return this->width_;
@@ -86,7 +176,7 @@ public:
 	// Output the image with given file path
 	void saveImage(std::string path) {
 		// PICam does not offer it's own method of saving images, so using OpenCV's
-		cv::imwrite(path, cv::Mat(this->height_, this->width_, CV_8UC1, this->data_));
+		cv::imwrite(path, cv::Mat(this->height_, this->width_, CV_8UC1, this->getRawData()));
 	}
 };
 
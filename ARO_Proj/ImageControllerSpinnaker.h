@@ -12,16 +12,20 @@
 #include "SpinGenApi\SpinnakerGenApi.h"
 using namespace Spinnaker::GenApi;
 
+#include "Utility.h" // Fitness of the image
+
 // Class to encaspsulate interactions required to accessing image data and current SDK
 //		(this is so that optimization classes aren't relying on an SDK's specific behaviors)
 class ImageController {
 private:
 	Spinnaker::ImagePtr image_; // Pointer to Image in Spinnaker SDK
 	bool needRelease;
+	bool view_;					// TRUE -> a pooled view that holds the camera's image without copying it (see CameraController::AcquireImageView())
 public:
 	ImageController() {
 		this->image_ = Spinnaker::Image::Create();
 		this->needRelease = false;
+		this->view_ = false;
 	}
 
 	// Constructor with set image to assign
@@ -32,6 +36,7 @@ public:
 		this->image_ = Spinnaker::Image::Create();
 		this->image_->DeepCopy(setImage);
 		this->needRelease = release;
+		this->view_ = false;
 	}
 
 	ImageController(ImageController & other) {
@@ -42,15 +47,51 @@ public:
 		this->image_ = Spinnaker::Image::Create();
 		this->image_->DeepCopy(other.getImage());
 		this->needRelease = other.getReleaseBool();
+		this->view_ = false;
 	}
 
 	// Desturctor - checks if need to call Release()
 	~ImageController() {
+		if (this->view_) {
+			this->releaseView();
+			return;
+		}
 		if (this->needRelease)
 			this->image_->Release();
 		this->image_->~IImage();
 	}
 
+	// Make the image a view holding the camera's image without copying it
+	// Input:	setImage - image to hold, such as one straight from the stream (GetNextImage()) or one converted from it
+	//			release - set to true if setImage is a stream buffer to be released back to the stream when the view is released
+	void setView(Spinnaker::ImagePtr & setImage, bool release) {
+		if (!this->view_) {
+			this->image_->~IImage();
+		}
+		this->image_ = setImage;
+		this->needRelease = release;
+		this->view_ = true;
+	}
+
+	// Let go of a view's image, releasing a stream buffer back to the stream (the view can then be set again)
+	void releaseView() {
+		if (this->needRelease) {
+			this->image_->Release();
+		}
+		this->needRelease = false;
+		this->image_ = NULL;
+	}
+
+	// Returns true if this is a pooled view (to be given back with CameraController::ReleaseImage())
+	const bool isView() {
+		return this->view_;
+	}
+
+	// A view holds its stream buffer until released, so it is always valid
+	const bool isValid() {
+		return true;
+	}
+
 	Spinnaker::ImagePtr getImage() {
 		return this->image_;
 	}
@@ -65,6 +106,11 @@ public:
 		return static_cast<unsigned char *>(this->image_->GetData());
 	}
 
+	// Calculate the fitness of the image, the average intensity within radius r of its center
+	double getTargetAverage(int r) {
+		return Utility::FindAverageValue(this->getRawData(), this->getWidth(), this->getHeight(), r);
+	}
+
 	// Return width of the Image
 	const int getWidth() {
 		return int(this->image_->GetWidth());
@@ -7,6 +7,8 @@
 #include "ImageScaler.h"
 
 #include <algorithm> // max() and min()
+#include <cstring>	 // memset() for 8-bit bin rows
+#include <cmath>	 // cos(), sin() & atan2() for averaging phases in InverseTranslateImage()
 
 // Constructor
 // Input: output_image_width - x diminsion size of output image
@@ -106,3 +108,84 @@ void ImageScaler::TranslateImage(int* input_image, unsigned char* output_image)
 		}
 	}
 }
+
+// Takes an array holding 8-bit phase values for each bin and fills an image with those values
+// Same layout as the int version, but as the genome value already fits in a byte each bin line is a single memset
+// Input: input_image - the array holding all the bin values
+//		 output_image - the array to store the output image (already allocated)
+// Output: output_image stores the results
+void ImageScaler::TranslateImage(const uint8_t* input_image, unsigned char* output_image) {
+	if (requirement_set_bin_size_ && requirement_set_used_bins_)
+	{	// prevent action if all steps to set up image scaling have not been completed
+		int start_point = top_remainder_y_ + left_remainder_x_;
+		for (int i = 0; i < used_bins_y_; i++)
+		{	// for each row
+			int line_start_point = start_point + (i*(bin_size_y_*output_image_width_));
+			for (int j = 0; j < used_bins_x_; j++)
+			{	// for each bin in the row
+				int bin_start_point = line_start_point + (j * bin_size_x_);
+				unsigned char pix_value = input_image[(i * used_bins_x_) + j];
+
+				for (int k = 0; k < bin_size_y_; k++)
+				{	// for each line in each bin
+					int write_start_point = bin_start_point + (k * output_image_width_);
+					if (output_image_depth_ == 1) {
+						memset(output_image + write_start_point, pix_value, bin_size_x_);
+					}
+					else {
+						for (int l = 0; l < bin_size_x_; l++)
+						{	// for each space in each line, upper byte of an 8-bit value is always 0
+							int write_point = write_start_point + l;
+							output_image[write_point*output_image_depth_] = pix_value;
+							output_image[(write_point*output_image_depth_) + 1] = 0;
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+// Takes an image (such as a saved phase mask) and finds the 8-bit phase value of each bin, the inverse of TranslateImage()
+// The pixels of a bin are averaged as phases (on the circle, so values either side of 0/255 average to near 0 rather than 128),
+// letting a mask saved with a different bin layout be brought down to the current bins
+// Input: input_image - image of the output size & depth (only the lower byte of each pixel is used)
+//		 output_bins - the array to store the bin values (already allocated, GetTotalBinNum() values)
+// Output: returns false if the scaler is not set up, otherwise output_bins stores the results
+bool ImageScaler::InverseTranslateImage(const unsigned char* input_image, uint8_t* output_bins) {
+	if (!requirement_set_bin_size_ || !requirement_set_used_bins_) {
+		return false;
+	}
+	const double PI = 3.14159265358979323846;
+	double cos_table[256], sin_table[256];
+	for (int v = 0; v < 256; v++) {
+		cos_table[v] = cos(2 * PI * v / 256.0);
+		sin_table[v] = sin(2 * PI * v / 256.0);
+	}
+	int start_point = top_remainder_y_ + left_remainder_x_;
+	for (int i = 0; i < used_bins_y_; i++)
+	{	// for each row
+		int line_start_point = start_point + (i*(bin_size_y_*output_image_width_));
+		for (int j = 0; j < used_bins_x_; j++)
+		{	// for each bin in the row
+			int bin_start_point = line_start_point + (j * bin_size_x_);
+			double sum_cos = 0, sum_sin = 0;
+			for (int k = 0; k < bin_size_y_; k++)
+			{	// for each line in each bin
+				int read_start_point = bin_start_point + (k * output_image_width_);
+				for (int l = 0; l < bin_size_x_; l++)
+				{	// for each space in each line
+					unsigned char pix_value = input_image[(read_start_point + l)*output_image_depth_];
+					sum_cos += cos_table[pix_value];
+					sum_sin += sin_table[pix_value];
+				}
+			}
+			double phase = atan2(sum_sin, sum_cos) * 256.0 / (2 * PI);
+			if (phase < 0) {
+				phase += 256;
+			}
+			output_bins[(i * used_bins_x_) + j] = uint8_t(int(phase + 0.5) & 255);
+		}
+	}
+	return true;
+}
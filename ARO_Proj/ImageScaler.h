@@ -5,6 +5,8 @@
 #ifndef IMAGE_SCALER_H_
 #define IMAGE_SCALER_H_
 
+#include <cstdint> // uint8_t genome overload of TranslateImage
+
 class ImageScaler {
 private:
 	int output_image_width_, output_image_height_, output_image_depth_;
@@ -22,6 +24,8 @@ public:
 	void SetUsedBins(int used_bins_x, int used_bins_y);
 	int GetTotalBinNum();
 	void TranslateImage(int* input_image, unsigned char* output_image);
+	void TranslateImage(const uint8_t* input_image, unsigned char* output_image);
+	bool InverseTranslateImage(const unsigned char* input_image, uint8_t* output_bins);
 	void ZeroOutputImage(unsigned char* output_image);
 };
 
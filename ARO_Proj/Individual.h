@@ -10,6 +10,7 @@
 template <class T>
 struct Individual {
 	// The genome associated with the individual.
+	// Points into the genome arena owned by the Population, the individual does not own (or delete) this memory
 	T * genome_;
 
 	// The fitness of the individual, this must be assigned with set_fitness
@@ -22,13 +23,6 @@ struct Individual {
 		this->fitness_ = -1;
 	}
 
-	// Destructor
-	~Individual() {
-		if (this->genome_ != NULL) {
-			delete[] this->genome_;
-		}
-	}
-
 	// Returns the array(genome) associated with the individual.
 	T * genome() const {
 		return this->genome_;
@@ -40,12 +34,9 @@ struct Individual {
 	}
 
 	// Sets the genome to be associated with the individual.
-	// Input: new_genome - genome to be set to this individual
-	// Output: new_genome is assigned, old genome is deleted
+	// Input: new_genome - genome to be set to this individual (memory is owned by the population's arena)
+	// Output: new_genome is assigned, the previous genome is left untouched
 	void set_genome(T * new_genome) {
-		if (this->genome_ != NULL) {
-			delete[] this->genome_;
-		}
 		this->genome_ = new_genome;
 	}
 
@@ -0,0 +1,153 @@
+////////////////////
+// MockSLM.cpp - implementation of the simulated SLM boards
+////////////////////
+
+#include "stdafx.h"		// Required in source
+#include "MockSLM.h"	// Header file
+
+#include <chrono>	// simulated frame time & trigger timeouts
+#include <thread>	// sleep_for()
+
+MockSLM::MockSLM(unsigned int SLM_bit_depth, unsigned int* n_boards_found, bool *constructed_ok, bool is_nematic_type,
+	bool RAM_write_enable, bool use_GPU_if_available, size_t max_transient_frames, const char* static_regional_lut_file) {
+	this->frame_time_ = 1000;
+	this->pending_triggers_ = 0;
+	this->stop_count_ = 0;
+	this->write_count_ = 0;
+	this->pulse_count_ = 0;
+	this->last_error_ = "Mock SLM: No error";
+	this->powered_.assign(BOARD_COUNT, false);
+	this->shown_.assign(BOARD_COUNT, std::vector<unsigned char>());
+	if (n_boards_found != NULL) {
+		*n_boards_found = BOARD_COUNT;
+	}
+	if (constructed_ok != NULL) {
+		*constructed_ok = true;
+	}
+}
+
+int MockSLM::Get_image_width(int board) const {
+	return (board >= 1 && board <= BOARD_COUNT) ? BOARD_SIZE : 0;
+}
+
+int MockSLM::Get_image_height(int board) const {
+	return (board >= 1 && board <= BOARD_COUNT) ? BOARD_SIZE : 0;
+}
+
+bool MockSLM::Load_LUT_file(int board, const char* LUT_file) {
+	return (board >= 1 && board <= BOARD_COUNT);
+}
+
+bool MockSLM::SLM_power(int board, bool power_state) {
+	if (board < 1 || board > BOARD_COUNT) {
+		return false;
+	}
+	std::unique_lock<std::mutex> lock(this->mutex_);
+	this->powered_[board - 1] = power_state;
+	return true;
+}
+
+void MockSLM::SLM_power(bool power_state) {
+	std::unique_lock<std::mutex> lock(this->mutex_);
+	this->powered_.assign(BOARD_COUNT, power_state);
+}
+
+int MockSLM::Compute_TF(float frame_rate) {
+	return (frame_rate > 0) ? int(1000.0f / frame_rate) : 0;
+}
+
+void MockSLM::Set_true_frames(int true_frames) {
+}
+
+bool MockSLM::Write_image(int board, const unsigned char* image, unsigned int image_size, bool wait_for_trigger, bool external_pulse, unsigned int trigger_timeout_ms) {
+	std::unique_lock<std::mutex> lock(this->mutex_);
+	if (board < 1 || board > BOARD_COUNT || image == NULL) {
+		this->last_error_ = "Mock SLM: Invalid board or image";
+		return false;
+	}
+	if (wait_for_trigger) {
+		// A timeout of 0 waits indefinitely (until a trigger or Stop_sequence())
+		const long long stopCount = this->stop_count_;
+		auto hasTrigger = [this, stopCount]() { return this->pending_triggers_ > 0 || this->stop_count_ != stopCount; };
+		if (trigger_timeout_ms > 0) {
+			this->trigger_listen_.wait_for(lock, std::chrono::milliseconds(trigger_timeout_ms), hasTrigger);
+		}
+		else {
+			this->trigger_listen_.wait(lock, hasTrigger);
+		}
+		if (this->stop_count_ != stopCount) {
+			this->last_error_ = "Mock SLM: Sequence stopped";
+			return false;
+		}
+		if (this->pending_triggers_ == 0) {
+			this->last_error_ = "Mock SLM: Trigger timeout";
+			return false;
+		}
+		this->pending_triggers_--;
+	}
+	const int frameTime = this->frame_time_;
+	PulseListener listener = this->listener_;
+	this->write_count_++;
+	lock.unlock();
+
+	// Image is shown once written (the listener sees the image as it is at the pulse)
+	std::this_thread::sleep_for(std::chrono::microseconds(frameTime));
+	lock.lock();
+	this->shown_[board - 1].assign(image, image + BOARD_SIZE * BOARD_SIZE);
+	lock.unlock();
+	if (external_pulse) {
+		lock.lock();
+		this->pulse_count_++;
+		lock.unlock();
+		if (listener) {
+			listener(board, image);
+		}
+	}
+	return true;
+}
+
+void MockSLM::Stop_sequence() {
+	std::unique_lock<std::mutex> lock(this->mutex_);
+	this->stop_count_++;
+	this->pending_triggers_ = 0;
+	this->trigger_listen_.notify_all();
+}
+
+const char* MockSLM::Get_last_error_message() const {
+	return this->last_error_.c_str();
+}
+
+void MockSLM::trigger() {
+	std::unique_lock<std::mutex> lock(this->mutex_);
+	this->pending_triggers_++;
+	this->trigger_listen_.notify_one();
+}
+
+void MockSLM::setPulseListener(PulseListener listener) {
+	std::unique_lock<std::mutex> lock(this->mutex_);
+	this->listener_ = listener;
+}
+
+void MockSLM::setFrameTime(int microseconds) {
+	std::unique_lock<std::mutex> lock(this->mutex_);
+	this->frame_time_ = (microseconds > 0) ? microseconds : 0;
+}
+
+long long MockSLM::getWriteCount() {
+	std::unique_lock<std::mutex> lock(this->mutex_);
+	return this->write_count_;
+}
+
+long long MockSLM::getPulseCount() {
+	std::unique_lock<std::mutex> lock(this->mutex_);
+	return this->pulse_count_;
+}
+
+bool MockSLM::copyShownImage(int board, std::vector<unsigned char> & image) {
+	std::unique_lock<std::mutex> lock(this->mutex_);
+	if (board < 1 || board > BOARD_COUNT || this->shown_[board - 1].empty()) {
+		return false;
+	}
+	image = this->shown_[board - 1];
+	return true;
+}
@@ -0,0 +1,75 @@
+////////////////////
+// MockSLM.h - stand in for the Blink SDK with simulated boards, so that SLM sequencing can be run & tested without hardware
+//		Built in place of Blink_SDK when USE_MOCK_SLM is defined (see SLMController.h), with the same methods as used from Blink_SDK
+//		Writes take a simulated frame time, writes waiting for a trigger block until trigger() is called (or time out)
+//		and writes raising an external pulse call the pulse listener (such as a simulated camera exposing on the pulse)
+////////////////////
+
+#ifndef MOCK_SLM_H_
+#define MOCK_SLM_H_
+
+#include <cstddef>				// size_t
+#include <functional>			// pulse listener
+#include <mutex>				// writes from the sequence writer while triggers come from another thread
+#include <condition_variable>	// writes waiting on a trigger
+#include <string>
+#include <vector>
+
+class MockSLM {
+public:
+	// Called when a written image raises the external pulse, with the board (1 based) and the image shown
+	typedef std::function<void(int board, const unsigned char* image)> PulseListener;
+
+	static const int BOARD_COUNT = 1;		// Number of simulated boards
+	static const int BOARD_SIZE = 512;		// Width & height of each simulated board
+
+private:
+	int frame_time_;			// Simulated time (microseconds) for an image to be written & shown
+	int pending_triggers_;		// Triggers received and not yet used by a write
+	long long stop_count_;		// Number of Stop_sequence() calls, a change releases waiting writes
+	long long write_count_;
+	long long pulse_count_;
+	std::string last_error_;
+	PulseListener listener_;
+	std::vector<bool> powered_;
+	std::vector<std::vector<unsigned char>> shown_;	// Image each board is showing (empty until the first write)
+
+	std::mutex mutex_;
+	std::condition_variable trigger_listen_;
+
+public:
+	// Constructor, same parameters as Blink_SDK (only n_boards_found & constructed_ok are used)
+	MockSLM(unsigned int SLM_bit_depth, unsigned int* n_boards_found, bool *constructed_ok, bool is_nematic_type = true,
+		bool RAM_write_enable = true, bool use_GPU_if_available = true, size_t max_transient_frames = 20U, const char* static_regional_lut_file = 0);
+
+	// [Blink SDK methods]
+	int Get_image_width(int board) const;
+	int Get_image_height(int board) const;
+	bool Load_LUT_file(int board, const char* LUT_file);
+	bool SLM_power(int board, bool power_state);
+	void SLM_power(bool power_state);
+	int Compute_TF(float frame_rate);
+	void Set_true_frames(int true_frames);
+	// Write an image, waiting for a trigger first if wait_for_trigger and raising the pulse once shown if external_pulse
+	// Output: returns false if the board is invalid, no trigger arrived within trigger_timeout_ms or the sequence was stopped
+	bool Write_image(int board, const unsigned char* image, unsigned int image_size, bool wait_for_trigger = false, bool external_pulse = false, unsigned int trigger_timeout_ms = 0);
+	// Release any write waiting on a trigger (it returns false), writes after this wait again
+	void Stop_sequence();
+	const char* Get_last_error_message() const;
+
+	// [Simulation controls]
+	// Raise the trigger input, letting one write waiting for a trigger go ahead (a trigger with no write waiting is kept for the next)
+	void trigger();
+	// Set the listener called on each external pulse (NULL to remove)
+	void setPulseListener(PulseListener listener);
+	// Set the simulated write time in microseconds (default 1000)
+	void setFrameTime(int microseconds);
+	// Get the number of images written & pulses raised
+	long long getWriteCount();
+	long long getPulseCount();
+	// Copy the image a board is showing (such as for a simulated camera exposing freely)
+	// Output: returns false if the board is invalid or has not been written to yet
+	bool copyShownImage(int board, std::vector<unsigned char> & image);
+};
+
+#endif
@@ -6,6 +6,8 @@
 #include "stdafx.h"				// Required in source
 #include "Optimization.h"		// Header file
 #include "Utility.h"			// use printLine()
+#include "SettlingCalibration.h"	// settle time calibration before a run
+#include <opencv2\imgproc\imgproc.hpp>	// resize() of warm start masks
 
 Optimization::Optimization(MainDialog* dlg, CameraController* cc, SLMController* sc) {
 	if (cc == nullptr) {
@@ -35,6 +37,28 @@ Optimization::Optimization(MainDialog* dlg, CameraController* cc, SLMController*
 	else {
 		this->skipEliteReevaluation = false;
 	}
+	// Checkpoint settings are in the dialog of the selected algorithm
+	CString checkpointBuff;
+	if (this->dlg->opt_selection_ == MainDialog::OptType::IA) {
+		this->dlg->m_ia_ControlDlg.m_checkpointInterval.GetWindowTextW(checkpointBuff);
+		this->resumeFromCheckpoint = (this->dlg->m_ia_ControlDlg.m_resumeFromCheckpoint.GetCheck() == BST_CHECKED);
+	}
+	else {
+		this->dlg->m_ga_ControlDlg.m_checkpointInterval.GetWindowTextW(checkpointBuff);
+		this->resumeFromCheckpoint = (this->dlg->m_ga_ControlDlg.m_resumeFromCheckpoint.GetCheck() == BST_CHECKED);
+	}
+	this->checkpointInterval = _tstoi(checkpointBuff);
+	// Warm start mask is also in the dialog of the selected algorithm
+	CString maskBuff;
+	if (this->dlg->opt_selection_ == MainDialog::OptType::IA) {
+		this->dlg->m_ia_ControlDlg.m_warmStartMask.GetWindowTextW(maskBuff);
+	}
+	else {
+		this->dlg->m_ga_ControlDlg.m_warmStartMask.GetWindowTextW(maskBuff);
+	}
+	this->warmStartMask = CT2A(maskBuff);
+	// Check if calibrating the settle time
+	this->calibrateSettling = (this->dlg->m_cameraControlDlg.m_calibrateSettling.GetCheck() == BST_CHECKED);
 }
 
 // [SETUP]
@@ -225,6 +249,11 @@ bool Optimization::prepareSoftwareHardware() {
 		Utility::printLine("INFO:   #" + std::to_string(this->optBoards[i]->board_id));
 	}
 
+	// Measure how long the SLM takes to settle, so frames are only used once it has
+	if (this->calibrateSettling && !this->optBoards.empty() && !this->runSettlingCalibration()) {
+		Utility::printLine("WARNING: Settling calibration failed, using a settle time of " + std::to_string(this->cc->settleTime) + " microseconds");
+	}
+
 	// - configure algorithm parameters
 	if (!prepareStopConditions()) {
 		Utility::printLine("ERROR: Preparing stop conditions has failed!");
@@ -239,6 +268,28 @@ bool Optimization::prepareSoftwareHardware() {
 	return true;
 }
 
+// Measure the settle time & latency of the first board being optimized, with the camera acquiring only for the calibration
+bool Optimization::runSettlingCalibration() {
+	Utility::printLine("INFO: Calibrating settling of SLM board #" + std::to_string(this->optBoards[0]->board_id));
+	SettlingCalibration calibration(this->cc, this->sc, this->optBoards[0]->board_id);
+	if (!this->cc->startCamera()) {
+		return false;
+	}
+	const bool calibrated = calibration.run(this->outputFolder + this->algorithm_name_ + "_settling_calibration.csv");
+	this->cc->stopCamera();
+	if (!calibrated) {
+		return false;
+	}
+	this->settlingCalibrated = true;
+	this->cc->settleTime = calibration.getSettleTime();
+	this->calibratedLatency = calibration.getLatency();
+	this->calibratedFramePeriod = calibration.getFramePeriod();
+	this->calibratedMaxRate = calibration.getMaxEvaluationRate();
+	Utility::printLine("INFO: SLM settles after " + std::to_string(this->cc->settleTime) + " microseconds, write to frame latency of " + std::to_string(this->calibratedLatency)
+		+ " microseconds, up to " + std::to_string(this->calibratedMaxRate) + " evaluations per second");
+	return true;
+}
+
 // For a given board setup and return a scaler
 // Input: slmNum (default 0 and 0 based) - index of board to set scaler with
 //        slmImg - char pointer to array with size equal to total area of board
@@ -257,6 +308,46 @@ ImageScaler* Optimization::setupScaler(unsigned char *slmImg, int slmNum = 0) {
 }
 
 // [SAVE/LOAD FEATURES]
+// Get the path of this algorithm's checkpoint file, kept in the output folder without a time stamp so a later run can find it
+std::string Optimization::checkpointPath() {
+	return this->outputFolder + this->algorithm_name_ + "_checkpoint.bin";
+}
+
+// Load a board's warm start mask and bring it down to the current bins (through the inverse of the board's scaling)
+bool Optimization::loadWarmStart(int boardIdx, uint8_t * bins) {
+	if (this->warmStartMask.empty()) {
+		return false;
+	}
+	std::string path = this->warmStartMask;
+	const size_t token = path.find("{board}");
+	if (token != std::string::npos) {
+		path.replace(token, 7, std::to_string(boardIdx + 1));
+	}
+	cv::Mat mask = cv::imread(path, CV_LOAD_IMAGE_GRAYSCALE);
+	if (mask.empty()) {
+		Utility::printLine("WARNING: Could not read warm start mask " + path + ", starting board #" + std::to_string(boardIdx + 1) + " from scratch");
+		return false;
+	}
+	const int width = int(this->sc->getBoardWidth(boardIdx));
+	const int height = int(this->sc->getBoardHeight(boardIdx));
+	if (mask.cols != width || mask.rows != height) {
+		// Nearest neighbour keeps the phases as they are (interpolating would blend across the 0/255 wrap)
+		Utility::printLine("WARNING: Warm start mask " + path + " is " + std::to_string(mask.cols) + "x" + std::to_string(mask.rows) + " rather than the board's " + std::to_string(width) + "x" + std::to_string(height) + ", resizing it");
+		cv::resize(mask, mask, cv::Size(width, height), 0, 0, cv::INTER_NEAREST);
+	}
+	if (!mask.isContinuous()) {
+		mask = mask.clone();
+	}
+	ImageScaler scaler(width, height, 1);
+	scaler.SetBinSize(this->cc->binSizeX, this->cc->binSizeY);
+	scaler.SetUsedBins(this->cc->numberOfBinsX, this->cc->numberOfBinsY);
+	if (!scaler.InverseTranslateImage(mask.data, bins)) {
+		return false;
+	}
+	Utility::printLine("INFO: Warm starting board #" + std::to_string(boardIdx + 1) + " from " + path);
+	return true;
+}
+
 // Output information of the parameters used in the optimization in to logs
 void Optimization::saveParameters(std::string time) {
 	std::ofstream paramFile(this->outputFolder + time + "_" + this->algorithm_name_ + "_Optimization_Parameters.txt");
@@ -269,7 +360,12 @@ void Optimization::saveParameters(std::string time) {
 		paramFile << "Max Stop Time - " << std::to_string(this->maxSecondsToStop) << std::endl;
 		paramFile << "Min Generation - " << std::to_string(this->genEvalToStop) << std::endl;
 		paramFile << "Max Generation - " << std::to_string(this->maxGenenerations) << std::endl;;
+		paramFile << "Run Seed - " << std::to_string(this->runSeed) << std::endl;
+	}
+	if (!this->warmStartMask.empty()) {
+		paramFile << "Warm Start Mask - " << this->warmStartMask << std::endl;
 	}
+	this->saveAlgorithmParameters(paramFile);
 	paramFile << "----------------------------------------------------------------" << std::endl;
 	paramFile << "CAMERA SETTINGS:" << std::endl;
 	paramFile << "AOI x0 - " << std::to_string(this->cc->x0) << std::endl;
@@ -279,11 +375,28 @@ void Optimization::saveParameters(std::string time) {
 	paramFile << "Acquisition Gamma - " << std::to_string(this->cc->gamma) << std::endl;
 	paramFile << "Acquisition FPS - " << std::to_string(this->cc->fps) << std::endl;
 	paramFile << "Acquisition Initial Exposure Time - " << std::to_string(this->cc->initialExposureTime) << std::endl;
+	paramFile << "Acquisition SLM Settle Time - " << std::to_string(this->cc->settleTime) << std::endl;
+	if (this->settlingCalibrated) {
+		paramFile << "Calibrated Write to Frame Latency - " << std::to_string(this->calibratedLatency) << std::endl;
+		paramFile << "Calibrated Frame Period - " << std::to_string(this->calibratedFramePeriod) << std::endl;
+		paramFile << "Calibrated Max Evaluation Rate - " << std::to_string(this->calibratedMaxRate) << std::endl;
+	}
 	paramFile << "Number of Bins X - " << std::to_string(this->cc->numberOfBinsX) << std::endl;
 	paramFile << "Number of Bins Y - " << std::to_string(this->cc->numberOfBinsY) << std::endl;
 	paramFile << "Bins Size X - " << std::to_string(this->cc->numberOfBinsX) << std::endl;
 	paramFile << "Bins Size Y - " << std::to_string(this->cc->numberOfBinsY) << std::endl;
 	paramFile << "Target Radius - " << std::to_string(this->cc->targetRadius) << std::endl;
+	if (this->cc->autoReadout) {
+		paramFile << "Auto Readout Margin - " << std::to_string(this->cc->autoReadoutMargin) << std::endl;
+		paramFile << "Auto Readout Binning - " << std::to_string(this->cc->readoutBinning) << std::endl;
+	}
+#ifdef USE_PICAM
+	paramFile << "Acquisition View Readouts - " << std::to_string(this->cc->viewReadouts) << std::endl;
+#endif
+#ifdef USE_SPINNAKER
+	paramFile << "Acquisition Stream Buffers - " << ((this->cc->streamBufferCount > 0) ? std::to_string(this->cc->streamBufferCount) : "Auto") << std::endl;
+	paramFile << "Acquisition Stream Buffer Handling - " << this->cc->streamBufferHandling << std::endl;
+#endif
 	paramFile << "----------------------------------------------------------------" << std::endl;
 	paramFile << "SLM SETTINGS:" << std::endl;
 	paramFile << "Board Amount - " << std::to_string(this->sc->numBoards) << std::endl;
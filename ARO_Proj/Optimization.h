@@ -11,6 +11,7 @@
 #include <vector> // For managing ind_threads
 #include <thread> // For ind_threads used in runOptimization
 #include <mutex>  // Mutexes to protect identified critical sections
+#include <cstdint> // runSeed
 
 #include "MainDialog.h"			// used for UI reference
 #include "CameraController.h"	// pointer to access custom interface with camera and images
@@ -31,6 +32,7 @@ protected:
 	double acceptedSimilarity = .97;  // images considered the same when reach this threshold (has to be less than 1)
 	double maxFitnessValue = 200;  // max allowed fitness value - when reached exposure is halved (TODO: check this feature)
 	double maxGenenerations = 3000; // max number of generations to perform
+	uint64_t runSeed = 0; // seed all random streams of a run are derived from (0 -> a random seed is picked at start of run)
 
 	//Base algorithm stop conditions
 	double fitnessToStop = 0;
@@ -51,6 +53,25 @@ protected:
 	bool multithreadEnable = true;  // TRUE -> use multithreading
 	bool skipEliteReevaluation = false; // TRUE -> Will skip running elite individuals that should already have a fitness value
 
+	//Checkpoint parameters (see Checkpoint.h)
+	int checkpointInterval = 0;		// Generations (bins for brute force) between checkpoints written to the output folder (0 -> no checkpoints)
+	bool resumeFromCheckpoint = false;	// TRUE -> continue from this algorithm's checkpoint in the output folder if there is one
+
+	//Warm start parameters
+	//	Instead of random genomes (or a blank image for brute force) start from a saved phase mask, such as the _phaseopt_ images of an earlier run
+	std::string warmStartMask = "";		// Path of the mask to start from, "{board}" is replaced with the board ID (empty -> no warm start)
+	double warmStartPerturbRate = 0.05;	// Chance of each gene being changed in the copies of the mask filling the rest of a population
+	int warmStartPerturbStep = 16;		// Largest phase change of a changed gene in those copies
+
+	//Settling calibration parameters & results (see SettlingCalibration.h)
+	//	Before the run, step patterns are written to the first board being optimized to measure how long the SLM takes to settle,
+	//	the camera then only uses frames exposed that long after each write and the results are saved with the run parameters
+	bool calibrateSettling = false;		// TRUE -> calibrate before the run (replaces the camera's settle time)
+	bool settlingCalibrated = false;	// Set once a calibration has given results
+	double calibratedLatency = 0;		// Mean time (microseconds) from a write to the first frame exposed after it being acquired
+	double calibratedFramePeriod = 0;	// Mean time (microseconds) between frames at full rate
+	double calibratedMaxRate = 0;		// Most evaluations per second the settle time & frame period allow
+
 	//Instance variables (used during optimization process)
 	// Values assigned within setupInstanceVariables(), then if needed cleared in shutdownOptimizationInstance()
 	bool isWorking = false;		// true if currently actively running the optimization algorithm
@@ -94,10 +115,25 @@ protected:
 	// Output: returns true if either input is greater than compared against OR the MainDialog's stopFlag has been set to true
 	bool const stopConditionsReached(double curFitness, double curSecPassed, double curGenerations);
 
+	// Load the warm start mask for a board and bring it down to the current bins
+	// Input: boardIdx - index of the board the mask is for (0 based), bins - array of at least numberOfBinsX*numberOfBinsY values
+	// Output: returns false if there is no mask to use (bins is left unchanged), otherwise bins holds the phase of each bin of the mask
+	bool loadWarmStart(int boardIdx, uint8_t * bins);
+
+	// Measure the settle time & latency of the first board being optimized, setting the camera's settle time
+	// Output: returns false if the calibration failed (the settle time is left unchanged)
+	bool runSettlingCalibration();
+
+	// Get the path of this algorithm's checkpoint file ("this->outputFolder/[optType]_checkpoint.bin")
+	std::string checkpointPath();
+
 	// Save the various setting parameters used in this optimization
 	// Stores the values with formatting in "this->outputFolder/[time]_[optType]_Optimization_Parameters.txt"
 	// Input: time - the current time as a string label
 	void saveParameters(std::string time);
+	// Write the settings of the algorithm itself, called by saveParameters() after the base optimization settings
+	// Input: paramFile - the open parameters file
+	virtual void saveAlgorithmParameters(std::ofstream & paramFile) {}
 
 	// Methods relying on implementation from child classes
 	virtual bool setupInstanceVariables() = 0;		 // Setting up properties used in runOptimization()
@@ -6,9 +6,18 @@
 #ifndef POPULATION_H_
 #define POPULATION_H_
 
+#include <malloc.h>		// _aligned_malloc() & _aligned_free() for the genome arena
+#include <cstring>		// memcpy() in DeepCopyIndividual()
+#include <algorithm>	// nth_element() & sort() in rankIndividuals()
+#include <cmath>		// exp(), log() & sqrt() for adaptive mutation
+
 #include "Individual.h"
 #include "BetterRandom.h"	// Randomizer in generateRandomImage() & Crossover()
+#include "CrossoverKernel.h"	// blend() & mutate() used in Crossover()
 #include "Utility.h"		// For printLine() & rejoinClear() & generateRandomImage()
+#include "DiversityTracker.h"	// Sketches of genomes to check for convergence
+#include "SurrogateModel.h"		// Prescreening of children
+#include "Checkpoint.h"			// Saving & restoring the population's state
 
 #include "threadPool.h"
 
@@ -17,12 +26,30 @@ class Population {
 protected:
 	// The array of individuals in the population.
 	Individual<T>* individuals_;
+	// The array of individuals being bred for the next generation, swapped with individuals_ by swapGenerations()
+	Individual<T>* next_individuals_;
+	// Contiguous block holding the genomes of both individuals_ and next_individuals_ (2*pop_size_ genomes)
+	// Allocated once at construction so breeding a generation does no heap allocation
+	T* genome_arena_;
+	// Distance (in elements) between the start of two genomes in the arena, genome_length_ padded to GENOME_ALIGNMENT
+	int genome_stride_;
 	// Number of individuals in the population.
 	int pop_size_;
 	// Number of individuals in the population that are to be kept as elite.
 	int elite_size_;
 	// Percentage of genome that must be shared for images to be counted as similar
 	double accepted_similarity_;
+	// Chance of each gene in a child being mutated when mutation is used (0.5%), with adaptive mutation the (geometric) mean over the individuals
+	double mutation_rate_ = 1.0 / 200;
+	// Largest phase change of a mutated gene, 0 -> mutated genes are replaced with a random value instead (with adaptive mutation the mean over the individuals)
+	double mutation_step_ = 0;
+	// Self-adaptive mutation, each genome carries its own mutation rate (and step) that its children inherit with a random change (see inheritMutation())
+	bool adaptive_mutation_ = false;
+	double min_mutation_rate_, max_mutation_rate_;
+	double mutation_spread_ = 0.3;	// Standard deviation of the log of the random change of an inherited rate or step
+	// Mutation rate & step carried by the genome in each arena slot (used with adaptive mutation)
+	double * slot_rate_;
+	double * slot_step_;
 	// genome length for individual images
 	int genome_length_;
 	// bool to track if multithreading is enabled or not
@@ -34,11 +61,56 @@ protected:
 	// Pointer to thread pool to give jobs for
 	threadPool * myThreadPool_;
 
-	// Array to store results of crossovers to determine if a refresh is needed
-	bool * same_check;
+	// Sketches of every genome slot in the arena, used to decide if a refresh is needed and to report diversity
+	DiversityTracker<T> * diversity_;
+	// Diversity of the last bred generation (mean fraction of sampled genes differing from the best)
+	double last_diversity_;
+	// Work array of slot indices for measuring diversity
+	int * measure_slots_;
+
+	// Permutation of individual indices by fitness (worst first), set by rankIndividuals()
+	// Only the last topCount entries are guaranteed to be in sorted order, individuals_ itself is never reordered
+	int * order_;
 
 	// Pointer (or array if multithreading is used) of random number generator being used
 	BetterRandom * rng_machines;
+	// Seed all of this population's random streams are derived from
+	uint64_t seed_;
+	// Number of generations bred so far, used to give each generation its own random streams
+	int generation_;
+
+	// Prescreening of children with a surrogate model (see setScreening())
+	SurrogateModel * surrogate_;	// Model shared by every population of a run, NULL if not screening
+	int surrogate_board_;			// Which board of the model this population is
+	int screen_candidates_;			// Number of candidates bred for each child, the best scoring is kept
+	double * screen_weights_;		// This generation's copy of the board's weights
+	bool screen_ready_;				// If screen_weights_ can be used this generation (the model has fitted enough samples)
+
+	// Byte alignment of each genome in the arena (cache line size)
+	static const int GENOME_ALIGNMENT = 64;
+
+	// Reseed the RNG machines for the current generation, each thread's machine gets its own stream of (seed_, generation_, thread)
+	// Output: breeding with the same seed, generation and thread count gives the same results
+	void reseedMachines() {
+		const int machineCount = this->multiThread_ ? this->threadCount_ : 1;
+		for (int i = 0; i < machineCount; i++) {
+			this->rng_machines[i].seed(this->seed_, (uint64_t(this->generation_) << 16) | uint64_t(i));
+		}
+	}
+
+	// Advance to the next generation's random streams, to be called at the start of nextGeneration()
+	void advanceGeneration() {
+		this->generation_++;
+		this->reseedMachines();
+	}
+
+	// Swap the current and next generation arrays, to be called at the end of nextGeneration()
+	// Output: individuals_ now holds the bred generation, next_individuals_ holds the old one (its genomes are free to be overwritten)
+	void swapGenerations() {
+		Individual<T>* temp = this->individuals_;
+		this->individuals_ = this->next_individuals_;
+		this->next_individuals_ = temp;
+	}
 
 public:
 	// Constructor
@@ -50,7 +122,8 @@ public:
 	//  multiThread:		 enable usage of multithreading (default true)
 	// _threadCount:		 when multithread is enabled, defines how many threads this population will use
 	//  myThreadPool:		 set the thread pool to be used when multithreading enabled
-	Population(int genome_length, int population_size, int elite_size, double accepted_similarity = .9, bool multiThread = true, int _threadCount = std::thread::hardware_concurrency(), threadPool * myThreadPool = NULL){
+	//  seed:				 seed for the population's random streams, 0 picks a random seed (default 0)
+	Population(int genome_length, int population_size, int elite_size, double accepted_similarity = .9, bool multiThread = true, int _threadCount = std::thread::hardware_concurrency(), threadPool * myThreadPool = NULL, uint64_t seed = 0){
 		this->genome_length_ = genome_length;
 		this->accepted_similarity_ = accepted_similarity;
 		this->pop_size_ = population_size;
@@ -58,6 +131,12 @@ public:
 		this->multiThread_ = multiThread;
 		this->threadCount_ = _threadCount;
 		this->myThreadPool_ = myThreadPool;
+		this->generation_ = 0;
+		if (seed == 0) {
+			std::random_device rd;
+			seed = (uint64_t(rd()) << 32) | rd();
+		}
+		this->seed_ = seed;
 
 		// Check to see if elite size exceeds the population size, currently just gives warning
 		if (this->elite_size_ > this->pop_size_) {
@@ -75,20 +154,51 @@ public:
 			this->rng_machines = new BetterRandom[1];
 		}
 
+		this->reseedMachines();
+
+		// Setup the genome arena, with the first half for current generation and the second for the next
+		const int elementsPerLine = (GENOME_ALIGNMENT >= sizeof(T)) ? int(GENOME_ALIGNMENT / sizeof(T)) : 1;
+		this->genome_stride_ = ((this->genome_length_ + elementsPerLine - 1) / elementsPerLine) * elementsPerLine;
+		this->genome_arena_ = (T*)_aligned_malloc(sizeof(T) * size_t(this->genome_stride_) * 2 * this->pop_size_, GENOME_ALIGNMENT);
+
 		this->individuals_ = new Individual<T>[this->pop_size_];
-		this->same_check = new bool[this->pop_size_ - this->elite_size_];
+		this->next_individuals_ = new Individual<T>[this->pop_size_];
+		this->order_ = new int[this->pop_size_];
+		this->diversity_ = new DiversityTracker<T>(this->genome_length_, 2 * this->pop_size_, this->seed_);
+		this->measure_slots_ = new int[this->pop_size_];
+		this->last_diversity_ = 1;
+		this->surrogate_ = NULL;
+		this->surrogate_board_ = 0;
+		this->screen_candidates_ = 1;
+		this->screen_weights_ = NULL;
+		this->screen_ready_ = false;
+		this->min_mutation_rate_ = this->mutation_rate_ / 4;
+		this->max_mutation_rate_ = 0.05;
+		this->slot_rate_ = new double[2 * this->pop_size_];
+		this->slot_step_ = new double[2 * this->pop_size_];
+		this->resetSlotMutation();
 
 		for (int i = 0; i < this->pop_size_; i++) {
-			this->individuals_[i].set_genome(Utility::generateRandomImage<T>(this->genome_length_, this->rng_machines));
+			this->individuals_[i].set_genome(this->genome_arena_ + size_t(i) * this->genome_stride_);
+			this->next_individuals_[i].set_genome(this->genome_arena_ + size_t(this->pop_size_ + i) * this->genome_stride_);
+			this->RandomizeIndividual(this->individuals_[i], this->rng_machines);
 		}
 		Utility::printLine("INFO: Population created!");
 	}
 
-	//Destructor - delete individuals and call rejoinClear() to clear ind_threads
-	~Population() {
+	//Destructor - delete individuals and the genome arena they point into
+	//	(virtual, populations are deleted through base pointers)
+	virtual ~Population() {
 		delete[] this->individuals_;
-		delete[] this->same_check;
+		delete[] this->next_individuals_;
+		_aligned_free(this->genome_arena_);
+		delete this->diversity_;
+		delete[] this->measure_slots_;
+		delete[] this->order_;
 		delete[] this->rng_machines;
+		delete[] this->screen_weights_;
+		delete[] this->slot_rate_;
+		delete[] this->slot_step_;
 	}
 
 	Individual<T> * getIndividual(int i) {
@@ -131,88 +241,342 @@ public:
 		return this->individuals_[i].fitness();
 	}
 
+	// Get the genome length of the individuals
+	const int getGenomeLength() const {
+		return this->genome_length_;
+	}
+
+	// Get index of the individual with the highest fitness (ties go to the higher index, so the elite after nextGeneration())
+	int getBestIndex() const {
+		int best = this->pop_size_ - 1;
+		for (int i = this->pop_size_ - 2; i >= 0; i--) {
+			if (this->individuals_[i].fitness() > this->individuals_[best].fitness()) {
+				best = i;
+			}
+		}
+		return best;
+	}
+
+	// Replace the least fit individual with a copy of a given genome (such as a migrant from another population)
+	// Input: genome - genome to copy in (genome_length_ long, must not be in this population), fitness - its fitness (-1 if to be evaluated)
+	// Output: the least fit individual now holds the copy with the given fitness
+	void replaceWorst(const T * genome, double fitness) {
+		int worst = 0;
+		for (int i = 1; i < this->pop_size_; i++) {
+			if (this->individuals_[i].fitness() < this->individuals_[worst].fitness()) {
+				worst = i;
+			}
+		}
+		memcpy(this->individuals_[worst].genome(), genome, sizeof(T) * this->genome_length_);
+		this->individuals_[worst].set_fitness(fitness);
+		this->updateSketch(this->individuals_[worst]);
+		this->slot_rate_[this->slotOf(this->individuals_[worst])] = this->mutation_rate_;
+		this->slot_step_[this->slotOf(this->individuals_[worst])] = this->mutation_step_;
+	}
+
+	// Warm start the population from a known good genome (such as a previously optimized phase mask), replacing the random initial genomes
+	//		The best (last) individual is an exact copy and the rest are copies with small phase changes, all to be evaluated
+	// Input: genome - genome to start from (genome_length_ long), perturbRate - chance of each gene being changed in the copies,
+	//		perturbStep - largest phase change of a changed gene (1 to 128)
+	void seedGenome(const T * genome, double perturbRate, int perturbStep) {
+		BetterRandom seedRNG(BetterRandom::deriveSeed(this->seed_, uint64_t(this->generation_)), uint64_t(4) << 48);
+		for (int i = 0; i < this->pop_size_; i++) {
+			memcpy(this->individuals_[i].genome(), genome, sizeof(T) * this->genome_length_);
+			if (i < this->pop_size_ - 1) {
+				CrossoverKernel::perturb(this->individuals_[i].genome(), this->genome_length_, perturbRate, perturbStep, &seedRNG);
+			}
+			this->individuals_[i].set_fitness(-1);
+			this->updateSketch(this->individuals_[i]);
+			this->slot_rate_[this->slotOf(this->individuals_[i])] = this->mutation_rate_;
+			this->slot_step_[this->slotOf(this->individuals_[i])] = this->mutation_step_;
+		}
+	}
+
+	// Pick an individual by tournament, the fittest of tournamentSize individuals drawn at random (used by the steady-state GA)
+	// Input: tournamentSize - number of individuals competing, rng_machine - the RNG to draw with
+	// Output: returns index of the winning individual
+	int tournamentSelect(int tournamentSize, BetterRandom * rng_machine) const {
+		int winner = int((uint64_t(rng_machine->nextWord()) * uint64_t(this->pop_size_)) >> 32);
+		for (int i = 1; i < tournamentSize; i++) {
+			const int challenger = int((uint64_t(rng_machine->nextWord()) * uint64_t(this->pop_size_)) >> 32);
+			if (this->individuals_[challenger].fitness() > this->individuals_[winner].fitness()) {
+				winner = challenger;
+			}
+		}
+		return winner;
+	}
+
+	// Breed a child genome from two individuals into a buffer outside of the population (used by the steady-state GA)
+	// Input: parentA, parentB - indices of the parents, child - buffer of genome_length_ to write to, rng_machine - the RNG to use
+	// Output: child holds uniform crossover of the parents with mutation
+	void breedGenome(int parentA, int parentB, T * child, BetterRandom * rng_machine) const {
+		CrossoverKernel::blend(this->individuals_[parentA].genome(), this->individuals_[parentB].genome(), child, this->genome_length_, rng_machine);
+		this->mutateGenes(child, this->genome_length_, -1, rng_machine);
+	}
+
+	// Move the best individual to the last index, as it is after nextGeneration() (individuals are swapped, no genome is copied)
+	void placeBestLast() {
+		const int best = this->getBestIndex();
+		if (best != this->pop_size_ - 1) {
+			swapIndividuals(this->individuals_[best], this->individuals_[this->pop_size_ - 1]);
+		}
+	}
+
+	// Measure the diversity of the current individuals against the best, for when generations are not bred by nextGeneration()
+	// Output: returns mean fraction of (sampled) genes that differ from the best individual, the best is moved to the last index
+	double measureDiversity() {
+		this->placeBestLast();
+		this->isConverged(this->individuals_);
+		return this->last_diversity_;
+	}
+
+	// Setter & getter for the chance of each gene mutating when mutation is used (setting also resets the rate carried by every genome)
+	void setMutationRate(double rate) {
+		this->mutation_rate_ = rate;
+		this->resetSlotMutation();
+	}
+	double getMutationRate() const {
+		return this->mutation_rate_;
+	}
+
+	// Setter & getter for the largest phase change of a mutated gene (0 -> mutated genes are replaced with a random value, the default)
+	void setMutationStep(double step) {
+		this->mutation_step_ = (step > 0) ? ((step < 128) ? step : 128) : 0;
+		this->resetSlotMutation();
+	}
+	double getMutationStep() const {
+		return this->mutation_step_;
+	}
+
+	// Set if each genome carries its own mutation rate (and step) that adapts by selection, see inheritMutation()
+	//	(uGA populations only mutate when adaptive)
+	// Input: adaptive - TRUE to adapt, minRate & maxRate - bounds of the mutation rate (minRate 0 -> a quarter of the current rate)
+	void setAdaptiveMutation(bool adaptive, double minRate = 0, double maxRate = 0.05) {
+		this->adaptive_mutation_ = adaptive;
+		this->min_mutation_rate_ = (minRate > 0) ? minRate : this->mutation_rate_ / 4;
+		this->max_mutation_rate_ = (maxRate > this->min_mutation_rate_) ? maxRate : this->min_mutation_rate_;
+	}
+
+	// Set every arena slot's mutation rate & step to the population's
+	void resetSlotMutation() {
+		for (int i = 0; i < 2 * this->pop_size_; i++) {
+			this->slot_rate_[i] = this->mutation_rate_;
+			this->slot_step_[i] = this->mutation_step_;
+		}
+	}
+
+	// Give a child its mutation rate & step when adaptive, the geometric mean of its parents' changed by a random log-normal factor
+	//		Genomes whose rate suits the current stage of the run breed fitter children, so selection tunes the rates (high early, low once converging)
+	// Input: a, b - genomes of the parents (in this population's arena), child - the individual being bred, rng_machine - the RNG to use
+	// Output: the child's slot holds its rate & step (unchanged if not adaptive)
+	void inheritMutation(const T * a, const T * b, const Individual<T> & child, BetterRandom * rng_machine) const {
+		if (!this->adaptive_mutation_) {
+			return;
+		}
+		const int slotA = this->slotOfGenome(a), slotB = this->slotOfGenome(b), slot = this->slotOf(child);
+		double rate = sqrt(this->slot_rate_[slotA] * this->slot_rate_[slotB]) * exp(this->mutation_spread_ * rng_machine->normal());
+		this->slot_rate_[slot] = (rate < this->min_mutation_rate_) ? this->min_mutation_rate_ : ((rate > this->max_mutation_rate_) ? this->max_mutation_rate_ : rate);
+		if (this->mutation_step_ > 0) {
+			const double step = sqrt(this->slot_step_[slotA] * this->slot_step_[slotB]) * exp(this->mutation_spread_ * rng_machine->normal());
+			this->slot_step_[slot] = (step < 1) ? 1 : ((step > 128) ? 128 : step);
+		}
+	}
+
+	// Mutate genes of a child, as full resets or (with a mutation step) small phase perturbations
+	// Input: genes - start of the genes to mutate, length - number of genes, slot - arena slot of the child (-1 for a genome outside the arena), rng_machine - the RNG to use
+	void mutateGenes(T * genes, int length, int slot, BetterRandom * rng_machine) const {
+		const bool ownRate = (this->adaptive_mutation_ && slot >= 0);
+		const double rate = ownRate ? this->slot_rate_[slot] : this->mutation_rate_;
+		if (this->mutation_step_ > 0) {
+			CrossoverKernel::perturb(genes, length, rate, int((ownRate ? this->slot_step_[slot] : this->mutation_step_) + 0.5), rng_machine);
+		}
+		else {
+			CrossoverKernel::mutate(genes, length, rate, rng_machine);
+		}
+	}
+
+	// Update the population's mutation rate & step to the (geometric) mean over the current individuals when adaptive, to be called at the end of nextGeneration()
+	void updateMutationRate() {
+		if (!this->adaptive_mutation_) {
+			return;
+		}
+		double logRate = 0, logStep = 0;
+		for (int i = 0; i < this->pop_size_; i++) {
+			const int slot = this->slotOf(this->individuals_[i]);
+			logRate += log(this->slot_rate_[slot]);
+			logStep += (this->mutation_step_ > 0) ? log(this->slot_step_[slot]) : 0;
+		}
+		this->mutation_rate_ = exp(logRate / this->pop_size_);
+		if (this->mutation_step_ > 0) {
+			this->mutation_step_ = exp(logStep / this->pop_size_);
+		}
+	}
+
+	// Set a surrogate model to prescreen children with, candidates are bred for each child and the best scoring is kept
+	// Input:
+	//	surrogate - the model (owned by the caller), NULL to stop screening
+	//	board - index of this population's board in the model
+	//	candidates - number of candidates bred for each child (1 disables screening)
+	void setScreening(SurrogateModel * surrogate, int board, int candidates) {
+		this->surrogate_ = surrogate;
+		this->surrogate_board_ = board;
+		this->screen_candidates_ = (candidates > 1) ? candidates : 1;
+		delete[] this->screen_weights_;
+		this->screen_weights_ = (surrogate != NULL) ? new double[surrogate->getBoardWeightCount()] : NULL;
+		this->screen_ready_ = false;
+	}
+
+	// Take this generation's copy of the surrogate's weights, to be called once before breeding
+	// Output: returns true if children should be screened this generation
+	bool prepareScreening() {
+		this->screen_ready_ = (this->surrogate_ != NULL && this->screen_candidates_ > 1 && this->surrogate_->copyBoardWeights(this->surrogate_board_, this->screen_weights_));
+		return this->screen_ready_;
+	}
+
+	// Score a candidate child with the surrogate (after prepareScreening() returned true), higher is better
+	double screenScore(const T * genome) const {
+		return this->surrogate_->scoreBoard(this->screen_weights_, genome);
+	}
+
+	// Get the diversity of the most recently bred generation
+	// Output: mean fraction of (sampled) genes that differ from the best individual, 0 meaning fully converged
+	double getDiversity() const {
+		return this->last_diversity_;
+	}
+
 	// Crosses over information between individual genomes
 	// Input:
 	//	a - First individual to be crossed over.
 	//	b - Second individual to be crossed over.
-	//	same_check - boolean will be set to false if the arrays are different.
+	//	child - individual to store the result in (its genome is a slot of the genome arena, must not be a or b)
 	//  useMutation - boolean set if to perform mutation or not, defaults to true (enable).
-	// Output: returns new genome as result of crossover algorithm
-	T * Crossover(const T * a, const  T * b, bool& same_check, const bool useMutation, BetterRandom * rng_machine) const {
-		T * temp = new T[this->genome_length_];
-		double same_counter = 0; // counter keeping track of how many indices in the genomes are the same
-		// Variabales to hold results for easier readiblity or possible adjustments
-		bool choice, mutate;
-		T mutateVal;
-		// For each index in the genome
-		for (int i = 0; i < this->genome_length_; i++) {
-			// Set booleans
-			choice = ((100 * (*rng_machine)()) / RAND_MAX) < 50;
-			mutate = ((200 * (*rng_machine)()) / RAND_MAX) == 0;
-
-			// 50% chance of coming from either parent
-			if (choice) {
-				temp[i] = a[i];
-			}
-			else {
-				temp[i] = b[i];
-			}
-			// if the values at an index are the same, increment the same counter
-			if (a[i] == b[i])	{
-				same_counter += 1;
-			}
-			// mutation occuring if useMutation and at 0.05% chance
-			if (mutate && useMutation)	{
-				// Set mutate value
-				mutateVal = T(((256 * (*rng_machine)()) / RAND_MAX));
-				temp[i] = (T)mutateVal;
-			}
-		} // ... End image creation
+	// Output: child is filled with new genome as result of crossover algorithm and its sketch updated, fitness reset to -1
+	void Crossover(const T * a, const  T * b, Individual<T> & child, const bool useMutation, BetterRandom * rng_machine) const {
+		// Blend the parents (50% chance of each gene coming from either parent)
+		CrossoverKernel::blend(a, b, child.genome(), this->genome_length_, rng_machine);
+		// mutation occuring if useMutation, each gene at mutation_rate_ chance (or the child's own rate when adaptive)
+		if (useMutation) {
+			this->inheritMutation(a, b, child, rng_machine);
+			this->mutateGenes(child.genome(), this->genome_length_, this->slotOf(child), rng_machine);
+		}
+		child.set_fitness(-1);
+		this->updateSketch(child);
+	}
 
-		// if the percentage of indices that are the same is less than the accepted similarity, label the two genomes as not the same (same_check = false)
-		same_counter /= this->genome_length_;
-		if (same_counter < this->accepted_similarity_) {
-			same_check = false;
+	// Fill an individual with a random genome
+	// Input: ind - individual to randomize, rng_machine - the RNG to use
+	// Output: ind has a new random genome and its sketch updated
+	void RandomizeIndividual(Individual<T> & ind, BetterRandom * rng_machine) const {
+		Utility::generateRandomImage<T>(ind.genome(), this->genome_length_, rng_machine);
+		this->updateSketch(ind);
+		this->slot_rate_[this->slotOf(ind)] = this->mutation_rate_;
+		this->slot_step_[this->slotOf(ind)] = this->mutation_step_;
+	}
+
+	// Get which slot of the genome arena an individual's genome is in
+	int slotOf(const Individual<T> & ind) const {
+		return this->slotOfGenome(ind.genome());
+	}
+	int slotOfGenome(const T * genome) const {
+		return int((genome - this->genome_arena_) / this->genome_stride_);
+	}
+
+	// Update the diversity sketch of an individual, to be called after its genome is written by other means than Crossover() or RandomizeIndividual()
+	void updateSketch(const Individual<T> & ind) const {
+		this->diversity_->update(this->slotOf(ind), ind.genome());
+	}
+
+	// Check if a generation has converged, every individual being at least accepted_similarity_ similar to the best
+	//		Works from the genome sketches in O(pop_size_), genome memory is not read
+	// Input: generation - array of pop_size_ individuals with the best at the last index
+	// Output: returns true if converged, last_diversity_ is updated
+	bool isConverged(const Individual<T> * generation) {
+		for (int i = 0; i < this->pop_size_ - 1; i++) {
+			this->measure_slots_[i] = this->slotOf(generation[i]);
 		}
-		return temp;
+		return this->diversity_->measure(this->measure_slots_, this->pop_size_ - 1, this->slotOf(generation[this->pop_size_ - 1]), this->accepted_similarity_, this->last_diversity_);
 	}
 
-	// Sorts an array of individuals
-	//		Currently (August 31 2021) this is using selection sort and shallow copies (the pointers get swapped, not the "actual" genome data)
+	// Rank the individuals by fitness into order_ without moving any individuals or genomes
+	//		Uses nth_element to find the top individuals in O(n) then sorts only those, so the cost is O(n + topCount*log(topCount))
 	// Input:
-	//	to_sort - the individuals to be sorted
-	//	size - the size of the array to_sort
-	// Output: the to_sort pointer now points to array of individuals that are sorted
-	void SortIndividuals(Individual<T> * to_sort, int size) {
-		int smallest_index = 0;
-
-		for (int i = 0; i < size - 1; i++) {
-			smallest_index = i;
-
-			for (int j = i + 1; j < size; j++)	{
-				if (to_sort[j].fitness() < to_sort[smallest_index].fitness()) {
-					smallest_index = j;
-				}
-			}
-			if (smallest_index != i) {
-				swapIndividuals(to_sort[i], to_sort[smallest_index]);
-			}
+	//	topCount - number of fittest individuals that must be in sorted order (such as elite_size_)
+	// Output: order_[pop_size_ - 1] is the index of the best individual, order_[pop_size_ - topCount .. pop_size_ - 1] are in ascending fitness,
+	//		   the rest of order_ holds the remaining (less fit) indices in no particular order
+	void rankIndividuals(int topCount) {
+		for (int i = 0; i < this->pop_size_; i++) {
+			this->order_[i] = i;
+		}
+		if (topCount > this->pop_size_) {
+			topCount = this->pop_size_;
 		}
+		if (topCount <= 0) {
+			return;
+		}
+		const Individual<T> * pool = this->individuals_;
+		auto lessFit = [pool](int a, int b) { return pool[a].fitness() < pool[b].fitness(); };
+		int * topStart = this->order_ + (this->pop_size_ - topCount);
+		if (topCount < this->pop_size_) {
+			std::nth_element(this->order_, topStart, this->order_ + this->pop_size_, lessFit);
+		}
+		std::sort(topStart, this->order_ + this->pop_size_, lessFit);
 	}
 
 	// Deep copies the genome & resulting image from one individual to another
 	// Input:
-	//	to - the individual to be copied to
+	//	to - the individual to be copied to (genome already pointing into the arena)
 	//	from - the individual copied
-	// Output: to is contains deep copy of from
-	void DeepCopyIndividual(Individual<T> & to, Individual<T> & from) const {
+	// Output: to is contains deep copy of from (including its sketch)
+	void DeepCopyIndividual(Individual<T> & to, const Individual<T> & from) const {
 		to.set_fitness(from.fitness());
-		T * temp_genome1 = new T[this->genome_length_];
-		T * temp_genome2 = from.genome();
-		for (int i = 0; i < this->genome_length_; i++) {
-			temp_genome1[i] = temp_genome2[i];
+		memcpy(to.genome(), from.genome(), sizeof(T) * this->genome_length_);
+		this->diversity_->copy(this->slotOf(to), this->slotOf(from));
+		this->slot_rate_[this->slotOf(to)] = this->slot_rate_[this->slotOf(from)];
+		this->slot_step_[this->slotOf(to)] = this->slot_step_[this->slotOf(from)];
+	}
+
+	// Save the state of the population to a checkpoint, to be called between generations
+	//		Every random stream is derived from the seed & generation count, so saving those restores the RNG streams exactly
+	// Input: out - checkpoint being written
+	void saveState(CheckpointWriter & out) const {
+		out.put(this->pop_size_);
+		out.put(this->genome_length_);
+		out.put(this->seed_);
+		out.put(this->generation_);
+		out.put(this->mutation_rate_);
+		out.put(this->mutation_step_);
+		for (int i = 0; i < this->pop_size_; i++) {
+			const int slot = this->slotOf(this->individuals_[i]);
+			out.put(this->individuals_[i].fitness());
+			out.put(this->slot_rate_[slot]);
+			out.put(this->slot_step_[slot]);
+			out.putBytes(this->individuals_[i].genome(), sizeof(T) * this->genome_length_);
 		}
-		to.set_genome(temp_genome1);
+	}
+
+	// Restore the state of the population from a checkpoint written by saveState()
+	// Input: in - checkpoint being read
+	// Output: returns false if the checkpoint does not match this population (sizes differ or it is cut short), the population may then be partly restored
+	bool loadState(CheckpointReader & in) {
+		int popSize = 0, genomeLength = 0;
+		if (!in.get(popSize) || !in.get(genomeLength) || popSize != this->pop_size_ || genomeLength != this->genome_length_) {
+			Utility::printLine("ERROR: Checkpoint population size or genome length does not match!");
+			return false;
+		}
+		if (!in.get(this->seed_) || !in.get(this->generation_) || !in.get(this->mutation_rate_) || !in.get(this->mutation_step_)) {
+			return false;
+		}
+		for (int i = 0; i < this->pop_size_; i++) {
+			const int slot = this->slotOf(this->individuals_[i]);
+			double fitness;
+			if (!in.get(fitness) || !in.get(this->slot_rate_[slot]) || !in.get(this->slot_step_[slot]) || !in.getBytes(this->individuals_[i].genome(), sizeof(T) * this->genome_length_)) {
+				return false;
+			}
+			this->individuals_[i].set_fitness(fitness);
+			this->updateSketch(this->individuals_[i]);
+		}
+		this->reseedMachines();
+		return true;
 	}
 
 	// Perform the genetic algorithm to create new individuals for next gneeration
@@ -220,6 +584,19 @@ public:
 	// Output: False if error occurs, otherwise True
 	virtual bool nextGeneration() = 0;
 
+	// Start breeding the next generation before every individual of this one has been evaluated (speculative breeding)
+	//	Children are bred with speculateRange() while the rest are evaluated, nextGeneration() then corrects them with the full fitness
+	// Input: evaluatedIDs - indices of the individuals that have their fitness for this generation, count - number of them
+	// Output: returns true if speculation was started, false if not supported (default) and nextGeneration() breeds as usual
+	virtual bool prepareSpeculation(const int * evaluatedIDs, int count) {
+		return false;
+	}
+
+	// Breed a share of the speculated children, called from pool threads after prepareSpeculation() returned true
+	// Input: threadID - index of this share, numThreads - number of shares
+	virtual void speculateRange(int threadID, int numThreads) {
+	}
+
 }; // ... class Population
 
 #endif
@@ -15,12 +15,17 @@ bool SGA_Optimization::setupInstanceVariables() {
 	// Get how many populations to have (same as number of boards being optimized)
 	this->popCount = int(this->optBoards.size());
 
-	// Setting population vector
-	// For threadCount, it is the number of threads in total allowed divided by number of boards
-	this->population.clear();
-	for (int i = 0; i < this->popCount; i++) {
-		this->population.push_back(new SGAPopulation<int>(this->cc->numberOfBinsY * this->cc->numberOfBinsX * this->cc->populationDensity,
-			this->populationSize, this->eliteSize, this->acceptedSimilarity, this->multithreadEnable, (this->gaPoolThreadCount / int(this->optBoards.size())), this->myThreadPool_));
+	// Getting how parents are selected from the GUI
+	const int selection = this->dlg->m_ga_ControlDlg.m_selectionType.GetCurSel();
+	this->selectionType = (selection == CB_ERR) ? SELECTION_PROPORTIONATE : SelectionType(selection);
+	CString tournamentBuff;
+	this->dlg->m_ga_ControlDlg.m_tournamentSize.GetWindowTextW(tournamentBuff);
+	this->tournamentSize = _tstoi(tournamentBuff);
+	this->tiledBreeding = (this->dlg->m_ga_ControlDlg.m_tiledBreeding.GetCheck() == BST_CHECKED);
+
+	// Setting population vector (one population per board on each island)
+	if (!this->setupPopulations()) {
+		return false;
 	}
 
 	this->shortenExposureFlag = false;		// Set to true by individual if fitness is too high
@@ -57,7 +62,7 @@ bool SGA_Optimization::setupInstanceVariables() {
 	//Open up files to which progress will be logged
 	if (this->logAllFiles || this->saveTimeVSFitness) {
 		this->timePerGenFile.open(this->outputFolder + this->algorithm_name_ + "_timePerformance.txt");
-		this->timePerGenFile << "SGA Generation,Individuals Time (microseconds),NextGeneration Time (microseconds),Overall Generation Time (microseconds),";
+		this->timePerGenFile << "SGA Generation,Individuals Time (microseconds),NextGeneration Time (microseconds),Overall Generation Time (microseconds),Diversity,Mutation Rate,Mutation Step,Scale Time,Hardware Wait Time,Write Time,Acquire Time,Fitness Time (mean microseconds per evaluation),";
 		// Also for easier tracking, outputing the thread counts as well
 		this->timePerGenFile << "Eval Individuals Threads," << this->indThreadCount << ",Next Generation Threads, " << this->gaPoolThreadCount << "\n";
 
@@ -73,6 +78,27 @@ bool SGA_Optimization::setupInstanceVariables() {
 	return true; // Returning true if no issues met
 }
 
+// Method to create one SGA population for setupPopulations()
+// For threadCount, it is the number of threads in total allowed divided by number of boards
+Population<uint8_t>* SGA_Optimization::createPopulation(uint64_t seed, bool multiThread) {
+	SGAPopulation<uint8_t> * newPop = new SGAPopulation<uint8_t>(this->cc->numberOfBinsY * this->cc->numberOfBinsX * this->cc->populationDensity,
+		this->populationSize, this->eliteSize, this->acceptedSimilarity, multiThread, (this->gaPoolThreadCount / int(this->optBoards.size())), this->myThreadPool_, seed);
+	newPop->setSelection(this->selectionType, this->tournamentSize);
+	newPop->setTiledBreeding(this->tiledBreeding);
+	return newPop;
+}
+
+// Method to write the SGA's settings to the parameters file
+void SGA_Optimization::saveAlgorithmParameters(std::ofstream & paramFile) {
+	GA_Optimization::saveAlgorithmParameters(paramFile);
+	const std::string selectionNames[] = { "Proportionate", "Rank", "Tournament" };
+	paramFile << "Parent Selection - " << selectionNames[this->selectionType] << std::endl;
+	if (this->selectionType == SELECTION_TOURNAMENT) {
+		paramFile << "Tournament Size - " << std::to_string(this->tournamentSize) << std::endl;
+	}
+	paramFile << "Tiled Breeding - " << (this->tiledBreeding ? "true" : "false") << std::endl;
+}
+
 // Method to clean up & save resulting runOptimziation() instance
 bool SGA_Optimization::shutdownOptimizationInstance() {
 
@@ -80,13 +106,8 @@ bool SGA_Optimization::shutdownOptimizationInstance() {
 
 	// Only save images if not aborting (successful results)
 	if (this->dlg->stopFlag == false && this->saveResultImages) {
-		// Get elite info
-		unsigned char* eliteImage = this->bestImage->getRawData();
-		int imgHeight = this->bestImage->getHeight();
-		int imgWidth = this->bestImage->getWidth();
-
-		// Save how final optimization looks through camera
-		this->cc->saveImage(this->bestImage, this->outputFolder + curTime + "_" + this->algorithm_name_ + "_Optimized.bmp");
+		// Save how final optimization looks through camera (no camera image if resumed from a checkpoint and the elite was not evaluated again)
+		if (this->bestImage != NULL) this->cc->saveImage(this->bestImage, this->outputFolder + curTime + "_" + this->algorithm_name_ + "_Optimized.bmp");
 
 		// Save final (most fit SLM images)
 		for (int popID = 0; popID < this->population.size(); popID++) {
@@ -138,10 +159,7 @@ bool SGA_Optimization::shutdownOptimizationInstance() {
 	if (this->bestImage != NULL) {
 		delete this->bestImage;
 	}
-	for (int i = 0; i < this->population.size(); i++) {
-		delete this->population[i];
-	}
-	this->population.clear();
+	this->deletePopulations();
 
 	if (this->timestamp != NULL) {
 		delete this->timestamp;
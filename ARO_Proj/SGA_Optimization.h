@@ -10,12 +10,23 @@
 #include "SGA_Population.h"
 
 class SGA_Optimization : public GA_Optimization {
+	// How parents are selected when breeding
+	SelectionType selectionType = SELECTION_PROPORTIONATE;
+	int tournamentSize = 2; // Number of individuals competing in each draw when using tournament selection
+	bool tiledBreeding = false; // TRUE -> breed children tile by tile across the genome so parents are read from memory once per generation (off by default, per-child breeding is the reference behaviour)
+
 	// Method to setup specific properties for SGA
 	bool setupInstanceVariables();
 
+	// Method to create one SGA population for setupPopulations()
+	Population<uint8_t>* createPopulation(uint64_t seed, bool multiThread);
+
 	// Method to clean up & save resulting SGA instance
 	bool shutdownOptimizationInstance();
 
+	// Method to write the SGA's settings to the parameters file
+	void saveAlgorithmParameters(std::ofstream & paramFile);
+
 public:
 	// Constructor - inherits from base class
 	SGA_Optimization(MainDialog* dlg, CameraController* cc, SLMController* sc) : GA_Optimization(dlg, cc, sc) {
@@ -7,9 +7,298 @@
 #define SGAPOPULATION_H_
 
 #include "Population.h"
+#include "Selection.h"	// ParentSelector for choosing parents
 
 template <class T>
 class SGAPopulation : public Population<T> {
+protected:
+	// Parent selection, rebuilt from the sorted pool at the start of each nextGeneration()
+	ParentSelector selector_;
+
+	// TRUE -> breed tile by tile across the genome (see breedTiled()) rather than one child at a time
+	bool tiled_breeding_;
+	// Pool indices of the two parents of each child, chosen up front when breeding tiled
+	int * parent_ids_;
+
+	// Speculative breeding (see prepareSpeculation())
+	bool speculated_;				// TRUE -> children of the next generation have been bred early, nextGeneration() only corrects them
+	ParentSelector spec_selector_;	// Parent selection built from the individuals evaluated when speculation started
+	Individual<T> * spec_pool_;		// The individuals evaluated when speculation started
+	int * spec_ids_;				// Index of each spec_pool_ individual in individuals_
+	int spec_count_;				// Number of individuals evaluated when speculation started
+	double * full_prob_;			// Chance of each individual being a parent with every fitness known
+	double * spec_prob_;			// Chance of each individual having been picked as a parent when speculating
+	int * rebreed_ids_;				// Children that must be bred again because a parent changed
+
+	// Target size in bytes of the data touched by one tile (parent & child slices), sized to fit in a core's L2 cache
+	static const int TILE_BYTES = 256 * 1024;
+	// Tiles are a multiple of this many genes, each chunk of a child has its own random stream (one batch of crossover mask words)
+	static const int RNG_CHUNK = CrossoverKernel::WORD_BATCH * 32;
+
+	// Breed a child with its own random stream, so the result doesn't depend on which thread breeds it
+	// Input: child - index of the child in temp, temp - generation to breed into, pool - generation to draw parents from, stream - random stream for this (generation, child)
+	void breedChild(int child, Individual<T> * temp, const Individual<T> * pool, uint64_t stream) const {
+		BetterRandom childRNG(BetterRandom::deriveSeed(this->seed_, uint64_t(this->generation_)), stream);
+		this->Crossover(pool[this->parent_ids_[2 * child]].genome(), pool[this->parent_ids_[2 * child + 1]].genome(), temp[child], true, &childRNG);
+	}
+
+	// Breed the children of the next generation with surrogate prescreening, screen_candidates_ candidates are bred for each child and the best scoring is kept
+	//		Each candidate has its own random stream, so the kept candidate is bred again from its stream if it wasn't the last one bred
+	// Input:
+	//	temp - individuals to breed into (the next generation)
+	//	pool - current generation to draw parents from
+	//	selector - parent selection built for this generation
+	// Output: temp[0 .. pop_size_-elite_size_) are bred, their fitness reset and sketches updated
+	void breedScreened(Individual<T> * temp, const Individual<T> * pool, const ParentSelector * selector) {
+		const int childCount = this->pop_size_ - this->elite_size_;
+		const uint64_t genSeed = BetterRandom::deriveSeed(this->seed_, uint64_t(this->generation_));
+
+		// Lambda function to breed a share of the children
+		// Input: threadID - current thread index
+		//		  numThreads - total number of threads being launched
+		// Captures: temp, pool - generations to breed into and from
+		//			selector - parent selection built for this generation
+		//			genSeed - seed of this generation's streams
+		//			childCount - number of children to breed
+		//			this - pointer to current population instance
+		auto screenSubGroup = [temp, pool, selector, genSeed, childCount, this](const int threadID, const int numThreads) {
+			int groupSize = childCount / numThreads;
+			int remainder = childCount - groupSize*numThreads;
+			int start_index = threadID*groupSize;
+
+			if (remainder != 0) {
+				if (threadID < remainder) {
+					groupSize++;
+					start_index += threadID;
+				}
+				else {
+					start_index += remainder;
+				}
+			}
+			for (int id = start_index; id < start_index + groupSize && id < childCount; id++) {
+				int bestCandidate = 0;
+				double bestScore = 0;
+				for (int c = 0; c < this->screen_candidates_; c++) {
+					BetterRandom candidateRNG(genSeed, (uint64_t(2) << 48) | (uint64_t(id) << 16) | uint64_t(c));
+					const T * parent1 = pool[selector->select(&candidateRNG)].genome();
+					const T * parent2 = pool[selector->select(&candidateRNG)].genome();
+					this->Crossover(parent1, parent2, temp[id], true, &candidateRNG);
+					const double score = this->screenScore(temp[id].genome());
+					if (c == 0 || score > bestScore) {
+						bestScore = score;
+						bestCandidate = c;
+					}
+				}
+				if (bestCandidate != this->screen_candidates_ - 1) {
+					BetterRandom candidateRNG(genSeed, (uint64_t(2) << 48) | (uint64_t(id) << 16) | uint64_t(bestCandidate));
+					const T * parent1 = pool[selector->select(&candidateRNG)].genome();
+					const T * parent2 = pool[selector->select(&candidateRNG)].genome();
+					this->Crossover(parent1, parent2, temp[id], true, &candidateRNG);
+				}
+			}
+		}; // .. screenSubGroup
+
+		if (this->multiThread_) { // Parallel
+			for (int i = 0; i < this->threadCount_; i++) {
+				this->myThreadPool_->pushJob(std::bind(screenSubGroup, i, this->threadCount_));
+			}
+			this->myThreadPool_->wait();
+		}
+		else { // Serial
+			screenSubGroup(0, 1);
+		}
+	}
+
+	// Correct speculated children now that every fitness is known
+	//		Each parent picked when speculating (with chance g) is kept with chance min(1, f/g) where f is its chance with every fitness known,
+	//		otherwise it is redrawn from what is left of f (max(0, f - g)). This gives parents exactly as if picked after all the evaluations,
+	//		only children with a redrawn parent are bred again (with fitness proportionate selection, only children with a parent among the late individuals)
+	// Input: temp - the next generation holding the speculated children, pool - the current generation
+	// Output: temp[0 .. pop_size_-elite_size_) are as if bred after the evaluations, their fitness reset and sketches updated
+	void finishSpeculation(Individual<T> * temp, const Individual<T> * pool) {
+		const int childCount = this->pop_size_ - this->elite_size_;
+		this->selector_.probabilities(this->full_prob_);
+		this->spec_selector_.probabilities(this->spec_prob_);
+		// spec_prob_ is by spec_pool_ index, spread out to individuals_ indices (in place, from the back as spec_ids_ is ascending)
+		for (int i = this->pop_size_ - 1, j = this->spec_count_ - 1; i >= 0; i--) {
+			if (j >= 0 && this->spec_ids_[j] == i) {
+				this->spec_prob_[i] = this->spec_prob_[j];
+				j--;
+			}
+			else {
+				this->spec_prob_[i] = 0;
+			}
+		}
+		double residualSum = 0;
+		for (int i = 0; i < this->pop_size_; i++) {
+			residualSum += (this->full_prob_[i] > this->spec_prob_[i]) ? this->full_prob_[i] - this->spec_prob_[i] : 0;
+		}
+
+		BetterRandom fixRNG(BetterRandom::deriveSeed(this->seed_, uint64_t(this->generation_)), ~uint64_t(0) - 1);
+		int rebreedCount = 0;
+		for (int i = 0; i < childCount; i++) {
+			bool changed = false;
+			for (int p = 2 * i; p < 2 * i + 2; p++) {
+				const int parent = this->parent_ids_[p];
+				if (residualSum > 0 && fixRNG.uniform() * this->spec_prob_[parent] >= this->full_prob_[parent]) {
+					// Redraw from the residual
+					double u = fixRNG.uniform() * residualSum;
+					int redraw = -1;
+					for (int k = 0; k < this->pop_size_; k++) {
+						const double residual = (this->full_prob_[k] > this->spec_prob_[k]) ? this->full_prob_[k] - this->spec_prob_[k] : 0;
+						if (residual > 0) {
+							redraw = k; // (if rounding leaves u past the end, the last with a residual is used)
+							if (u < residual) {
+								break;
+							}
+							u -= residual;
+						}
+					}
+					this->parent_ids_[p] = redraw;
+					changed = true;
+				}
+			}
+			if (changed) {
+				this->rebreed_ids_[rebreedCount++] = i;
+			}
+		}
+
+		// Lambda function to breed again a share of the children with a changed parent
+		// Input: threadID - current thread index
+		//		  numThreads - total number of threads being launched
+		// Captures: temp, pool - generations to breed into and from
+		//			rebreedCount - number of children to breed again
+		//			this - pointer to current population instance
+		auto rebreedSubGroup = [temp, pool, rebreedCount, this](const int threadID, const int numThreads) {
+			int groupSize = rebreedCount / numThreads;
+			int remainder = rebreedCount - groupSize*numThreads;
+			int start_index = threadID*groupSize;
+
+			if (remainder != 0) {
+				if (threadID < remainder) {
+					groupSize++;
+					start_index += threadID;
+				}
+				else {
+					start_index += remainder;
+				}
+			}
+			for (int id = start_index; id < start_index + groupSize && id < rebreedCount; id++) {
+				this->breedChild(this->rebreed_ids_[id], temp, pool, (uint64_t(1) << 32) | uint64_t(this->rebreed_ids_[id]));
+			}
+		}; // .. rebreedSubGroup
+
+		if (rebreedCount > 0) {
+			if (this->multiThread_) {
+				for (int i = 0; i < this->threadCount_; i++) {
+					this->myThreadPool_->pushJob(std::bind(rebreedSubGroup, i, this->threadCount_));
+				}
+				this->myThreadPool_->wait();
+			}
+			else {
+				rebreedSubGroup(0, 1);
+			}
+		}
+		this->speculated_ = false;
+	}
+
+	// Breed the children of the next generation tile by tile
+	//		The genome is split in tiles small enough that the slices of every parent for a tile stay in L2 while all of the children's slices are made,
+	//		so each parent is pulled from memory once per generation rather than once per child using it
+	//		Threads are given tiles rather than children, each (generation, child, chunk of the tile) has its own random stream so results do not depend on thread count or tile size
+	// Input:
+	//	temp - individuals to breed into (the next generation)
+	//	pool - current generation to draw parents from
+	//	selector - parent selection built for this generation
+	// Output: temp[0 .. pop_size_-elite_size_) are bred, their fitness reset and sketches updated
+	void breedTiled(Individual<T> * temp, const Individual<T> * pool, const ParentSelector * selector) {
+		const int childCount = this->pop_size_ - this->elite_size_;
+		if (childCount <= 0) {
+			return;
+		}
+		const uint64_t genSeed = BetterRandom::deriveSeed(this->seed_, uint64_t(this->generation_));
+
+		// Choose all the parents (and mutation rates when adaptive) first (from one stream) so every tile agrees on them
+		BetterRandom parentRNG(genSeed, ~uint64_t(0));
+		for (int i = 0; i < childCount; i++) {
+			this->parent_ids_[2 * i] = selector->select(&parentRNG);
+			this->parent_ids_[2 * i + 1] = selector->select(&parentRNG);
+			this->inheritMutation(pool[this->parent_ids_[2 * i]].genome(), pool[this->parent_ids_[2 * i + 1]].genome(), temp[i], &parentRNG);
+		}
+
+		// Size tiles so the parent slices (at most one per individual) and child slices together fit in TILE_BYTES
+		const int parentSlices = (2 * childCount < this->pop_size_) ? 2 * childCount : this->pop_size_;
+		int tileGenes = int(TILE_BYTES / (sizeof(T) * (parentSlices + childCount)));
+		tileGenes = (tileGenes / RNG_CHUNK) * RNG_CHUNK;
+		if (tileGenes < RNG_CHUNK) {
+			tileGenes = RNG_CHUNK;
+		}
+		// Use smaller tiles if needed so that every thread gets work
+		const int machineCount = this->multiThread_ ? this->threadCount_ : 1;
+		const int chunkCount = (this->genome_length_ + RNG_CHUNK - 1) / RNG_CHUNK;
+		if (machineCount > 1 && (this->genome_length_ + tileGenes - 1) / tileGenes < machineCount) {
+			const int chunksPerTile = (chunkCount + machineCount - 1) / machineCount;
+			tileGenes = ((chunksPerTile > 0) ? chunksPerTile : 1) * RNG_CHUNK;
+		}
+		const int tileCount = (this->genome_length_ + tileGenes - 1) / tileGenes;
+		const int * parent_ids = this->parent_ids_;
+
+		// Lambda function to breed every child's slice of a range of tiles
+		// Input: threadID - current thread index
+		//		  numThreads - total number of threads being launched
+		// Captures: temp, pool - generations to breed into and from
+		//			parent_ids - chosen parents of each child
+		//			genSeed - seed of this generation's streams
+		//			tileGenes, tileCount, childCount - tiling of the genome
+		//			this - pointer to current population instance
+		auto breedTiles = [temp, pool, parent_ids, genSeed, tileGenes, tileCount, childCount, this](const int threadID, const int numThreads) {
+			int groupSize = tileCount / numThreads;
+			int remainder = tileCount - groupSize*numThreads;
+			int start_index = threadID*groupSize;
+
+			if (remainder != 0) {
+				if (threadID < remainder) {
+					groupSize++;
+					start_index += threadID;
+				}
+				else {
+					start_index += remainder;
+				}
+			}
+			for (int tile = start_index; tile < start_index + groupSize && tile < tileCount; tile++) {
+				const int tileStart = tile * tileGenes;
+				const int tileEnd = (this->genome_length_ - tileStart < tileGenes) ? this->genome_length_ : tileStart + tileGenes;
+				for (int i = 0; i < childCount; i++) {
+					const T * parent1 = pool[parent_ids[2 * i]].genome();
+					const T * parent2 = pool[parent_ids[2 * i + 1]].genome();
+					T * child = temp[i].genome();
+					const int childSlot = this->slotOf(temp[i]);
+					for (int start = tileStart; start < tileEnd; start += RNG_CHUNK) {
+						const int length = (tileEnd - start < RNG_CHUNK) ? (tileEnd - start) : RNG_CHUNK;
+						BetterRandom chunkRNG(genSeed, (uint64_t(i) << 32) | uint64_t(start / RNG_CHUNK));
+						CrossoverKernel::blend(parent1 + start, parent2 + start, child + start, length, &chunkRNG);
+						this->mutateGenes(child + start, length, childSlot, &chunkRNG);
+					}
+				}
+			}
+		}; // .. breedTiles
+
+		if (this->multiThread_) { // Parallel
+			for (int i = 0; i < this->threadCount_; i++) {
+				this->myThreadPool_->pushJob(std::bind(breedTiles, i, this->threadCount_));
+			}
+			this->myThreadPool_->wait();
+		}
+		else { // Serial
+			breedTiles(0, 1);
+		}
+
+		for (int i = 0; i < childCount; i++) {
+			temp[i].set_fitness(-1);
+			this->updateSketch(temp[i]);
+		}
+	}
+
 public:
 	// Constructor
 	// Input:
@@ -20,60 +309,137 @@ public:
 	//  multiThread:		 enable usage of multithreading (default true)
 	// _threadCount:		 when multithread is enabled, defines how many threads this population will use
 	//  myThreadPool:		 set the thread pool to be used when multithreading enabled
-	SGAPopulation(int genome_length, int population_size, int elite_size, double accepted_similarity = .9, bool multiThread = true, int _threadCount = std::thread::hardware_concurrency(), threadPool * myThreadPool = NULL)
-		: Population<T>(genome_length, population_size, elite_size, accepted_similarity, multiThread, _threadCount, myThreadPool) {};
+	//  seed:				 seed for the population's random streams, 0 picks a random seed (default 0)
+	SGAPopulation(int genome_length, int population_size, int elite_size, double accepted_similarity = .9, bool multiThread = true, int _threadCount = std::thread::hardware_concurrency(), threadPool * myThreadPool = NULL, uint64_t seed = 0)
+		: Population<T>(genome_length, population_size, elite_size, accepted_similarity, multiThread, _threadCount, myThreadPool, seed) {
+		this->tiled_breeding_ = false;
+		this->parent_ids_ = new int[2 * this->pop_size_];
+		this->speculated_ = false;
+		this->spec_pool_ = new Individual<T>[this->pop_size_];
+		this->spec_ids_ = new int[this->pop_size_];
+		this->spec_count_ = 0;
+		this->full_prob_ = new double[this->pop_size_];
+		this->spec_prob_ = new double[this->pop_size_];
+		this->rebreed_ids_ = new int[this->pop_size_];
+	};
+
+	// Destructor
+	~SGAPopulation() {
+		delete[] this->parent_ids_;
+		delete[] this->spec_pool_;
+		delete[] this->spec_ids_;
+		delete[] this->full_prob_;
+		delete[] this->spec_prob_;
+		delete[] this->rebreed_ids_;
+	}
+
+	// Set how parents are selected when breeding (default is fitness proportionate)
+	// Input: type - the selection scheme, tournamentSize - number competing in each draw for tournament selection
+	void setSelection(SelectionType type, int tournamentSize = 2) {
+		this->selector_.setType(type);
+		this->selector_.setTournamentSize(tournamentSize);
+		this->spec_selector_.setType(type);
+		this->spec_selector_.setTournamentSize(tournamentSize);
+	}
+
+	// Set if children are bred tile by tile across the genome (better for large genomes) or one child at a time (default)
+	void setTiledBreeding(bool tiled) {
+		this->tiled_breeding_ = tiled;
+	}
+
+	// Start breeding the next generation's children from the individuals evaluated so far, see Population::prepareSpeculation()
+	//		Parents are picked from the evaluated individuals only, nextGeneration() then keeps or redraws each parent (see finishSpeculation())
+	// Input: evaluatedIDs - indices of the individuals that have their fitness for this generation, count - number of them
+	// Output: returns true if speculation was started, the children are to be bred with speculateRange()
+	bool prepareSpeculation(const int * evaluatedIDs, int count) {
+		const int childCount = this->pop_size_ - this->elite_size_;
+		// (not used with prescreening, children are screened with the model as it is after the whole generation)
+		if (childCount <= 0 || count <= 0 || count > this->pop_size_ || (this->surrogate_ != NULL && this->screen_candidates_ > 1)) {
+			return false;
+		}
+		// Move onto this generation's random streams (nextGeneration() won't move on again)
+		this->advanceGeneration();
+
+		memcpy(this->spec_ids_, evaluatedIDs, sizeof(int) * count);
+		std::sort(this->spec_ids_, this->spec_ids_ + count);
+		for (int i = 0; i < count; i++) {
+			this->spec_pool_[i] = this->individuals_[this->spec_ids_[i]];
+		}
+		this->spec_count_ = count;
+		if (!this->spec_selector_.build(this->spec_pool_, count)) {
+			return false;
+		}
+		BetterRandom parentRNG(BetterRandom::deriveSeed(this->seed_, uint64_t(this->generation_)), ~uint64_t(0));
+		for (int i = 0; i < childCount; i++) {
+			this->parent_ids_[2 * i] = this->spec_ids_[this->spec_selector_.select(&parentRNG)];
+			this->parent_ids_[2 * i + 1] = this->spec_ids_[this->spec_selector_.select(&parentRNG)];
+		}
+		this->speculated_ = true;
+		return true;
+	}
+
+	// Breed a share of the speculated children, called from pool threads (does not use the pool itself)
+	// Input: threadID - index of this share, numThreads - number of shares
+	void speculateRange(int threadID, int numThreads) {
+		const int childCount = this->pop_size_ - this->elite_size_;
+		int groupSize = childCount / numThreads;
+		int remainder = childCount - groupSize*numThreads;
+		int start_index = threadID*groupSize;
+
+		if (remainder != 0) {
+			if (threadID < remainder) {
+				groupSize++;
+				start_index += threadID;
+			}
+			else {
+				start_index += remainder;
+			}
+		}
+		for (int id = start_index; id < start_index + groupSize && id < childCount; id++) {
+			this->breedChild(id, this->next_individuals_, this->individuals_, uint64_t(id));
+		}
+	}
 
 	// Starts next generation using fitness of individuals.  Following the simple genetic algorithm approach.
 	bool nextGeneration() {
-		// Setting individuals to sorted (best is at end of the array)
-		SortIndividuals(this->individuals_, this->pop_size_);
+		// Move onto this generation's random streams (already done if the children were speculated)
+		if (!this->speculated_) {
+			this->advanceGeneration();
+		}
 
-		// calculate total fitness of all individuals (necessary for fitness proportionate selection)
-		double fitness_sum = 0;
-		for (int i = 0; i < this->pop_size_; i++) {
-			fitness_sum += this->individuals_[i].fitness();
+		// Find the elites (best at the end of order_), individuals stay where they are
+		this->rankIndividuals(this->elite_size_);
+
+		// Prepare parent selection for this generation (tables built once, then each draw is O(1), selection does not need a sorted pool)
+		if (!this->selector_.build(this->individuals_, this->pop_size_)) {
+			this->speculated_ = false;
+			return false;
 		}
 
-		// Breeding
-		Individual<T> * temp = new Individual<T>[this->pop_size_];
+		// Breeding, into the next generation half of the genome arena
+		Individual<T> * temp = this->next_individuals_;
 		Individual<T> * pool = this->individuals_;
-		const double divisor = RAND_MAX / fitness_sum;
+		const int * order = this->order_;
+		const ParentSelector * selector = &this->selector_;
 
 		// Lambda function to be used for generating new individual
 		// Input: i - index for new individual
 		// Captures:
 		//		temp			- pointer to array of individuals to store current new individual at temp[i]
-		//		divisor			- used in proportionate selection
+		//		selector		- parent selection built for this generation (const, safe to share between threads)
 		//		individuals_	- access population genomes
 		//		this			- access Population instance for both RNG machine and Crossover method
-		// Output: temp[i] is set a new genome using crossover algorithm and mutation enabled
-		auto genInd = [temp, divisor, pool, this](int i, int threadID) {
+		// Output: temp[i] genome is filled using crossover algorithm and mutation enabled, fitness reset to -1
+		auto genInd = [temp, selector, pool, this](int i, int threadID) {
 
 			BetterRandom * myRNG = &this->rng_machines[threadID];
 
-			this->same_check[i] = true;
-			// select first parent with fitness proportionate selection and store associated genome into temp_image1
-			double selected = (*myRNG)() / divisor;
-			double temp_sum = pool[0].fitness(); // Recall 0 index has worst fitness
-			int j = 0;
-			while (temp_sum < selected) {
-				j++;
-				temp_sum += pool[j].fitness();
-			}
-			const T * parent1 = pool[j].genome();
-
-			// Select second parent with fitness proportionate selection and store associated genome into temp_image2
-			selected = (*myRNG)() / divisor;
-			temp_sum = pool[0].fitness();
-			j = 0;
-			while (temp_sum < selected) {
-				j++;
-				temp_sum += pool[j].fitness();
-			}
-			const T * parent2 = pool[j].genome();
+			// select both parents
+			const T * parent1 = pool[selector->select(myRNG)].genome();
+			const T * parent2 = pool[selector->select(myRNG)].genome();
 
 			// perform crossover with mutation
-			temp[i].set_genome(this->Crossover(parent1, parent2, same_check[i], true, myRNG));
+			this->Crossover(parent1, parent2, temp[i], true, myRNG);
 		}; // ... genInd(i)
 
 		// Lambda function for multithreading to perform generation of next pool with fewer given threads
@@ -83,9 +449,9 @@ public:
 		//		  elite_size - passed in to reduce false sharing, the number of elites to carry over
 		// Captures: temp - array of individuals to store results into
 		//			pool - array of current individuals to get parents from
-		//			divisor - value used in conjunction with parent_selector to select individual (used in genInd) and captured by reference
+		//			order - ranking of pool, elites are copied in rank order so the best ends at the last index
 		//			this - pointer to current population instance for instance of DeepCopyIndividual
-		auto genSubGroup = [temp, pool, divisor, genInd, this](const int threadID, const int numThreads, const int pop_size_, const int elite_size_) {
+		auto genSubGroup = [temp, pool, order, genInd, this](const int threadID, const int numThreads, const int pop_size_, const int elite_size_) {
 			int groupSize = pop_size_ / numThreads;
 			int remainder = pop_size_ - groupSize*numThreads;
 			int start_index = threadID*groupSize;
@@ -105,12 +471,33 @@ public:
 					genInd(id, threadID);
 				}
 				else { // Carry Elites
-					this->DeepCopyIndividual(temp[id], pool[id]);
+					this->DeepCopyIndividual(temp[id], pool[order[id]]);
 				}
 			}
 		}; // .. genSubGroup
 
-		if (this->multiThread_) { // Parallel
+		if (this->speculated_) { // Speculated, only correct the children bred early
+			this->finishSpeculation(temp, pool);
+			// Carry Elites
+			for (int id = this->pop_size_ - this->elite_size_; id < this->pop_size_; id++) {
+				this->DeepCopyIndividual(temp[id], pool[order[id]]);
+			}
+		}
+		else if (this->prepareScreening()) { // Prescreened with the surrogate model
+			this->breedScreened(temp, pool, selector);
+			// Carry Elites
+			for (int id = this->pop_size_ - this->elite_size_; id < this->pop_size_; id++) {
+				this->DeepCopyIndividual(temp[id], pool[order[id]]);
+			}
+		}
+		else if (this->tiled_breeding_) { // Tiled
+			this->breedTiled(temp, pool, selector);
+			// Carry Elites
+			for (int id = this->pop_size_ - this->elite_size_; id < this->pop_size_; id++) {
+				this->DeepCopyIndividual(temp[id], pool[order[id]]);
+			}
+		}
+		else if (this->multiThread_) { // Parallel
 			for (int i = 0; i < this->threadCount_; i++) {
 				this->myThreadPool_->pushJob(std::bind(genSubGroup, i, this->threadCount_, this->pop_size_, this->elite_size_));
 			}
@@ -124,22 +511,13 @@ public:
 					genInd(id, 0);
 				}
 				else { // Carry Elites
-					this->DeepCopyIndividual(temp[id], pool[id]);
+					this->DeepCopyIndividual(temp[id], pool[order[id]]);
 				}
 			}
 		}
 
-		// Collect the resulting same_check values,
-		// if at least one is false (not similar) then the result is set to false
-		bool same_check_result = true;
-		for (int i = 0; i < (this->pop_size_ - this->elite_size_) && same_check_result; i++) {
-			if (this->same_check[i] == false) {
-				same_check_result = false;
-			}
-		}
-
-		// if all of our individuals are labeled similar, replace half of them with new images
-		if (same_check_result) {
+		// if all of our individuals are similar to the best, replace half of them with new images
+		if (this->isConverged(temp)) {
 			// Lambda function to capture thread behavior
 			// Input: threadID - current thread
 			//		  numThreads - total number of threads being launched
@@ -161,7 +539,7 @@ public:
 					}
 				}
 				for (int id = start_index; id < start_index + groupSize && id < pop_size / 2; id++) {
-					temp[id].set_genome(Utility::generateRandomImage<T>(genome_length, &this->rng_machines[threadID]));
+					this->RandomizeIndividual(temp[id], &this->rng_machines[threadID]);
 				}
 			}; // .. randSubGroup
 
@@ -174,14 +552,14 @@ public:
 			}
 			else {
 				for (int i = 0; i < this->pop_size_ / 2; i++) {
-					temp[i].set_genome(Utility::generateRandomImage<T>(this->genome_length_, this->rng_machines));
+					this->RandomizeIndividual(temp[i], this->rng_machines);
 				}
 			}
 		}
 
-		// Assign new population to individuals_
-		delete[] this->individuals_;
-		this->individuals_ = temp;
+		// Assign new population to individuals_ (old generation's genomes are reused next time)
+		this->swapGenerations();
+		this->updateMutationRate();
 		return true; // No issues!
 	}	// ... Function nextGeneration
 
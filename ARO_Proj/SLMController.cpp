@@ -10,6 +10,7 @@
 #include "ImageScaler.h"
 #include "SLMController.h"		// Header file
 #include "Utility.h"
+#include "Timing.h"				// Time stamping writes
 
 #include <string>
 #include <fstream>	// used to export information to file 
@@ -24,7 +25,7 @@ SLMController::SLMController() {
 	const char* static_regional_lut_file = NULL; // NULL -> no overdrive, actual LUT file -> yes overdrive
 
 	// Create the sdk that lets control the board(s)
-	blink_sdk = new Blink_SDK(bits_per_pixel, &numBoards, &isBlinkSuccess, is_LC_Nematic, RAM_write_enable, use_GPU_if_available, max_transiet_frames, NULL);
+	blink_sdk = new SLMDriver(bits_per_pixel, &numBoards, &isBlinkSuccess, is_LC_Nematic, RAM_write_enable, use_GPU_if_available, max_transiet_frames, NULL);
 	// Perform initial board info retrival and settings setup
 	repopulateBoardList();
 
@@ -113,7 +114,7 @@ bool SLMController::AssignLUTFile(int boardIdx, std::string path) {
 SLMController::~SLMController() {
 	//Poweroff and deallokate sdk functionality
 	blink_sdk->SLM_power(false);
-	blink_sdk->~Blink_SDK();
+	blink_sdk->~SLMDriver();
 
 	//De-allocate all memory allocated to store board information
 	for (int i = 0; i < boards.size(); i++)
@@ -233,12 +234,24 @@ void SLMController::setBoardPower(int boardID, bool isOn) {
 // Input:
 //		slmNum - index for board to assing image to (1 based index)
 //		image - pointer to array of image data to assign to board
+//		waitForTrigger - if true the image is only loaded once the board's trigger input is raised
+//		externalPulse - if true the board raises its output pulse once the image is loaded
+//		triggerTimeoutMs - longest wait for the trigger in milliseconds when waitForTrigger (0 for no limit)
 // Output: Write image to board at slmNum, using that board's height for the image size
-bool SLMController::writeImageToBoard(int slmNum, unsigned char * image) {
+bool SLMController::writeImageToBoard(int slmNum, unsigned char * image, bool waitForTrigger, bool externalPulse, unsigned int triggerTimeoutMs) {
 	if (slmNum < 1 || slmNum > this->boards.size()) {
 		return false;
 	}
 	else {
-		return this->blink_sdk->Write_image(slmNum, image, this->getBoardHeight(slmNum), false, false, 0);
+		const bool written = this->blink_sdk->Write_image(slmNum, image, this->getBoardHeight(slmNum), waitForTrigger, externalPulse, triggerTimeoutMs);
+		this->lastWriteTime = TimeStampGenerator::HostMicroS();
+		return written;
+	}
+}
+
+// Stop a sequence of triggered writes
+void SLMController::stopSequence() {
+	if (this->blink_sdk != NULL) {
+		this->blink_sdk->Stop_sequence();
 	}
 }
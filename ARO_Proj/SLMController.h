@@ -7,10 +7,20 @@
 #define SLM_CONTROLLER_H_
 
 #include "SLM_Board.h"
-#include "Blink_SDK.h"
 
 #include <vector>
 
+// Define to build with simulated boards in place of the Blink SDK (to run SLM sequencing without hardware, see MockSLM.h)
+//#define USE_MOCK_SLM
+
+#ifdef USE_MOCK_SLM
+	#include "MockSLM.h"
+	typedef MockSLM SLMDriver;
+#else
+	#include "Blink_SDK.h"
+	typedef Blink_SDK SLMDriver;
+#endif
+
 class MainDialog;
 
 // Class to encapsulate interactions with SLM boards
@@ -20,10 +30,11 @@ private:
 	MainDialog* dlg;
 public:
 	//Board control
-	Blink_SDK* blink_sdk;			//Library that controls the SLMs
+	SLMDriver* blink_sdk;			//Library that controls the SLMs (Blink SDK, or simulated boards with USE_MOCK_SLM)
 	bool isBlinkSuccess = true;		//TRUE -> if SLM control wrapper was constructed correctly
 	//Board parameters
 	unsigned int numBoards = 0;		//Number of boards populated after creation of the SDK
+	double lastWriteTime = 0;		//Host time (microseconds, TimeStampGenerator::HostMicroS()) the last image write to a board finished
 
 	//Board references
 	std::vector<SLM_Board*> boards;
@@ -74,10 +85,18 @@ public:
 
 	// Write an image to a board
 	// Input:
-	//		slmNum - index for which board (0 based index)
+	//		slmNum - index for which board (1 based index)
 	//		image - pointer to array of image to assign to board
+	//		waitForTrigger - if true the image is only loaded once the board's trigger input is raised (default false)
+	//		externalPulse - if true the board raises its output pulse once the image is loaded, such as to trigger a camera exposure (default false)
+	//		triggerTimeoutMs - longest wait for the trigger in milliseconds when waitForTrigger (default 0, no limit)
 	// Output: Write image to board at slmNum, using that board's height for the image size
-	bool writeImageToBoard(int slmNum, unsigned char * image);
+	//		returns false if the board is invalid, the write failed or no trigger arrived in time
+	//		lastWriteTime is set to when the write finished (for the camera to only use frames exposed after the image settled)
+	bool writeImageToBoard(int slmNum, unsigned char * image, bool waitForTrigger = false, bool externalPulse = false, unsigned int triggerTimeoutMs = 0);
+
+	// Stop a sequence of triggered writes, releasing any write waiting on a trigger (it returns false)
+	void stopSequence();
 };
 
 #endif
@@ -0,0 +1,204 @@
+////////////////////
+// Selection.h - parent selection schemes for the genetic algorithms
+//		ParentSelector is built once per generation from the fitness of a pool of individuals,
+//		after which drawing a parent is O(1) (proportionate & rank, using a Vose alias table) or O(k) (tournament of size k)
+//		Drawing is const and only uses the RNG passed in, so it is safe to call from many pool threads at once
+////////////////////
+
+#ifndef SELECTION_H_
+#define SELECTION_H_
+
+#include <vector>		// storage of fitness & alias tables
+#include <algorithm>	// sort() for rank selection
+#include <cmath>		// isfinite() & pow()
+
+#include "Individual.h"
+#include "BetterRandom.h"
+#include "Utility.h"		// printLine()
+
+// The types of parent selection available
+enum SelectionType {
+	SELECTION_PROPORTIONATE,	// Chance of selection proportional to fitness (negative fitness counts as 0)
+	SELECTION_RANK,				// Chance of selection proportional to rank (worst has weight 1, best has weight size)
+	SELECTION_TOURNAMENT		// Best of tournamentSize individuals picked uniformly at random
+};
+
+class ParentSelector {
+private:
+	SelectionType type_;
+	int tournament_size_;
+	int size_;
+
+	// Copy of the fitness values from the last build (used by tournament)
+	std::vector<double> fitness_;
+	// Vose alias table, index i is kept with probability prob_[i] otherwise alias_[i] is used
+	std::vector<double> prob_;
+	std::vector<int> alias_;
+
+	// Build the alias table from non-negative weights, if weights are unusable (sum not positive or not finite) then uniform is used
+	//	(expected while every fitness is still 0, so this is not reported)
+	// Input: weights - the weight for each index (overwritten)
+	// Output: prob_ and alias_ are set for size_ indices
+	void buildAlias(std::vector<double> & weights) {
+		double sum = 0;
+		for (int i = 0; i < this->size_; i++) {
+			sum += weights[i];
+		}
+		if (!(sum > 0) || !std::isfinite(sum)) {
+			for (int i = 0; i < this->size_; i++) {
+				weights[i] = 1;
+			}
+			sum = this->size_;
+		}
+
+		// Scale so the average weight is 1 then split into small (< 1) and large (>= 1) work lists
+		std::vector<int> small, large;
+		small.reserve(this->size_);
+		large.reserve(this->size_);
+		for (int i = 0; i < this->size_; i++) {
+			weights[i] *= this->size_ / sum;
+			if (weights[i] < 1) {
+				small.push_back(i);
+			}
+			else {
+				large.push_back(i);
+			}
+		}
+		// Pair each small entry with a large entry that fills the rest of its column
+		while (!small.empty() && !large.empty()) {
+			const int s = small.back(); small.pop_back();
+			const int l = large.back();
+			this->prob_[s] = weights[s];
+			this->alias_[s] = l;
+			weights[l] -= (1 - weights[s]);
+			if (weights[l] < 1) {
+				large.pop_back();
+				small.push_back(l);
+			}
+		}
+		// Anything left over (including from rounding error) is kept with certainty
+		for (size_t i = 0; i < large.size(); i++) {
+			this->prob_[large[i]] = 1;
+			this->alias_[large[i]] = large[i];
+		}
+		for (size_t i = 0; i < small.size(); i++) {
+			this->prob_[small[i]] = 1;
+			this->alias_[small[i]] = small[i];
+		}
+	}
+
+	// Uniformly pick an index in [0, size_)
+	inline int uniformIndex(BetterRandom * rng) const {
+		return int((uint64_t(rng->nextWord()) * uint64_t(this->size_)) >> 32);
+	}
+
+public:
+	// Constructor
+	// Input:
+	//	type - selection scheme to use (default fitness proportionate)
+	//	tournamentSize - number of individuals competing for each draw when using tournament selection (default 2)
+	ParentSelector(SelectionType type = SELECTION_PROPORTIONATE, int tournamentSize = 2) {
+		this->type_ = type;
+		this->tournament_size_ = (tournamentSize > 1) ? tournamentSize : 1;
+		this->size_ = 0;
+	}
+
+	void setType(SelectionType type) {
+		this->type_ = type;
+	}
+
+	SelectionType getType() const {
+		return this->type_;
+	}
+
+	void setTournamentSize(int tournamentSize) {
+		this->tournament_size_ = (tournamentSize > 1) ? tournamentSize : 1;
+	}
+
+	// Prepare the selector for a generation, to be called (from one thread) before any draws
+	// Input: pool - individuals parents will be drawn from, size - number of individuals in pool
+	// Output: returns false if pool is empty, otherwise the selector is ready for select()
+	template <typename T>
+	bool build(const Individual<T> * pool, int size) {
+		if (size <= 0) {
+			Utility::printLine("ERROR: Cannot build parent selection from an empty pool!");
+			return false;
+		}
+		this->size_ = size;
+		this->fitness_.resize(size);
+		for (int i = 0; i < size; i++) {
+			this->fitness_[i] = pool[i].fitness();
+		}
+		if (this->type_ == SELECTION_TOURNAMENT) {
+			return true;
+		}
+
+		std::vector<double> weights(size);
+		if (this->type_ == SELECTION_RANK) {
+			// Weight of an individual is its rank (1 for worst, size for best)
+			std::vector<int> order(size);
+			for (int i = 0; i < size; i++) {
+				order[i] = i;
+			}
+			const std::vector<double> & fit = this->fitness_;
+			std::sort(order.begin(), order.end(), [&fit](int a, int b) { return fit[a] < fit[b]; });
+			for (int r = 0; r < size; r++) {
+				weights[order[r]] = r + 1;
+			}
+		}
+		else {
+			for (int i = 0; i < size; i++) {
+				// Negative and invalid (NaN/inf) fitness can not be selected
+				weights[i] = (std::isfinite(this->fitness_[i]) && this->fitness_[i] > 0) ? this->fitness_[i] : 0;
+			}
+		}
+		this->prob_.resize(size);
+		this->alias_.resize(size);
+		this->buildAlias(weights);
+		return true;
+	}
+
+	// Get the chance of each index being drawn by select()
+	// Input: out - array of at least the size given to build()
+	// Output: out[i] is the probability select() returns i
+	void probabilities(double * out) const {
+		const double n = this->size_;
+		if (this->type_ == SELECTION_TOURNAMENT) {
+			// The winner is the fittest of the draws, so an individual wins when all draws are no fitter and one (of those as fit) is it
+			std::vector<double> sorted(this->fitness_);
+			std::sort(sorted.begin(), sorted.end());
+			for (int i = 0; i < this->size_; i++) {
+				const double lessFit = double(std::lower_bound(sorted.begin(), sorted.end(), this->fitness_[i]) - sorted.begin());
+				const double noFitter = double(std::upper_bound(sorted.begin(), sorted.end(), this->fitness_[i]) - sorted.begin());
+				out[i] = (noFitter > lessFit) ? (pow(noFitter / n, this->tournament_size_) - pow(lessFit / n, this->tournament_size_)) / (noFitter - lessFit) : 0;
+			}
+			return;
+		}
+		for (int i = 0; i < this->size_; i++) {
+			out[i] = this->prob_[i] / n;
+		}
+		for (int i = 0; i < this->size_; i++) {
+			out[this->alias_[i]] += (1 - this->prob_[i]) / n;
+		}
+	}
+
+	// Draw a parent
+	// Input: rng - the calling thread's random number generator
+	// Output: returns index into the pool given to build()
+	int select(BetterRandom * rng) const {
+		if (this->type_ == SELECTION_TOURNAMENT) {
+			int best = this->uniformIndex(rng);
+			for (int i = 1; i < this->tournament_size_; i++) {
+				const int challenger = this->uniformIndex(rng);
+				if (this->fitness_[challenger] > this->fitness_[best]) {
+					best = challenger;
+				}
+			}
+			return best;
+		}
+		const int column = this->uniformIndex(rng);
+		return (rng->uniform() < this->prob_[column]) ? column : this->alias_[column];
+	}
+};
+
+#endif
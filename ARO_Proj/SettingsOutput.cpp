@@ -73,6 +73,9 @@ bool MainDialog::setUIfromFile(std::string filePath) {
 	// Open file
 	std::ifstream inputFile(filePath);
 	std::string lineBuffer;
+	// Optional masks are only saved when set, so clear them first to not keep a mask from before the load
+	this->m_ga_ControlDlg.m_warmStartMask.SetWindowTextW(_T(""));
+	this->m_ia_ControlDlg.m_warmStartMask.SetWindowTextW(_T(""));
 	try {// Read each line
 		while (std::getline(inputFile, lineBuffer)) {
 			// If not empty and not a commented out line
@@ -135,6 +138,23 @@ bool MainDialog::setValueByName(std::string name, std::string value) {
 		this->m_cameraControlDlg.m_FramesPerSecond.SetWindowTextW(valueStr);
 	else if (name == "gamma")
 		this->m_cameraControlDlg.m_gammaValue.SetWindowTextW(valueStr);
+	else if (name == "settleTime")
+		this->m_cameraControlDlg.m_settleTime.SetWindowTextW(valueStr);
+	else if (name == "calibrateSettling") {
+		this->m_cameraControlDlg.m_calibrateSettling.SetCheck(valueStr == "true");
+	}
+	else if (name == "readoutBinning")
+		this->m_cameraControlDlg.m_readoutBinning.SetWindowTextW(valueStr);
+	else if (name == "autoReadout") {
+		this->m_cameraControlDlg.m_autoReadout.SetCheck(valueStr == "true");
+	}
+	else if (name == "viewReadouts")
+		this->m_cameraControlDlg.m_viewReadouts.SetWindowTextW(valueStr);
+	else if (name == "streamBufferCount")
+		this->m_cameraControlDlg.m_streamBufferCount.SetWindowTextW(valueStr);
+	else if (name == "streamBufferHandling") {
+		this->m_cameraControlDlg.m_streamBufferHandling.SetCurSel(std::stoi(value));
+	}
 	// AOI Dialog
 	else if (name == "leftAOI")
 		this->m_aoiControlDlg.m_leftInput.SetWindowTextW(valueStr);
@@ -165,6 +185,55 @@ bool MainDialog::setValueByName(std::string name, std::string value) {
 		this->m_ga_ControlDlg.m_indEvalThreadCount.SetWindowTextW(valueStr);
 	else if (name == "popGenThreadCount")
 		this->m_ga_ControlDlg.m_PopGenThreadCount.SetWindowTextW(valueStr);
+	else if (name == "runSeed")
+		this->m_ga_ControlDlg.m_runSeed.SetWindowTextW(valueStr);
+	else if (name == "islandCount")
+		this->m_ga_ControlDlg.m_islandCount.SetWindowTextW(valueStr);
+	else if (name == "migrationInterval")
+		this->m_ga_ControlDlg.m_migrationInterval.SetWindowTextW(valueStr);
+	else if (name == "islandMutationSpread")
+		this->m_ga_ControlDlg.m_islandMutationSpread.SetWindowTextW(valueStr);
+	else if (name == "steadyState") {
+		this->m_ga_ControlDlg.m_steadyState.SetCheck(valueStr == "true");
+	}
+	else if (name == "speculativeBreeding") {
+		this->m_ga_ControlDlg.m_speculativeBreeding.SetCheck(valueStr == "true");
+	}
+	else if (name == "screeningCandidates")
+		this->m_ga_ControlDlg.m_screeningCandidates.SetWindowTextW(valueStr);
+	else if (name == "useFitnessMemo") {
+		this->m_ga_ControlDlg.m_useFitnessMemo.SetCheck(valueStr == "true");
+	}
+	else if (name == "adaptiveMutation") {
+		this->m_ga_ControlDlg.m_adaptiveMutation.SetCheck(valueStr == "true");
+	}
+	else if (name == "mutationStep")
+		this->m_ga_ControlDlg.m_mutationStep.SetWindowTextW(valueStr);
+	else if (name == "checkpointInterval")
+		this->m_ga_ControlDlg.m_checkpointInterval.SetWindowTextW(valueStr);
+	else if (name == "resumeFromCheckpoint") {
+		this->m_ga_ControlDlg.m_resumeFromCheckpoint.SetCheck(valueStr == "true");
+	}
+	else if (name == "warmStartMask")
+		this->m_ga_ControlDlg.m_warmStartMask.SetWindowTextW(valueStr);
+	else if (name == "sequenceEvaluation") {
+		this->m_ga_ControlDlg.m_sequenceEvaluation.SetCheck(valueStr == "true");
+	}
+	else if (name == "selectionType") {
+		this->m_ga_ControlDlg.m_selectionType.SetCurSel(std::stoi(value));
+	}
+	else if (name == "tournamentSize")
+		this->m_ga_ControlDlg.m_tournamentSize.SetWindowTextW(valueStr);
+	else if (name == "tiledBreeding") {
+		this->m_ga_ControlDlg.m_tiledBreeding.SetCheck(valueStr == "true");
+	}
+	else if (name == "sequenceWaitForTrigger") {
+		this->m_ga_ControlDlg.m_sequenceWaitForTrigger.SetCheck(valueStr == "true");
+	}
+	else if (name == "sequenceHoldTime")
+		this->m_ga_ControlDlg.m_sequenceHoldTime.SetWindowTextW(valueStr);
+	else if (name == "sequenceTriggerTimeout")
+		this->m_ga_ControlDlg.m_sequenceTriggerTimeout.SetWindowTextW(valueStr);
 	else if (name == "skipEliteReeval") {
 		this->m_ga_ControlDlg.m_skipEliteReevaluation.SetCheck(valueStr == "true");
 	}
@@ -177,6 +246,13 @@ bool MainDialog::setValueByName(std::string name, std::string value) {
 		this->m_ia_ControlDlg.m_phaseResolution.SetWindowTextW(valueStr);
 	else if (name == "ia_targetRadius")
 		this->m_ia_ControlDlg.m_targetRadius.SetWindowTextW(valueStr);
+	else if (name == "ia_checkpointInterval")
+		this->m_ia_ControlDlg.m_checkpointInterval.SetWindowTextW(valueStr);
+	else if (name == "ia_resumeFromCheckpoint") {
+		this->m_ia_ControlDlg.m_resumeFromCheckpoint.SetCheck(valueStr == "true");
+	}
+	else if (name == "ia_warmStartMask")
+		this->m_ia_ControlDlg.m_warmStartMask.SetWindowTextW(valueStr);
 
 	// SLM Dialog
 	else if (name == "slmSelect")  {
@@ -404,6 +480,9 @@ bool MainDialog::saveUItoFile(std::string filePath) {
 #endif
 #ifdef USE_PICAM
 	outFile << "PICAM";
+#endif
+#ifdef USE_MOCK_CAMERA
+	outFile << "SIMULATED CAMERA";
 #endif
 	outFile << " version" << std::endl;
 
@@ -424,6 +503,21 @@ bool MainDialog::saveUItoFile(std::string filePath) {
 	outFile << "framesPerSecond=" << _tstof(tempBuff) << std::endl;;
 	this->m_cameraControlDlg.m_gammaValue.GetWindowTextW(tempBuff);
 	outFile << "gamma=" << _tstof(tempBuff) << std::endl;
+	this->m_cameraControlDlg.m_settleTime.GetWindowTextW(tempBuff);
+	outFile << "settleTime=" << _tstof(tempBuff) << std::endl;
+	outFile << "calibrateSettling=";
+	if (this->m_cameraControlDlg.m_calibrateSettling.GetCheck() == BST_CHECKED) { outFile << "true" << std::endl; }
+	else { outFile << "false" << std::endl; }
+	this->m_cameraControlDlg.m_readoutBinning.GetWindowTextW(tempBuff);
+	outFile << "readoutBinning=" << _tstoi(tempBuff) << std::endl;
+	outFile << "autoReadout=";
+	if (this->m_cameraControlDlg.m_autoReadout.GetCheck() == BST_CHECKED) { outFile << "true" << std::endl; }
+	else { outFile << "false" << std::endl; }
+	this->m_cameraControlDlg.m_viewReadouts.GetWindowTextW(tempBuff);
+	outFile << "viewReadouts=" << _tstoi(tempBuff) << std::endl;
+	this->m_cameraControlDlg.m_streamBufferCount.GetWindowTextW(tempBuff);
+	outFile << "streamBufferCount=" << _tstoi(tempBuff) << std::endl;
+	outFile << "streamBufferHandling=" << this->m_cameraControlDlg.m_streamBufferHandling.GetCurSel() << std::endl;
 	// AOI Dialog settings
 	outFile << "# AOI Settings" << std::endl;
 	this->m_aoiControlDlg.m_leftInput.GetWindowTextW(tempBuff);
@@ -460,6 +554,55 @@ bool MainDialog::saveUItoFile(std::string filePath) {
 	outFile << "evalIndividualsThreadCount=" << _tstof(tempBuff) << std::endl;
 	this->m_ga_ControlDlg.m_PopGenThreadCount.GetWindowTextW(tempBuff);
 	outFile << "popGenThreadCount=" << _tstof(tempBuff) << std::endl;
+	this->m_ga_ControlDlg.m_runSeed.GetWindowTextW(tempBuff);
+	outFile << "runSeed=" << _tcstoui64(tempBuff, NULL, 10) << std::endl;
+	this->m_ga_ControlDlg.m_islandCount.GetWindowTextW(tempBuff);
+	outFile << "islandCount=" << _tstoi(tempBuff) << std::endl;
+	this->m_ga_ControlDlg.m_migrationInterval.GetWindowTextW(tempBuff);
+	outFile << "migrationInterval=" << _tstoi(tempBuff) << std::endl;
+	this->m_ga_ControlDlg.m_islandMutationSpread.GetWindowTextW(tempBuff);
+	outFile << "islandMutationSpread=" << _tstof(tempBuff) << std::endl;
+	outFile << "steadyState=";
+	if (this->m_ga_ControlDlg.m_steadyState.GetCheck() == BST_CHECKED) { outFile << "true" << std::endl; }
+	else { outFile << "false" << std::endl; }
+	outFile << "speculativeBreeding=";
+	if (this->m_ga_ControlDlg.m_speculativeBreeding.GetCheck() == BST_CHECKED) { outFile << "true" << std::endl; }
+	else { outFile << "false" << std::endl; }
+	this->m_ga_ControlDlg.m_screeningCandidates.GetWindowTextW(tempBuff);
+	outFile << "screeningCandidates=" << _tstoi(tempBuff) << std::endl;
+	outFile << "useFitnessMemo=";
+	if (this->m_ga_ControlDlg.m_useFitnessMemo.GetCheck() == BST_CHECKED) { outFile << "true" << std::endl; }
+	else { outFile << "false" << std::endl; }
+	outFile << "adaptiveMutation=";
+	if (this->m_ga_ControlDlg.m_adaptiveMutation.GetCheck() == BST_CHECKED) { outFile << "true" << std::endl; }
+	else { outFile << "false" << std::endl; }
+	this->m_ga_ControlDlg.m_mutationStep.GetWindowTextW(tempBuff);
+	outFile << "mutationStep=" << _tstof(tempBuff) << std::endl;
+	this->m_ga_ControlDlg.m_checkpointInterval.GetWindowTextW(tempBuff);
+	outFile << "checkpointInterval=" << _tstoi(tempBuff) << std::endl;
+	outFile << "resumeFromCheckpoint=";
+	if (this->m_ga_ControlDlg.m_resumeFromCheckpoint.GetCheck() == BST_CHECKED) { outFile << "true" << std::endl; }
+	else { outFile << "false" << std::endl; }
+	this->m_ga_ControlDlg.m_warmStartMask.GetWindowTextW(tempBuff);
+	if (!tempBuff.IsEmpty()) { // Empty values are not read back
+		outFile << "warmStartMask=" << std::string(CT2A(tempBuff)) << std::endl;
+	}
+	outFile << "sequenceEvaluation=";
+	if (this->m_ga_ControlDlg.m_sequenceEvaluation.GetCheck() == BST_CHECKED) { outFile << "true" << std::endl; }
+	else { outFile << "false" << std::endl; }
+	outFile << "selectionType=" << this->m_ga_ControlDlg.m_selectionType.GetCurSel() << std::endl;
+	this->m_ga_ControlDlg.m_tournamentSize.GetWindowTextW(tempBuff);
+	outFile << "tournamentSize=" << _tstoi(tempBuff) << std::endl;
+	outFile << "tiledBreeding=";
+	if (this->m_ga_ControlDlg.m_tiledBreeding.GetCheck() == BST_CHECKED) { outFile << "true" << std::endl; }
+	else { outFile << "false" << std::endl; }
+	outFile << "sequenceWaitForTrigger=";
+	if (this->m_ga_ControlDlg.m_sequenceWaitForTrigger.GetCheck() == BST_CHECKED) { outFile << "true" << std::endl; }
+	else { outFile << "false" << std::endl; }
+	this->m_ga_ControlDlg.m_sequenceHoldTime.GetWindowTextW(tempBuff);
+	outFile << "sequenceHoldTime=" << _tstoi(tempBuff) << std::endl;
+	this->m_ga_ControlDlg.m_sequenceTriggerTimeout.GetWindowTextW(tempBuff);
+	outFile << "sequenceTriggerTimeout=" << _tstoi(tempBuff) << std::endl;
 
 	outFile << "# Iterative Algorithm Optimization Settings" << std::endl;
 	this->m_ia_ControlDlg.m_binSize.GetWindowTextW(tempBuff);
@@ -470,6 +613,15 @@ bool MainDialog::saveUItoFile(std::string filePath) {
 	outFile << "ia_targetRadius=" << _tstof(tempBuff) << std::endl;
 	this->m_ia_ControlDlg.m_phaseResolution.GetWindowTextW(tempBuff);
 	outFile << "ia_phaseResolution=" << _tstof(tempBuff) << std::endl;
+	this->m_ia_ControlDlg.m_checkpointInterval.GetWindowTextW(tempBuff);
+	outFile << "ia_checkpointInterval=" << _tstoi(tempBuff) << std::endl;
+	outFile << "ia_resumeFromCheckpoint=";
+	if (this->m_ia_ControlDlg.m_resumeFromCheckpoint.GetCheck() == BST_CHECKED) { outFile << "true" << std::endl; }
+	else { outFile << "false" << std::endl; }
+	this->m_ia_ControlDlg.m_warmStartMask.GetWindowTextW(tempBuff);
+	if (!tempBuff.IsEmpty()) { // Empty values are not read back
+		outFile << "ia_warmStartMask=" << std::string(CT2A(tempBuff)) << std::endl;
+	}
 
 	// SLM Dialog settings
 	outFile << "# SLM Configuration Settings" << std::endl;
@@ -0,0 +1,201 @@
+////////////////////
+// SettlingCalibration.cpp - implementation of the SLM settling & latency calibration
+////////////////////
+
+#include "stdafx.h"					// Required in source
+#include "SettlingCalibration.h"	// Header file
+
+#include <cmath>		// log() & exp() of the settling curve
+#include <fstream>		// log of recorded intensities
+
+#include "CameraController.h"
+#include "SLMController.h"
+#include "Timing.h"
+#include "Utility.h"
+
+// Constructor
+SettlingCalibration::SettlingCalibration(CameraController * cc, SLMController * sc, int boardID) {
+	this->cc = cc;
+	this->sc = sc;
+	this->boardID_ = boardID;
+	this->width_ = sc->getBoardWidth(boardID - 1);
+	this->height_ = sc->getBoardHeight(boardID - 1);
+	this->settleTime_ = 0;
+	this->latency_ = 0;
+	this->framePeriod_ = 0;
+}
+
+// Measure every step, the settle time is the longest of the steps (so no pattern change is used half settled)
+bool SettlingCalibration::run(std::string logPath) {
+	// Step patterns, the checkerboard's step shows the fringing between neighbouring pixels as well as the liquid crystal's response
+	const int area = this->width_ * this->height_;
+	std::vector<unsigned char> uniformLow(area, 0), uniformHigh(area, 128), checker(area), inverse(area);
+	for (int y = 0; y < this->height_; y++) {
+		for (int x = 0; x < this->width_; x++) {
+			checker[y*this->width_ + x] = (((x / this->checkerSize) + (y / this->checkerSize)) % 2 == 0) ? 0 : 128;
+			inverse[y*this->width_ + x] = 128 - checker[y*this->width_ + x];
+		}
+	}
+	const int stepCount = 3;
+	const std::string stepNames[stepCount] = { "Uniform 0 to 128", "Uniform 128 to 0", "Checkerboard to inverse" };
+	unsigned char * stepFrom[stepCount] = { uniformLow.data(), uniformHigh.data(), checker.data() };
+	unsigned char * stepTo[stepCount] = { uniformHigh.data(), uniformLow.data(), inverse.data() };
+
+	std::ofstream logFile;
+	if (!logPath.empty()) {
+		logFile.open(logPath);
+		logFile << "Step,Repeat,Time Since Write (microseconds),Intensity" << std::endl;
+	}
+	std::vector<double> times, intensities;
+	double latencySum = 0, periodSum = 0;
+	int latencyCount = 0, periodCount = 0;
+	bool fitted = false;
+	this->settleTime_ = 0;
+
+	for (int step = 0; step < stepCount; step++) {
+		// Samples of every repeat, normalized to the step (1 -> level before the step, 0 -> settled level)
+		std::vector<double> stepTimes, stepLevels;
+		for (int repeat = 0; repeat < this->repeats; repeat++) {
+			double latency;
+			// Settle on the first pattern, the end of its recording is the level before the step
+			if (!this->recordAfterWrite(stepFrom[step], times, intensities, latency)) {
+				return false;
+			}
+			const double levelBefore = this->settledLevel(times, intensities);
+			if (!this->recordAfterWrite(stepTo[step], times, intensities, latency)) {
+				return false;
+			}
+			const double levelAfter = this->settledLevel(times, intensities);
+			if (latency >= 0) {
+				latencySum += latency;
+				latencyCount++;
+			}
+			for (int i = 0; i < int(times.size()); i++) {
+				if (logFile.is_open()) {
+					logFile << stepNames[step] << "," << repeat << "," << times[i] << "," << intensities[i] << std::endl;
+				}
+				if (i > 0) {
+					periodSum += times[i] - times[i - 1];
+					periodCount++;
+				}
+			}
+			if (fabs(levelBefore - levelAfter) < this->minStep) {
+				continue;
+			}
+			for (int i = 0; i < int(times.size()); i++) {
+				stepTimes.push_back(times[i]);
+				stepLevels.push_back((intensities[i] - levelAfter) / (levelBefore - levelAfter));
+			}
+		}
+		const double stepSettle = this->fitSettleTime(stepTimes, stepLevels);
+		if (stepSettle < 0) {
+			Utility::printLine("WARNING: Settling calibration could not fit the " + stepNames[step] + " step (too small a change of intensity at the target)");
+			continue;
+		}
+		Utility::printLine("INFO: " + stepNames[step] + " step settles after " + std::to_string(stepSettle) + " microseconds");
+		if (stepSettle > this->settleTime_) {
+			this->settleTime_ = stepSettle;
+		}
+		fitted = true;
+	}
+	this->latency_ = (latencyCount > 0) ? latencySum / latencyCount : 0;
+	this->framePeriod_ = (periodCount > 0) ? periodSum / periodCount : 0;
+	return fitted;
+}
+
+// Write a pattern then record every frame exposed in the following recordTime
+bool SettlingCalibration::recordAfterWrite(unsigned char * pattern, std::vector<double> & times, std::vector<double> & intensities, double & latency) {
+	times.clear();
+	intensities.clear();
+	latency = -1;
+	this->sc->writeImageToBoard(this->boardID_, pattern);
+	const double writeTime = this->sc->lastWriteTime;
+	double frameTime = 0;
+	while (frameTime <= this->recordTime) {
+		// Every frame from the write on in order (rather than the most recent), the camera's settle time is taken off as it is what is being calibrated
+		ImageController * image = this->cc->AcquireImageAfter(writeTime - this->cc->settleTime);
+		if (image == NULL) {
+			Utility::printLine("ERROR: Image Acquisition has failed!");
+			return false;
+		}
+		frameTime = this->cc->GetLastFrameTime() - writeTime;
+		// Frames exposed before the write are from the last pattern
+		if (frameTime >= 0) {
+			if (latency < 0) {
+				latency = TimeStampGenerator::HostMicroS() - writeTime;
+			}
+			times.push_back(frameTime);
+			intensities.push_back(Utility::FindAverageValue(image->getRawData(), image->getWidth(), image->getHeight(), this->cc->GetFitnessRadius()));
+		}
+		delete image;
+	}
+	return true;
+}
+
+// Get the mean intensity of the last quarter of a recording
+double SettlingCalibration::settledLevel(const std::vector<double> & times, const std::vector<double> & intensities) {
+	double sum = 0;
+	int count = 0;
+	for (int i = 0; i < int(times.size()); i++) {
+		if (times[i] >= this->recordTime * 0.75) {
+			sum += intensities[i];
+			count++;
+		}
+	}
+	if (count == 0) {
+		return intensities.empty() ? 0 : intensities.back();
+	}
+	return sum / count;
+}
+
+// Fit log(y) = a + b*t by least squares over the samples part way through the step (the ends are mostly noise once logged)
+double SettlingCalibration::fitSettleTime(const std::vector<double> & times, const std::vector<double> & normalized) {
+	double sumT = 0, sumY = 0, sumTT = 0, sumTY = 0;
+	int count = 0;
+	for (int i = 0; i < int(times.size()); i++) {
+		if (normalized[i] >= 0.1 && normalized[i] <= 0.9) {
+			const double logY = log(normalized[i]);
+			sumT += times[i];
+			sumY += logY;
+			sumTT += times[i] * times[i];
+			sumTY += times[i] * logY;
+			count++;
+		}
+	}
+	const double denominator = count * sumTT - sumT * sumT;
+	if (count < 2 || denominator <= 0) {
+		// Settled within the first frame (or never moved), take the first frame that is settled
+		for (int i = 0; i < int(times.size()); i++) {
+			if (fabs(normalized[i]) <= 1 - this->settledFraction) {
+				return times[i];
+			}
+		}
+		return -1;
+	}
+	const double b = (count * sumTY - sumT * sumY) / denominator;
+	const double a = (sumY - b * sumT) / count;
+	if (b >= 0) {
+		return -1;
+	}
+	const double settle = (log(1 - this->settledFraction) - a) / b;
+	return (settle > 0) ? settle : 0;
+}
+
+// Get the results of run()
+double SettlingCalibration::getSettleTime() {
+	return this->settleTime_;
+}
+
+double SettlingCalibration::getLatency() {
+	return this->latency_;
+}
+
+double SettlingCalibration::getFramePeriod() {
+	return this->framePeriod_;
+}
+
+// Get the most evaluations per second the settle time & frame period allow
+double SettlingCalibration::getMaxEvaluationRate() {
+	const double evaluationTime = this->settleTime_ + 1.5 * this->framePeriod_;
+	return (evaluationTime > 0) ? 1000000.0 / evaluationTime : 0;
+}
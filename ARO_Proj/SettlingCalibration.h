@@ -0,0 +1,70 @@
+////////////////////
+// SettlingCalibration.h - measures how long an SLM takes to settle after a write and the latency from a write to a camera frame
+//		Step patterns (uniform 0 -> 128, uniform 128 -> 0 and a checkerboard -> its inverse) are written to a board while frames are read
+//		at full rate, each frame's intensity is recorded against the time its exposure started after the write. The intensity after each
+//		step is fitted with an exponential settling curve, giving the least time after a write an exposure can start at and have the SLM
+//		settled, and from that & the frame period the most evaluations per second the hardware allows
+////////////////////
+
+#ifndef SETTLING_CALIBRATION_H_
+#define SETTLING_CALIBRATION_H_
+
+#include <string>
+#include <vector>
+
+class CameraController;
+class SLMController;
+
+class SettlingCalibration {
+private:
+	CameraController* cc;	// Camera to record with (acquisition already started)
+	SLMController* sc;		// SLMs to write the patterns with
+	int boardID_;			// Board to write the patterns to (1 based)
+	int width_;				// Size of the board's images
+	int height_;
+
+	// Results
+	double settleTime_;		// Least time (microseconds) after a write for an exposure to start with the SLM settled
+	double latency_;		// Mean time (microseconds) from a write to the first frame exposed after it being acquired
+	double framePeriod_;	// Mean time (microseconds) between frames
+
+	// Write a pattern then record every frame exposed in the following recordTime
+	// Input: pattern - image to write to the board
+	// Output: returns false if acquisition failed
+	//		times - time (microseconds) each frame's exposure started after the write, intensities - each frame's intensity within the target radius
+	//		latency - time (microseconds) from the write to the first frame exposed after it being acquired (-1 if none was)
+	bool recordAfterWrite(unsigned char * pattern, std::vector<double> & times, std::vector<double> & intensities, double & latency);
+
+	// Get the mean intensity of the last quarter of a recording (the level the SLM settled at)
+	double settledLevel(const std::vector<double> & times, const std::vector<double> & intensities);
+
+	// Fit y = exp(a + b*t) to the normalized intensities of a step (1 -> before the step, 0 -> settled)
+	// Output: returns the time the remaining step falls to 1 - settledFraction, -1 if the step could not be fitted
+	double fitSettleTime(const std::vector<double> & times, const std::vector<double> & normalized);
+
+public:
+	// Calibration parameters
+	int repeats = 5;				// Number of times each step is measured
+	double recordTime = 100000;		// Time (microseconds) frames are recorded after each write
+	double settledFraction = 0.95;	// Fraction of a step the intensity has to have made for the SLM to count as settled
+	int checkerSize = 8;			// Size (pixels) of the checkerboard's squares
+	double minStep = 0.5;			// Smallest change of intensity between two patterns that can be fitted
+
+	// Constructor
+	// Input: cc - camera to record with, sc - SLMs to write with, boardID - board to write the patterns to (1 based)
+	SettlingCalibration(CameraController * cc, SLMController * sc, int boardID);
+
+	// Measure every step, writing every frame recorded to a log
+	// Input: logPath - file to write the recorded intensities to (empty -> no log)
+	// Output: returns false if acquisition failed or no step made a large enough change of intensity to be fitted
+	bool run(std::string logPath);
+
+	// Get the results of run()
+	double getSettleTime();
+	double getLatency();
+	double getFramePeriod();
+	// Get the most evaluations per second, each waiting the settle time then on average half a frame for the next exposure to start & a frame for it
+	double getMaxEvaluationRate();
+};
+
+#endif
@@ -0,0 +1,237 @@
+////////////////////
+// SurrogateModel.h - online surrogate of the hardware fitness, used to prescreen children before they are evaluated on the SLM & camera
+//		Fitness is modelled as linear in the cos & sin of every gene's phase (for every board), fitted by ridge regression on a window of the latest evaluations
+//		The fit is done in dual form (window x window system with the kernel sum of cos(phase difference)), so it costs little even for long genomes,
+//		then turned back into per-gene weights so scoring a child is a single pass over its genome
+//		As the model is linear, children for one board can be ranked with only that board's weights (other boards' terms are shared)
+////////////////////
+
+#ifndef SURROGATE_MODEL_H_
+#define SURROGATE_MODEL_H_
+
+#include <vector>		// samples & weights
+#include <mutex>		// samples come from many evaluating threads
+#include <condition_variable>	// waiting on a fit made by another thread
+#include <algorithm>	// fill()
+#include <cmath>		// cos() & sin() for the phase tables, sqrt() for the solve
+#include <cstring>		// memcpy() of sample genomes
+#include <cstdint>		// uint8_t genomes
+
+class SurrogateModel {
+private:
+	int board_count_;		// Number of boards (genomes) in each sample
+	int genome_length_;		// Genes in each board's genome
+	int window_;			// Most samples kept, older samples are replaced as the population moves on
+	double ridge_;			// Ridge penalty, relative to the number of genes
+
+	std::vector<uint8_t> sample_genomes_;	// window_ samples of board_count_ genomes each
+	std::vector<double> sample_fitness_;
+	int sample_count_;		// Samples in the window
+	int next_sample_;		// Window slot for the next sample
+	int total_samples_;		// Samples given over the whole run
+	bool fitted_;			// If weights_ are fitted to the current window
+	bool fitting_;			// Set while a thread is fitting (outside mutex_)
+
+	std::vector<double> weights_;	// cos & sin weight of each gene of each board (board_count_ x genome_length_ x 2)
+	double bias_;					// Mean fitness of the window
+	double abs_error_;				// Running mean absolute error of predictions made before each sample is added
+
+	double cos_[256], sin_[256];	// Tables of the cos & sin of each 8-bit phase
+
+	std::mutex mutex_;
+	std::condition_variable fitDone_;	// Signalled when a fit finishes
+
+	// Predict the fitness of a sample from the current weights
+	double predict(const uint8_t * const * genomes) const {
+		double prediction = this->bias_;
+		for (int b = 0; b < this->board_count_; b++) {
+			prediction += this->scoreBoard(&this->weights_[size_t(b) * this->genome_length_ * 2], genomes[b]);
+		}
+		return prediction;
+	}
+
+	// Fit weights to a copy of the window's samples, only reads members that do not change so it is called without mutex_ held
+	//	Solves (K + ridge) alpha = y - mean(y) with K[i][j] = sum over genes of cos(phase_i - phase_j), then weights = sum of alpha_j * features_j
+	// Input: sampleGenomes, sampleFitness - the samples, n - number of samples
+	// Output: weights - fitted weights (board_count_ x genome_length_ x 2), bias - mean fitness of the samples
+	void fit(const std::vector<uint8_t> & sampleGenomes, const std::vector<double> & sampleFitness, int n, std::vector<double> & weights, double & bias) const {
+		const size_t sampleSize = size_t(this->board_count_) * this->genome_length_;
+		bias = 0;
+		for (int i = 0; i < n; i++) {
+			bias += sampleFitness[i];
+		}
+		bias /= n;
+
+		// Kernel matrix (symmetric, lower half found then mirrored)
+		std::vector<double> K(size_t(n) * n);
+		for (int i = 0; i < n; i++) {
+			const uint8_t * a = &sampleGenomes[size_t(i) * sampleSize];
+			for (int j = 0; j <= i; j++) {
+				const uint8_t * c = &sampleGenomes[size_t(j) * sampleSize];
+				double k = 0;
+				for (size_t g = 0; g < sampleSize; g++) {
+					k += this->cos_[uint8_t(a[g] - c[g])];
+				}
+				K[size_t(i) * n + j] = k;
+				K[size_t(j) * n + i] = k;
+			}
+			K[size_t(i) * n + i] += this->ridge_ * double(sampleSize);
+		}
+		// Cholesky factorization K = L L' (in place, lower half)
+		for (int j = 0; j < n; j++) {
+			double d = K[size_t(j) * n + j];
+			for (int k = 0; k < j; k++) {
+				d -= K[size_t(j) * n + k] * K[size_t(j) * n + k];
+			}
+			d = (d > 1e-12) ? sqrt(d) : 1e-6;
+			K[size_t(j) * n + j] = d;
+			for (int i = j + 1; i < n; i++) {
+				double s = K[size_t(i) * n + j];
+				for (int k = 0; k < j; k++) {
+					s -= K[size_t(i) * n + k] * K[size_t(j) * n + k];
+				}
+				K[size_t(i) * n + j] = s / d;
+			}
+		}
+		// Solve L z = y then L' alpha = z
+		std::vector<double> alpha(n);
+		for (int i = 0; i < n; i++) {
+			double s = sampleFitness[i] - bias;
+			for (int k = 0; k < i; k++) {
+				s -= K[size_t(i) * n + k] * alpha[k];
+			}
+			alpha[i] = s / K[size_t(i) * n + i];
+		}
+		for (int i = n - 1; i >= 0; i--) {
+			double s = alpha[i];
+			for (int k = i + 1; k < n; k++) {
+				s -= K[size_t(k) * n + i] * alpha[k];
+			}
+			alpha[i] = s / K[size_t(i) * n + i];
+		}
+		// Back to per-gene weights
+		std::fill(weights.begin(), weights.end(), 0.0);
+		for (int j = 0; j < n; j++) {
+			const uint8_t * c = &sampleGenomes[size_t(j) * sampleSize];
+			for (size_t g = 0; g < sampleSize; g++) {
+				weights[2 * g] += alpha[j] * this->cos_[c[g]];
+				weights[2 * g + 1] += alpha[j] * this->sin_[c[g]];
+			}
+		}
+	}
+
+public:
+	// Constructor
+	// Input:
+	//	boardCount - number of boards (genomes) evaluated together
+	//	genomeLength - genes in each genome
+	//	window - number of latest evaluations the model is fitted to (default 120)
+	//	ridge - ridge penalty relative to the number of genes, larger keeps predictions closer to the mean (default 0.1)
+	SurrogateModel(int boardCount, int genomeLength, int window = 120, double ridge = 0.1) {
+		this->board_count_ = boardCount;
+		this->genome_length_ = genomeLength;
+		this->window_ = (window > 2) ? window : 2;
+		this->ridge_ = ridge;
+		this->sample_genomes_.resize(size_t(this->window_) * boardCount * genomeLength);
+		this->sample_fitness_.resize(this->window_);
+		this->sample_count_ = 0;
+		this->next_sample_ = 0;
+		this->total_samples_ = 0;
+		this->fitted_ = false;
+		this->fitting_ = false;
+		this->weights_.assign(size_t(boardCount) * genomeLength * 2, 0);
+		this->bias_ = 0;
+		this->abs_error_ = 0;
+
+		const double PI = 3.14159265358979323846;
+		for (int v = 0; v < 256; v++) {
+			this->cos_[v] = cos(2 * PI * v / 256.0);
+			this->sin_[v] = sin(2 * PI * v / 256.0);
+		}
+	}
+
+	// Get the number of weights for one board (size of the array given to copyBoardWeights())
+	int getBoardWeightCount() const {
+		return 2 * this->genome_length_;
+	}
+
+	// Get the running mean absolute error of the model's predictions (made before each sample is added)
+	double getError() {
+		std::unique_lock<std::mutex> lock(this->mutex_);
+		return this->abs_error_;
+	}
+
+	// Add an evaluation result, to be called after every hardware evaluation (thread safe)
+	// Input: genomes - genome of each board that was evaluated, fitness - resulting fitness
+	void update(const uint8_t * const * genomes, double fitness) {
+		std::unique_lock<std::mutex> lock(this->mutex_);
+		// Error of the prediction before this sample (from the last fit)
+		if (this->total_samples_ > 0) {
+			const double error = fitness - this->predict(genomes);
+			const int span = (this->total_samples_ < this->window_) ? this->total_samples_ + 1 : this->window_;
+			this->abs_error_ += ((error < 0 ? -error : error) - this->abs_error_) / span;
+		}
+		uint8_t * slot = &this->sample_genomes_[size_t(this->next_sample_) * this->board_count_ * this->genome_length_];
+		for (int b = 0; b < this->board_count_; b++) {
+			memcpy(slot + size_t(b) * this->genome_length_, genomes[b], this->genome_length_);
+		}
+		this->sample_fitness_[this->next_sample_] = fitness;
+		this->next_sample_ = (this->next_sample_ + 1) % this->window_;
+		if (this->sample_count_ < this->window_) {
+			this->sample_count_++;
+		}
+		this->total_samples_++;
+		this->fitted_ = false;
+	}
+
+	// Copy one board's weights for scoring children with scoreBoard(), fitting the model to the latest samples first if needed
+	//	The fit is made on a copy of the window without mutex_ held, so evaluating threads adding samples are not held up by it
+	//	(a thread wanting weights while another fits waits for that fit, samples added during a fit are used by the next one)
+	// Input: board - index of the board, out - array of getBoardWeightCount() to write to
+	// Output: returns false if the model can not be used yet (until the window is full)
+	bool copyBoardWeights(int board, double * out) {
+		std::unique_lock<std::mutex> lock(this->mutex_);
+		if (this->sample_count_ < this->window_) {
+			return false;
+		}
+		while (this->fitting_) {
+			this->fitDone_.wait(lock);
+		}
+		if (!this->fitted_) {
+			this->fitting_ = true;
+			const int version = this->total_samples_;
+			const int n = this->sample_count_;
+			std::vector<uint8_t> sampleGenomes(this->sample_genomes_);
+			std::vector<double> sampleFitness(this->sample_fitness_);
+			std::vector<double> weights(this->weights_.size(), 0.0);
+			double bias;
+			lock.unlock();
+
+			this->fit(sampleGenomes, sampleFitness, n, weights, bias);
+
+			lock.lock();
+			this->weights_.swap(weights);
+			this->bias_ = bias;
+			this->fitted_ = (this->total_samples_ == version);
+			this->fitting_ = false;
+			this->fitDone_.notify_all();
+		}
+		memcpy(out, &this->weights_[size_t(board) * this->genome_length_ * 2], sizeof(double) * 2 * this->genome_length_);
+		return true;
+	}
+
+	// Score a genome for one board, higher is a higher predicted fitness (const, safe to call from many threads)
+	// Input: boardWeights - weights from copyBoardWeights(), genome - the genome to score
+	// Output: returns the board's part of the predicted fitness
+	template <class T>
+	double scoreBoard(const double * boardWeights, const T * genome) const {
+		double score = 0;
+		for (int g = 0; g < this->genome_length_; g++) {
+			const int phase = int(genome[g]) & 255;
+			score += boardWeights[2 * g] * this->cos_[phase] + boardWeights[2 * g + 1] * this->sin_[phase];
+		}
+		return score;
+	}
+};
+
+#endif
@@ -42,5 +42,14 @@ public:
 		double microseconds = double((currentTime - start_time_) / (frequency_ / 1000000));
 		return microseconds;
 	}
+
+	// Return the host's high resolution time in microseconds (from an arbitrary fixed start, the same for every caller)
+	// used to line up SLM writes with camera frame time stamps
+	static double HostMicroS() {
+		__int64 currentTime, frequency;
+		QueryPerformanceCounter((LARGE_INTEGER *)&currentTime);
+		QueryPerformanceFrequency((LARGE_INTEGER *)&frequency);
+		return double(currentTime / frequency) * 1000000.0 + double(currentTime % frequency) * 1000000.0 / double(frequency);
+	}
 };
 #endif
@@ -112,6 +112,31 @@ const double Utility::FindAverageValue(const void *image, const int width, const
 	return rdbl;
 }
 
+// Calculate the average intensity of a 16 bit image, within the same area as FindAverageValue()
+const double Utility::FindAverageValue16(const unsigned short *image, const int width, const int height, const int r, const int binning) {
+	int ll, kk, cx, cy, ymin, ymax;
+	double rloop, xmin, xmax, area;
+	cv::Mat m_ary = cv::Mat(int(height), int(width), CV_16UC1, (void*)image);
+	rloop = 0;
+	cx = width / 2;
+	cy = height / 2;
+	area = 3.1416*pow(r, 2);
+	ymin = cy - r;
+	ymax = cy + r;
+
+	//calculate average
+	for (ll = ymin; ll < ymax; ll++) {
+		xmin = cx - sqrt(pow(r, 2) - pow(ll - cy, 2));
+		xmax = cx + sqrt(pow(r, 2) - pow(ll - cy, 2));
+
+		for (kk = int(xmin); kk < int(xmax); kk++){
+			rloop += m_ary.at<unsigned short>(ll, kk);
+		}
+	}
+
+	return rloop / (257.0 * binning * binning) / area;
+}
+
 //[STRING PROCCESING]
 // Separate a string into a vector array, breaks in given character
 // Input: fullString - string to seperate into parts
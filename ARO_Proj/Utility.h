@@ -33,17 +33,29 @@ namespace Utility {
 	// Output: The average intensity within the calculated area
 	const double FindAverageValue(const void *image, const int width, const int height, const int r);
 
+	// Calculate the same average intensity from a 16 bit image (such as a PICam readout) without converting it to 8 bit
+	// Input: image - pointer to the 16 bit image data
+	//		  width, height, r - as FindAverageValue()
+	//		  binning - pixels summed along each side into each image pixel when read out binned (values are divided by binning^2 to undo the sum)
+	// Output: The average intensity within the calculated area, scaled down to 8 bit (divided by 257) so fitness is comparable to FindAverageValue()
+	const double FindAverageValue16(const unsigned short *image, const int width, const int height, const int r, const int binning = 1);
+
 	// Generates a random image using BetterRandom
-	// Input: size - size of the image to make
+	// Input: image - pre-allocated array to fill with the random image (such as a slot of a population's genome arena)
+	//		  size - size of the image to make
 	//		  rng_machine - the RNG object to use for setting random pixel values
-	// Output: a randomly generated image with given size and each value being from 0 to 255
+	// Output: image is filled with each value being from 0 to 255
 	template <typename T>
-	T* generateRandomImage(int size, BetterRandom * rng_machine) {
-		int * image = new T[size];
-		for (int j = 0; j < size; j++) {
-			image[j] = (T)((256 * (*rng_machine)() / RAND_MAX) - 1);
+	void generateRandomImage(T * image, int size, BetterRandom * rng_machine) {
+		// Random words are drawn in bulk, each word gives the values of four pixels
+		uint32_t words[64];
+		for (int j = 0; j < size; j += 256) {
+			const int count = (size - j < 256) ? (size - j) : 256;
+			rng_machine->fill(words, (count + 3) / 4);
+			for (int k = 0; k < count; k++) {
+				image[j + k] = (T)((words[k >> 2] >> ((k & 3) * 8)) & 0xFF);
+			}
 		} // ... for each pixel in image
-		return image;
 	}
 
 	// [STRING PROCCESSING]
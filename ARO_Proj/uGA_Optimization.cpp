@@ -9,17 +9,16 @@
 // Method to setup specific properties runOptimziation() instance
 bool uGA_Optimization::setupInstanceVariables() {
 	// Setting population size as well as number of elite individuals kept in the genetic repopulation
-	this->populationSize = 5;
-	this->eliteSize = 1;
+	// (fixed by the uGA's pairing table)
+	this->populationSize = MicroGAPairing::POP_SIZE;
+	this->eliteSize = MicroGAPairing::POP_SIZE - MicroGAPairing::CHILD_COUNT;
 
 	// Get how many populations to have (same as number of boards being optimized)
 	this->popCount = int(this->optBoards.size());
 
-	// Setting population vector
-	this->population.clear();
-	for (int i = 0; i < this->popCount; i++) {
-		this->population.push_back(new uGAPopulation<int>(this->cc->numberOfBinsY * this->cc->numberOfBinsX * this->cc->populationDensity,
-			this->populationSize, this->eliteSize, this->acceptedSimilarity, this->multithreadEnable, this->gaPoolThreadCount, this->myThreadPool_));
+	// Setting population vector (one population per board on each island)
+	if (!this->setupPopulations()) {
+		return false;
 	}
 
 	this->shortenExposureFlag = false; // Set to true by individual if fitness is too high, initially false
@@ -56,7 +55,7 @@ bool uGA_Optimization::setupInstanceVariables() {
 	//Open up files to which progress will be logged
 	if (this->logAllFiles || this->saveTimeVSFitness) {
 		this->timePerGenFile.open(this->outputFolder + this->algorithm_name_ + "_timePerformance.txt");
-		this->timePerGenFile << "uGA Generation,Individuals Time (microseconds),NextGeneration Time (microseconds),Overall Generation Time (microseconds),";
+		this->timePerGenFile << "uGA Generation,Individuals Time (microseconds),NextGeneration Time (microseconds),Overall Generation Time (microseconds),Diversity,Mutation Rate,Mutation Step,Scale Time,Hardware Wait Time,Write Time,Acquire Time,Fitness Time (mean microseconds per evaluation),";
 		// Also for easier tracking, outputinng the thread counts as well
 		this->timePerGenFile << "Eval Individuals Threads," << this->indThreadCount << ",Next Generation Threads, " << this->gaPoolThreadCount << "\n";
 
@@ -72,6 +71,12 @@ bool uGA_Optimization::setupInstanceVariables() {
 	return true; // Returning true if no issues met
 }
 
+// Method to create one uGA population for setupPopulations()
+Population<uint8_t>* uGA_Optimization::createPopulation(uint64_t seed, bool multiThread) {
+	return new uGAPopulation<uint8_t>(this->cc->numberOfBinsY * this->cc->numberOfBinsX * this->cc->populationDensity,
+		this->populationSize, this->eliteSize, this->acceptedSimilarity, multiThread, this->gaPoolThreadCount, this->myThreadPool_, seed);
+}
+
 // Method to clean up & save resulting runOptimziation() instance
 bool uGA_Optimization::shutdownOptimizationInstance() {
 
@@ -79,13 +84,8 @@ bool uGA_Optimization::shutdownOptimizationInstance() {
 
 	// Only save images if not aborting (successful results
 	if (this->dlg->stopFlag == false && this->saveResultImages) {
-		// Get elite info
-		unsigned char* eliteImage = this->bestImage->getRawData();
-		int imgHeight = this->bestImage->getHeight();
-		int imgWidth = this->bestImage->getWidth();
-
-		// Save how final optimization looks through camera
-		this->cc->saveImage(this->bestImage, this->outputFolder + curTime + "_" + this->algorithm_name_ + "_Optimized.bmp");
+		// Save how final optimization looks through camera (no camera image if resumed from a checkpoint and the elite was not evaluated again)
+		if (this->bestImage != NULL) this->cc->saveImage(this->bestImage, this->outputFolder + curTime + "_" + this->algorithm_name_ + "_Optimized.bmp");
 
 		// Save final (most fit SLM images)
 		for (int popID = 0; popID < this->population.size(); popID++) {
@@ -138,10 +138,7 @@ bool uGA_Optimization::shutdownOptimizationInstance() {
 	if (this->bestImage != NULL) {
 		delete this->bestImage;
 	}
-	for (int i = 0; i < this->population.size(); i++) {
-		delete this->population[i];
-	}
-	this->population.clear();
+	this->deletePopulations();
 
 	if (this->timestamp != NULL) {
 		delete this->timestamp;
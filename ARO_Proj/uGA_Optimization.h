@@ -13,6 +13,9 @@ class uGA_Optimization : public GA_Optimization {
 	// Method to setup specific properties for uGA
 	bool setupInstanceVariables();
 
+	// Method to create one uGA population for setupPopulations()
+	Population<uint8_t>* createPopulation(uint64_t seed, bool multiThread);
+
 	// Method to clean up & save resulting uGA instance
 	bool shutdownOptimizationInstance();
 
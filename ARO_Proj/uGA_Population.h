@@ -8,44 +8,108 @@
 
 #include "Population.h"
 
-template <class T>
+// Pairing traits for the micro genetic algorithm, given to uGAPopulation as a template parameter
+//	POP_SIZE	- number of individuals in the population
+//	CHILD_COUNT	- number of children bred each generation, stored at indices 0 to CHILD_COUNT-1 (the rest are elites kept by rank)
+//	parentA/B	- for a child index the ranks of its two parents (POP_SIZE-1 being the best)
+// The values are compile-time constants, so breeding loops over children are unrolled with the parents known
+// (enum & inline functions rather than constexpr, the x64 configurations still build with the v120 toolset)
+struct MicroGAPairing {
+	enum { POP_SIZE = 5, CHILD_COUNT = 4 };
+
+	// Pairing of (4,3), (4,2), (3,2), (3,2)
+	static inline int parentA(int child) {
+		return (child < 2) ? 4 : 3;
+	}
+	static inline int parentB(int child) {
+		return (child == 0) ? 3 : 2;
+	}
+};
+
+template <class T, class Pairing = MicroGAPairing>
 class uGAPopulation : public Population<T> {
+	static_assert(Pairing::CHILD_COUNT > 0 && Pairing::CHILD_COUNT < Pairing::POP_SIZE, "uGA pairing must breed at least one child and keep at least one elite");
+
+	// Number of genes handed to a thread at a time when breeding, a multiple of 32 (one random word) and of a cache line of 8-bit genes
+	static const int GENE_BLOCK = 64;
+
+	// Breed every child for a range of genes in one pass, so each block of a parent is loaded once while it is blended into all children that use it
+	// Input:
+	//	ranked - genomes of the current population by rank (ranked[POP_SIZE-1] is the best)
+	//	children - genomes of the children to write
+	//	start, end - range of genes to breed
+	//	rng_machine - random numbers for the parent choice masks
+	// Output: children[c][start..end) are filled with uniform crossover of their paired parents
+	void breedRange(const T * const * ranked, T * const * children, int start, int end, BetterRandom * rng_machine) const {
+		const int batchSize = CrossoverKernel::WORD_BATCH * 32;
+		uint32_t words[Pairing::CHILD_COUNT][CrossoverKernel::WORD_BATCH];
+		for (int i = start; i < end; i += batchSize) {
+			const int batchGenes = (end - i < batchSize) ? (end - i) : batchSize;
+			const int wordCount = (batchGenes + 31) / 32;
+			for (int c = 0; c < Pairing::CHILD_COUNT; c++) {
+				rng_machine->fill(words[c], wordCount);
+			}
+			for (int w = 0; w < wordCount; w++) {
+				const int g = i + w * 32;
+				const int count = (i + batchGenes - g < 32) ? (i + batchGenes - g) : 32;
+				for (int c = 0; c < Pairing::CHILD_COUNT; c++) {
+					CrossoverKernel::blendWord(ranked[Pairing::parentA(c)] + g, ranked[Pairing::parentB(c)] + g, children[c] + g, count, words[c][w]);
+				}
+			}
+		}
+	}
+
 public:
 	// Constructor
 	// Input:
 	//	genome_length:		 the image size (genome) for an individual
-	//	population_size:	 the number of individuals for the population
-	//	elite_size:			 the number of individuals for the population that are kept as elite
+	//	population_size:	 the number of individuals for the population (must match Pairing::POP_SIZE)
+	//	elite_size:			 the number of individuals for the population that are kept as elite (must match Pairing::POP_SIZE - Pairing::CHILD_COUNT)
 	//	accepted_similarity: precentage of similarity to be counted as same between individuals (default 90%)
 	//  multiThread:		 enable usage of multithreading (default true)
 	//  myThreadPool:		 set the thread pool to be used when multithreading enabled
-	uGAPopulation(int genome_length, int population_size, int elite_size, double accepted_similarity = .9, bool multiThread = true, int _threadCount = std::thread::hardware_concurrency(), threadPool * myThreadPool = NULL)
-		: Population<T>(genome_length, population_size, elite_size, accepted_similarity, multiThread, _threadCount, myThreadPool) {};
+	//  seed:				 seed for the population's random streams, 0 picks a random seed (default 0)
+	uGAPopulation(int genome_length, int population_size = Pairing::POP_SIZE, int elite_size = Pairing::POP_SIZE - Pairing::CHILD_COUNT, double accepted_similarity = .9, bool multiThread = true, int _threadCount = std::thread::hardware_concurrency(), threadPool * myThreadPool = NULL, uint64_t seed = 0)
+		: Population<T>(genome_length, Pairing::POP_SIZE, Pairing::POP_SIZE - Pairing::CHILD_COUNT, accepted_similarity, multiThread, _threadCount, myThreadPool, seed) {
+		if (population_size != Pairing::POP_SIZE || elite_size != Pairing::POP_SIZE - Pairing::CHILD_COUNT) {
+			Utility::printLine("WARNING: uGA population is fixed at " + std::to_string(int(Pairing::POP_SIZE)) + " individuals with " + std::to_string(int(Pairing::POP_SIZE - Pairing::CHILD_COUNT)) + " elite, ignoring given sizes!");
+		}
+	};
 
 	// Starts next generation using fitness of individuals.
 	bool nextGeneration() {
-		// temp for storing sorted current population
-		this->SortIndividuals(this->individuals_, this->pop_size_);
+		// Move onto this generation's random streams
+		this->advanceGeneration();
+
+		// Rank the current population (order_ holds the best at the last index)
+		this->rankIndividuals(Pairing::POP_SIZE);
 		Individual<T>* pool = this->individuals_;
-		// temp for storing new population before storing into this->individuals_
-		Individual<T>* temp = new Individual<T>[this->pop_size_];
-
-		// Lambda function to do crossover and assignment in a more readibly approachable way
-		// Input: indID - index of location to store individual in temp array
-		//		parent1 - index of a parent in sorted_temp
-		//		parent2 - index of the other parent in sorted_temp
-		//	    threadID - the thread running to help access appropriate RNG machine
+		// temp for storing new population before swapping into this->individuals_ (next generation half of the genome arena)
+		Individual<T>* temp = this->next_individuals_;
+
+		const T * ranked[Pairing::POP_SIZE];
+		for (int r = 0; r < Pairing::POP_SIZE; r++) {
+			ranked[r] = pool[this->order_[r]].genome();
+		}
+		T * children[Pairing::CHILD_COUNT];
+		for (int c = 0; c < Pairing::CHILD_COUNT; c++) {
+			children[c] = temp[c].genome();
+		}
+		const T * const * rankedPtr = ranked;
+		T * const * childrenPtr = children;
+
+		// Lambda function to breed all children over one thread's share of the genome
+		// Input: threadID - current thread index, also selects the RNG machine
+		//		  numThreads - total number of threads being launched
 		// Captures:
-		//		temp - pointer array to store new individuals
-		//		pool - pointer to array of sorted individuals to draw parents from
-		//		this - pointer to current instance of uGA_Population for accessing Crossover method with mutation disabled
-		auto genInd = [temp, pool, this](int indID, int parent1, int parent2, int threadID) {
-			temp[indID].set_genome(this->Crossover(pool[parent1].genome(), pool[parent2].genome(), this->same_check[indID], false, &this->rng_machines[threadID]));
-		};
-
-		auto genSubGroup = [temp, pool, this, &genInd](const int threadID) {
-			int groupSize = this->pop_size_ / this->threadCount_;
-			int remainder = this->pop_size_ - groupSize*this->threadCount_;
+		//		rankedPtr - genomes of current population by rank
+		//		childrenPtr - genomes of the children being bred
+		//		this - pointer to current instance of uGA_Population for breedRange()
+		auto breedSubGroup = [rankedPtr, childrenPtr, this](const int threadID, const int numThreads) {
+			// Split the genome in blocks of GENE_BLOCK genes so threads never write in the same cache line
+			const int blockCount = (this->genome_length_ + GENE_BLOCK - 1) / GENE_BLOCK;
+			int groupSize = blockCount / numThreads;
+			int remainder = blockCount - groupSize*numThreads;
 			int start_index = threadID*groupSize;
 
 			if (remainder != 0) {
@@ -57,57 +121,43 @@ public:
 					start_index += remainder;
 				}
 			}
-			for (int id = start_index; id < start_index + groupSize && id < this->pop_size_; id++) {
-				switch (id) {
-				case(0) :
-					genInd(0, 4, 3, threadID);
-					break;
-				case(1) :
-					genInd(1, 4, 2, threadID);
-					break;
-				case(2) :
-					genInd(2, 3, 2, threadID);
-					break;
-				case(3) :
-					genInd(3, 3, 2, threadID);
-					break;
-				case(4) :
-					// Keeping current best onto next generation
-					this->DeepCopyIndividual(temp[4], pool[4]);
-					break;
-				}
+			const int start = start_index * GENE_BLOCK;
+			int end = (start_index + groupSize) * GENE_BLOCK;
+			if (end > this->genome_length_) {
+				end = this->genome_length_;
 			}
+			if (start < end) {
+				this->breedRange(rankedPtr, childrenPtr, start, end, &this->rng_machines[threadID]);
+			}
+		}; // .. breedSubGroup
 
-		}; // .. genSubGroup
-
-
-		// Crossover generation for new population
+		// Crossover generation for new population, all children in one fused pass
 		if (this->multiThread_) {
 			for (int i = 0; i < this->threadCount_; i++) {
-				this->myThreadPool_->pushJob(std::bind(genSubGroup, i));
+				this->myThreadPool_->pushJob(std::bind(breedSubGroup, i, this->threadCount_));
 			}
 			this->myThreadPool_->wait();
 		}
 		else {
-			genInd(0, 4, 3, 0);
-			genInd(1, 4, 2, 0);
-			genInd(2, 3, 2, 0);
-			genInd(3, 3, 2, 0);
-			// Keeping current best onto next generation
-			DeepCopyIndividual(temp[4], this->individuals_[4]);
+			this->breedRange(rankedPtr, childrenPtr, 0, this->genome_length_, this->rng_machines);
 		}
-
-		// Collect the resulting same_check values,
-		// if at least one is false (not similar) then the result is set to false
-		bool same_check_result = true;
-		for (int i = 0; i < (this->pop_size_ - this->elite_size_) && same_check_result; i++) {
-			if (this->same_check[i] == false) {
-				same_check_result = false;
+		for (int c = 0; c < Pairing::CHILD_COUNT; c++) {
+			// Mutation is only used when adaptive (each child has its own stream, so results do not depend on thread count)
+			if (this->adaptive_mutation_) {
+				BetterRandom mutateRNG(BetterRandom::deriveSeed(this->seed_, uint64_t(this->generation_)), (uint64_t(3) << 48) | uint64_t(c));
+				this->inheritMutation(ranked[Pairing::parentA(c)], ranked[Pairing::parentB(c)], temp[c], &mutateRNG);
+				this->mutateGenes(children[c], this->genome_length_, this->slotOf(temp[c]), &mutateRNG);
 			}
+			temp[c].set_fitness(-1);
+			this->updateSketch(temp[c]);
+		}
+		// Keeping current best onto next generation (by rank, so the best stays at the last index)
+		for (int id = Pairing::CHILD_COUNT; id < Pairing::POP_SIZE; id++) {
+			this->DeepCopyIndividual(temp[id], pool[this->order_[id]]);
 		}
 
-		// if all of our individuals are labeled similar, replace half of them with new images
-		if (same_check_result) {
+		// if all of our individuals are similar to the best, replace all but the best with new images
+		if (this->isConverged(temp)) {
 			// Lambda function for randomizing groups
 			// Input: threadID - ID of current thread
 			//		  numThreads - total number of threads being launched
@@ -129,7 +179,7 @@ public:
 					}
 				}
 				for (int id = start_index; id < start_index + groupSize && id < (this->pop_size_ - 1); id++) {
-					temp[id].set_genome(Utility::generateRandomImage<T>(this->genome_length_, &this->rng_machines[threadID]));
+					this->RandomizeIndividual(temp[id], &this->rng_machines[threadID]);
 				}
 			};
 
@@ -141,14 +191,16 @@ public:
 				}
 				this->myThreadPool_->wait();
 			}
-			for (int id = 0; id < this->pop_size_ - 1; id++) {
-				temp[id].set_genome(Utility::generateRandomImage<T>(this->genome_length_, this->rng_machines));
+			else {
+				for (int id = 0; id < this->pop_size_ - 1; id++) {
+					this->RandomizeIndividual(temp[id], this->rng_machines);
+				}
 			}
 		}
 
-		// Assign new population to individuals_
-		delete[] this->individuals_;
-		this->individuals_ = temp;
+		// Assign new population to individuals_ (old generation's genomes are reused next time)
+		this->swapGenerations();
+		this->updateMutationRate();
 		return true; // No issues!
 	}	// ... Function nextGeneration
 